@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+grammar_bench.py
+- Backend half of the per-query grammar benchmark. Reads the manifest written by
+  `-run=ACEGrammarBench` and runs every grammar through xgrammar, the structured-output engine
+  behind NIM's guided_grammar, in process: no model, GPU or NIM container needed.
+- Per grammar: compile time (compiler cache cleared each time, as for a grammar the server has not
+  seen), then the sample outputs are replayed token by token, timing the token mask computed before
+  each token. That mask is what constrained decoding pays per generated token.
+- Reports p50/p99 per k and mode (EBNF flat, EBNF trie-factored, JSON Schema), next to the
+  engine-side build times from the manifest, and writes them to grammar_bench_results.json beside
+  the manifest. The faster of trie and json for the served model is what ace.Planner.Constraint
+  should select.
+
+Usage:
+  python ACE/bench/grammar_bench.py <Saved/ACE/Bench/GrammarBench-.../manifest.json>
+      [--tokenizer meta-llama/Llama-3.2-3B-Instruct] [--passes 3]
+Requires: pip install xgrammar transformers torch
+"""
+
+import sys, os, json, time, argparse
+from collections import defaultdict
+
+try:
+    import xgrammar as xgr
+    from transformers import AutoTokenizer
+except Exception:
+    sys.stderr.write("FATAL: needs xgrammar and transformers. Install with `pip install xgrammar transformers torch`.\n")
+    raise
+
+DEFAULT_TOKENIZER = os.environ.get("NIM_TOKENIZER", "meta-llama/Llama-3.2-3B-Instruct")
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    s = sorted(values)
+    return s[min(len(s) - 1, max(0, round(p * (len(s) - 1))))]
+
+def summarize(values):
+    return {
+        "samples": len(values),
+        "p50": percentile(values, 0.50),
+        "p99": percentile(values, 0.99),
+        "mean": sum(values) / len(values) if values else 0.0,
+    }
+
+def measure_case(compiler, tokenizer, vocab_size, text, fmt, samples, passes):
+    """Returns (compile seconds per pass, mask seconds per token, samples rejected)."""
+    compile_fn = compiler.compile_json_schema if fmt == "json_schema" else compiler.compile_grammar
+    compile_s = []
+    compiled = None
+    for _ in range(passes):
+        compiler.clear_cache()
+        t0 = time.perf_counter()
+        compiled = compile_fn(text)
+        compile_s.append(time.perf_counter() - t0)
+
+    mask_s = []
+    rejected = 0
+    bitmask = xgr.allocate_token_bitmask(1, vocab_size)
+    for sample in samples:
+        matcher = xgr.GrammarMatcher(compiled)
+        ok = True
+        for token in tokenizer.encode(sample, add_special_tokens=False):
+            t0 = time.perf_counter()
+            matcher.fill_next_token_bitmask(bitmask)
+            mask_s.append(time.perf_counter() - t0)
+            if not matcher.accept_token(token):
+                ok = False
+                break
+        if ok:
+            # The mask that lets the model stop.
+            t0 = time.perf_counter()
+            matcher.fill_next_token_bitmask(bitmask)
+            mask_s.append(time.perf_counter() - t0)
+        else:
+            rejected += 1
+    return compile_s, mask_s, rejected
+
+def parse_args(argv=None):
+    p = argparse.ArgumentParser(description="Compile-time and per-token mask cost of per-query grammars and JSON Schemas.")
+    p.add_argument("manifest", help="manifest.json written by -run=ACEGrammarBench")
+    p.add_argument("--tokenizer", default=DEFAULT_TOKENIZER, help="Hugging Face tokenizer id or path (the served model's)")
+    p.add_argument("--passes", type=int, default=3, help="Compiles per grammar")
+    p.add_argument("--threads", type=int, default=8, help="xgrammar compiler threads")
+    return p.parse_args(argv)
+
+def main(argv=None) -> int:
+    args = parse_args(argv)
+    with open(args.manifest, "r", encoding="utf-8") as f:
+        manifest = json.load(f)
+    root = os.path.dirname(os.path.abspath(args.manifest))
+
+    tokenizer = AutoTokenizer.from_pretrained(args.tokenizer)
+    info = xgr.TokenizerInfo.from_huggingface(tokenizer)
+    compiler = xgr.GrammarCompiler(info, max_threads=args.threads)
+
+    compile_ms = defaultdict(list)
+    mask_us = defaultdict(list)
+    rejected = defaultdict(int)
+    for case in manifest["cases"]:
+        key = (case["k"], case["mode"])
+        with open(os.path.join(root, case["file"]), "r", encoding="utf-8") as f:
+            text = f.read()
+        c, m, r = measure_case(compiler, tokenizer, info.vocab_size, text, case.get("format", "ebnf"),
+                               case.get("samples", []), max(1, args.passes))
+        compile_ms[key] += [s * 1e3 for s in c]
+        mask_us[key] += [s * 1e6 for s in m]
+        rejected[key] += r
+        if r:
+            sys.stderr.write(f"[grammar_bench] {case['file']}: {r} sample(s) rejected\n")
+
+    engine = {(s["k"], s["mode"]): s for s in manifest.get("summary", [])}
+    results = []
+    print(f"{'k':>4} {'mode':<5} {'build p50 us':>13} {'compile p50 ms':>15} {'compile p99 ms':>15} {'mask p50 us':>12} {'mask p99 us':>12} {'rules':>6}")
+    for key in sorted(compile_ms):
+        k, mode = key
+        e = engine.get(key, {})
+        row = {
+            "k": k,
+            "mode": mode,
+            "engine_build_us": {"p50": e.get("build_p50_us"), "p99": e.get("build_p99_us")},
+            "mean_bytes": e.get("mean_bytes"),
+            "mean_rules": e.get("mean_rules"),
+            "compile_ms": summarize(compile_ms[key]),
+            "mask_us_per_token": summarize(mask_us[key]),
+            "samples_rejected": rejected[key],
+        }
+        results.append(row)
+        print(f"{k:>4} {mode:<5} {e.get('build_p50_us', 0.0):>13.1f} {row['compile_ms']['p50']:>15.2f} {row['compile_ms']['p99']:>15.2f} "
+              f"{row['mask_us_per_token']['p50']:>12.1f} {row['mask_us_per_token']['p99']:>12.1f} {e.get('mean_rules', 0.0):>6.1f}")
+
+    out_path = os.path.join(root, "grammar_bench_results.json")
+    with open(out_path, "w", encoding="utf-8") as f:
+        json.dump({
+            "manifest": os.path.basename(args.manifest),
+            "tokenizer": args.tokenizer,
+            "xgrammar": getattr(xgr, "__version__", "unknown"),
+            "passes": args.passes,
+            "results": results,
+        }, f, indent=2)
+    print(f"Wrote {out_path}")
+    return 1 if any(rejected.values()) else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
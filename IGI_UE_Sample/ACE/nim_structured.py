@@ -10,12 +10,20 @@ Protocol for --serve-stdin:
 - Read one line per request from STDIN (newline-delimited JSON).
 - Expected minimal payload: {"user": "<prompt text>"}
 - Optional overrides: "system", "assistant"
+- Grammar per request: "grammar" (text), "grammar_path", or "grammar_id". With "grammar_id" plus
+  "grammar" the text is cached under that id; later requests may send the id alone. An id that is
+  not cached (never sent, or evicted) gets {"error":"unknown_grammar_id","grammar_id":...}, and
+  the caller resends the text.
+- JSON Schema per request: "json_schema" (object) or "json_schema_path". Either one makes the request
+  use guided_json, as a grammar makes it use guided_grammar, whatever --mode the process has.
 - Control: {"__cmd":"ping"} -> {"ok":true,"pong":true}
+- Control: {"__cmd":"stats"} -> grammar/schema file and grammar id cache hits and lookups
 - Quit: {"__cmd":"quit"} or EOF
 - Respond with a single-line JSON string (no trailing logs), newline-delimited, then flush.
 """
 
 import sys, os, json, argparse, traceback
+from collections import OrderedDict
 from typing import Optional, Dict, Any, Tuple
 
 # NOTE: We rely on the OpenAI Python SDK that supports xgrammar via extra_body.
@@ -29,6 +37,17 @@ DEFAULT_BASE_URL = os.environ.get("NIM_BASE_URL", "http://127.0.0.1:8000/v1")
 DEFAULT_MODEL    = os.environ.get("NIM_MODEL_NAME", "meta/llama-3.2-3b-instruct")
 DEFAULT_API_KEY  = os.environ.get("NIM_API_KEY", "not-used")
 
+# Per-path grammar/schema caches. The engine names per-query grammar files after their candidate
+# set, so paths repeat; keep about as many as it keeps on disk (ace.GrammarCache.Size).
+PATH_CACHE_SIZE = int(os.environ.get("NIM_PATH_CACHE_SIZE", "256"))
+
+# Grammars sent inline under an id. Kept larger than the engine's own cache so an id it still
+# remembers sending is rarely missing here.
+ID_CACHE_SIZE = int(os.environ.get("NIM_ID_CACHE_SIZE", "512"))
+
+class UnknownGrammarId(Exception):
+    pass
+
 def configure_stdio():
     """
     Make stdout newline-framed + reliably flushed.
@@ -97,8 +116,13 @@ class StructuredClient:
         self.system_text = read_text(system_path)
         self.assistant_text = read_text(assistant_path)
 
-        self._grammar_cache: Dict[str, Tuple[float, str]] = {}
-        self._schema_cache: Dict[str, Tuple[float, Dict[str, Any]]] = {}
+        self._grammar_cache: "OrderedDict[str, Tuple[float, str]]" = OrderedDict()
+        self._schema_cache: "OrderedDict[str, Tuple[float, Dict[str, Any]]]" = OrderedDict()
+        self.path_cache_hits = 0
+        self.path_cache_lookups = 0
+        self._grammar_by_id: "OrderedDict[str, str]" = OrderedDict()
+        self.id_cache_hits = 0
+        self.id_cache_lookups = 0
 
         if mode == "grammar":
             self.grammar = read_text(grammar_path)
@@ -126,31 +150,46 @@ class StructuredClient:
         msgs.append({"role": "user", "content": user})
         return msgs
 
-    def _get_grammar_from_path(self, path: str) -> str:
-        """Load grammar from disk with a tiny mtime cache."""
-        st = os.stat(path)
-        mtime = float(st.st_mtime)
-        cached = self._grammar_cache.get(path)
+    def _cached_by_path(self, cache: "OrderedDict[str, Tuple[float, Any]]", path: str, load):
+        """Load a file through a small LRU cache keyed on path and mtime."""
+        mtime = float(os.stat(path).st_mtime)
+        self.path_cache_lookups += 1
+        cached = cache.get(path)
         if cached and cached[0] == mtime:
+            cache.move_to_end(path)
+            self.path_cache_hits += 1
             return cached[1]
-        text = read_text(path)
-        if not text:
-            raise ValueError(f"grammar file empty or unreadable: {path}")
-        self._grammar_cache[path] = (mtime, text)
-        return text
+        value = load(path)
+        if not value:
+            raise ValueError(f"file empty or unreadable: {path}")
+        cache[path] = (mtime, value)
+        cache.move_to_end(path)
+        while len(cache) > PATH_CACHE_SIZE:
+            cache.popitem(last=False)
+        return value
+
+    def _get_grammar_from_path(self, path: str) -> str:
+        return self._cached_by_path(self._grammar_cache, path, read_text)
 
     def _get_schema_from_path(self, path: str) -> Dict[str, Any]:
-        """Load JSON schema from disk with a tiny mtime cache."""
-        st = os.stat(path)
-        mtime = float(st.st_mtime)
-        cached = self._schema_cache.get(path)
-        if cached and cached[0] == mtime:
-            return cached[1]
-        data = read_json(path)
-        if not data:
-            raise ValueError(f"json schema file empty or unreadable: {path}")
-        self._schema_cache[path] = (mtime, data)
-        return data
+        return self._cached_by_path(self._schema_cache, path, read_json)
+
+    def _get_grammar_by_id(self, grammar_id: str, text: Optional[str]) -> str:
+        """Store text under grammar_id when given, else look the id up."""
+        cache = self._grammar_by_id
+        if text is not None:
+            cache[grammar_id] = text
+            cache.move_to_end(grammar_id)
+            while len(cache) > ID_CACHE_SIZE:
+                cache.popitem(last=False)
+            return text
+        self.id_cache_lookups += 1
+        cached = cache.get(grammar_id)
+        if cached is None:
+            raise UnknownGrammarId(grammar_id)
+        cache.move_to_end(grammar_id)
+        self.id_cache_hits += 1
+        return cached
 
     def infer(
         self,
@@ -159,12 +198,23 @@ class StructuredClient:
         assistant_override: Optional[str] = None,
         grammar_path_override: Optional[str] = None,
         grammar_text_override: Optional[str] = None,
+        grammar_id: Optional[str] = None,
         json_schema_path_override: Optional[str] = None,
         json_schema_override: Optional[Dict[str, Any]] = None,
     ) -> Any:
-        if self.mode == "grammar":
+        # A grammar or schema sent with the request picks the mode for that request, so one process
+        # serves both; otherwise the --mode it was started with applies.
+        mode = self.mode
+        if json_schema_override is not None or json_schema_path_override:
+            mode = "json"
+        elif grammar_id or grammar_text_override is not None or grammar_path_override:
+            mode = "grammar"
+
+        if mode == "grammar":
             g = self.grammar
-            if grammar_text_override is not None:
+            if grammar_id:
+                g = self._get_grammar_by_id(grammar_id, grammar_text_override)
+            elif grammar_text_override is not None:
                 g = grammar_text_override
             elif grammar_path_override:
                 g = self._get_grammar_from_path(grammar_path_override)
@@ -240,6 +290,10 @@ def serve_stdin(sc: StructuredClient) -> int:
             if cmd == "ping":
                 send_json({"ok": True, "pong": True})
                 continue
+            if cmd == "stats":
+                send_json({"ok": True, "path_cache_hits": sc.path_cache_hits, "path_cache_lookups": sc.path_cache_lookups,
+                           "id_cache_hits": sc.id_cache_hits, "id_cache_lookups": sc.id_cache_lookups})
+                continue
             if cmd in ("quit", "exit", "stop"):
                 send_json({"ok": True, "bye": True})
                 break
@@ -255,6 +309,7 @@ def serve_stdin(sc: StructuredClient) -> int:
 
             grammar_path = req.get("grammar_path")
             grammar_text = req.get("grammar")
+            grammar_id = req.get("grammar_id")
             schema_path = req.get("json_schema_path")
             schema_obj = req.get("json_schema")
 
@@ -264,11 +319,14 @@ def serve_stdin(sc: StructuredClient) -> int:
                 assistant_override=asst_override,
                 grammar_path_override=grammar_path,
                 grammar_text_override=grammar_text,
+                grammar_id=grammar_id,
                 json_schema_path_override=schema_path,
                 json_schema_override=schema_obj,
             )
             send_json(out)
 
+        except UnknownGrammarId as e:
+            send_json({"error": "unknown_grammar_id", "grammar_id": str(e)})
         except Exception as e:
             sys.stderr.write("ERROR(serve): " + repr(e) + "\n")
             traceback.print_exc(file=sys.stderr)
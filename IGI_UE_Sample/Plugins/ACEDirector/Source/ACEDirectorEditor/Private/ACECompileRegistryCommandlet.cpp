@@ -0,0 +1,62 @@
+#include "ACECompileRegistryCommandlet.h"
+#include "ACECompiledRegistry.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogACECompileRegistry, Log, All);
+
+UACECompileRegistryCommandlet::UACECompileRegistryCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UACECompileRegistryCommandlet::Main(const FString& Params)
+{
+    FString OutputPath = FACECompiledRegistry::DefaultPath();
+    FParse::Value(*Params, TEXT("output="), OutputPath);
+    return CompileRegistry(OutputPath) ? 0 : 1;
+}
+
+bool UACECompileRegistryCommandlet::CompileRegistry(const FString& OutputPath)
+{
+    TArray<FConsoleCommandEntry> ConsoleEntries;
+    TArray<FWorldActionEntry> WorldEntries;
+
+    FString Raw;
+    if (!FFileHelper::LoadFileToString(Raw, *UACEConsoleCommandRegistry::JsonPath()) || !UACEConsoleCommandRegistry::ParseJSON(Raw, ConsoleEntries))
+    {
+        UE_LOG(LogACECompileRegistry, Error, TEXT("Failed to parse %s"), *UACEConsoleCommandRegistry::JsonPath());
+        return false;
+    }
+    if (!FFileHelper::LoadFileToString(Raw, *UACEWorldActionRegistry::JsonPath()) || !UACEWorldActionRegistry::ParseJSON(Raw, WorldEntries))
+    {
+        UE_LOG(LogACECompileRegistry, Error, TEXT("Failed to parse %s"), *UACEWorldActionRegistry::JsonPath());
+        return false;
+    }
+
+    // The complete tier is optional; when present it is baked alongside the curated one.
+    TArray<FConsoleCommandEntry> CompleteEntries;
+    const FString CompletePath = UACEConsoleCommandRegistry::CompleteJsonPath();
+    if (FPaths::FileExists(CompletePath)
+        && (!FFileHelper::LoadFileToString(Raw, *CompletePath) || !UACEConsoleCommandRegistry::ParseJSON(Raw, CompleteEntries)))
+    {
+        UE_LOG(LogACECompileRegistry, Error, TEXT("Failed to parse %s"), *CompletePath);
+        return false;
+    }
+
+    TArray<uint8> Blob;
+    FACECompiledRegistry::Compile(ConsoleEntries, WorldEntries, Blob, CompleteEntries);
+
+    if (!FFileHelper::SaveArrayToFile(Blob, *OutputPath))
+    {
+        UE_LOG(LogACECompileRegistry, Error, TEXT("Failed to write %s"), *OutputPath);
+        return false;
+    }
+
+    UE_LOG(LogACECompileRegistry, Display, TEXT("Wrote %s: %d console commands, %d complete-tier commands, %d world actions, %d bytes"),
+        *OutputPath, ConsoleEntries.Num(), CompleteEntries.Num(), WorldEntries.Num(), Blob.Num());
+    return true;
+}
@@ -6,6 +6,9 @@
 #include "LevelEditor.h"
 #include "Widgets/Docking/SDockTab.h"
 #include "SDirectorPanel.h"
+#include "ACECompileRegistryCommandlet.h"
+#include "ACECompiledRegistry.h"
+#include "UObject/ICookInfo.h"
 
 #define LOCTEXT_NAMESPACE "FACEDirectorEditorModule"
 
@@ -21,10 +24,21 @@ void FACEDirectorEditorModule::StartupModule()
         .SetMenuType(ETabSpawnerMenuType::Hidden);
 
     RegisterMenus();
+
+    // The compiled registry is staged as content; rebuild it before every cook so a package never
+    // ships one older than the JSON it was baked from.
+    CookStartedHandle = UE::Cook::FDelegates::CookStarted.AddRaw(this, &FACEDirectorEditorModule::OnCookStarted);
+}
+
+void FACEDirectorEditorModule::OnCookStarted(UE::Cook::ICookInfo& CookInfo)
+{
+    // An error here fails the cook rather than staging a stale or missing registry.
+    UACECompileRegistryCommandlet::CompileRegistry(FACECompiledRegistry::DefaultPath());
 }
 
 void FACEDirectorEditorModule::ShutdownModule()
 {
+    UE::Cook::FDelegates::CookStarted.Remove(CookStartedHandle);
     FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(ACEDirectorTabName);
 }
 
@@ -0,0 +1,325 @@
+#include "ACEGrammarBenchCommandlet.h"
+#include "ACEConsoleCommandRegistry.h"
+#include "ACEWorldActionRegistry.h"
+#include "ACEToolGrammarBuilder.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogACEGrammarBench, Log, All);
+
+namespace
+{
+    struct FGrammarBenchSeries
+    {
+        TArray<double> BuildUs;
+        int64 Bytes = 0;
+        int64 Rules = 0;
+        int32 Cases = 0;
+    };
+
+    double GrammarBenchPercentile(TArray<double> Values, double P)
+    {
+        if (Values.Num() == 0) return 0.0;
+        Values.Sort();
+        const int32 At = FMath::Clamp(FMath::RoundToInt32(P * (Values.Num() - 1)), 0, Values.Num() - 1);
+        return Values[At];
+    }
+
+    int32 CountGrammarRules(const FString& Grammar)
+    {
+        int32 Count = 0;
+        for (int32 At = Grammar.Find(TEXT("::=")); At != INDEX_NONE; At = Grammar.Find(TEXT("::="), ESearchCase::CaseSensitive, ESearchDir::FromStart, At + 3))
+        {
+            ++Count;
+        }
+        return Count;
+    }
+
+    FString MakeConsoleSample(FStringView Command)
+    {
+        FString Out(TEXT("{\"tool\":\"console.execute\",\"console\":{\"command\":\""));
+        UACEToolGrammarBuilder::AppendJsonEscaped(Out, Command);
+        Out += TEXT("\"}}");
+        return Out;
+    }
+
+    // A world.act plan for Intent with only its required args, each set to the first of its values
+    // or a placeholder of its type, in schema order as the grammar expects.
+    FString MakeActSample(FStringView Intent, FStringView SchemaJson)
+    {
+        FString Out(TEXT("{\"tool\":\"world.act\",\"act\":{\"commands\":[{\"intent\":\""));
+        UACEToolGrammarBuilder::AppendJsonEscaped(Out, Intent);
+        Out += TEXT("\",\"args\":{");
+
+        TSharedPtr<FJsonObject> Schema;
+        if (!SchemaJson.IsEmpty() && FJsonSerializer::Deserialize(TJsonReaderFactory<>::CreateFromView(SchemaJson), Schema) && Schema.IsValid())
+        {
+            bool bFirst = true;
+            for (const TPair<FString, TSharedPtr<FJsonValue>>& Arg : Schema->Values)
+            {
+                if (!Arg.Value.IsValid() || Arg.Value->Type != EJson::Object) continue;
+                const FJsonObject& Spec = *Arg.Value->AsObject();
+                bool bRequired = false;
+                if (!Spec.TryGetBoolField(TEXT("required"), bRequired) || !bRequired) continue;
+
+                if (!bFirst) Out += TEXT(",");
+                bFirst = false;
+                Out += TEXT("\"");
+                UACEToolGrammarBuilder::AppendJsonEscaped(Out, Arg.Key);
+                Out += TEXT("\":");
+
+                FString Type, Value;
+                Spec.TryGetStringField(TEXT("type"), Type);
+                const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+                if (Spec.TryGetArrayField(TEXT("values"), Values) && Values->Num() > 0 && (*Values)[0].IsValid() && (*Values)[0]->TryGetString(Value))
+                {
+                    Out += TEXT("\"");
+                    UACEToolGrammarBuilder::AppendJsonEscaped(Out, Value);
+                    Out += TEXT("\"");
+                }
+                else if (Type == TEXT("number") || Type == TEXT("float") || Type == TEXT("double")) Out += TEXT("1.5");
+                else if (Type == TEXT("int") || Type == TEXT("integer")) Out += TEXT("1");
+                else if (Type == TEXT("bool") || Type == TEXT("boolean")) Out += TEXT("true");
+                else Out += TEXT("\"x\"");
+            }
+        }
+        Out += TEXT("}}]}}");
+        return Out;
+    }
+
+    template<typename EntryType>
+    bool LoadGrammarBenchEntries(const FString& JsonPath, bool (*Parse)(const FString&, TArray<EntryType>&), TArray<EntryType>& Out)
+    {
+        FString Raw;
+        if (FFileHelper::LoadFileToString(Raw, *JsonPath) && Parse(Raw, Out) && Out.Num() > 0) return true;
+        UE_LOG(LogACEGrammarBench, Error, TEXT("%s could not be parsed"), *JsonPath);
+        return false;
+    }
+}
+
+UACEGrammarBenchCommandlet::UACEGrammarBenchCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UACEGrammarBenchCommandlet::Main(const FString& Params)
+{
+    FString KParam = TEXT("3,16,64");
+    FString CorpusPath = FPaths::Combine(FPaths::ProjectDir(), TEXT("ACE/bench/directives.txt"));
+    FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ACE/Bench"),
+        FString::Printf(TEXT("GrammarBench-%s"), *FDateTime::UtcNow().ToString(TEXT("%Y%m%d-%H%M%S"))));
+    int32 Passes = 5;
+    FParse::Value(*Params, TEXT("k="), KParam, false);
+    FParse::Value(*Params, TEXT("corpus="), CorpusPath);
+    FParse::Value(*Params, TEXT("output="), OutputDir);
+    FParse::Value(*Params, TEXT("passes="), Passes);
+    Passes = FMath::Max(1, Passes);
+
+    TArray<int32> Ks;
+    TArray<FString> KTokens;
+    KParam.ParseIntoArray(KTokens, TEXT(","));
+    for (const FString& Token : KTokens)
+    {
+        const int32 K = FCString::Atoi(*Token);
+        if (K > 0) Ks.Add(K);
+    }
+
+    TArray<FString> Lines;
+    TArray<FString> Corpus;
+    FFileHelper::LoadFileToStringArray(Lines, *CorpusPath);
+    for (FString& Line : Lines)
+    {
+        Line.TrimStartAndEndInline();
+        if (!Line.IsEmpty() && !Line.StartsWith(TEXT("#"))) Corpus.Add(MoveTemp(Line));
+    }
+    if (Corpus.Num() == 0 || Ks.Num() == 0)
+    {
+        UE_LOG(LogACEGrammarBench, Error, TEXT("Nothing to run: %d directives in %s, %d values of k"), Corpus.Num(), *CorpusPath, Ks.Num());
+        return 1;
+    }
+
+    IConsoleVariable* FactorVar = IConsoleManager::Get().FindConsoleVariable(TEXT("ace.Grammar.FactorCandidates"));
+    if (!FactorVar)
+    {
+        UE_LOG(LogACEGrammarBench, Error, TEXT("ace.Grammar.FactorCandidates is not registered"));
+        return 1;
+    }
+
+    // The exhaustive console list when present: large K needs more than the curated commands.
+    FString ConsolePath = UACEConsoleCommandRegistry::CompleteJsonPath();
+    if (!FPaths::FileExists(ConsolePath)) ConsolePath = UACEConsoleCommandRegistry::JsonPath();
+    TArray<FConsoleCommandEntry> Console;
+    TArray<FWorldActionEntry> World;
+    if (!LoadGrammarBenchEntries<FConsoleCommandEntry>(ConsolePath, &UACEConsoleCommandRegistry::ParseJSON, Console)
+        || !LoadGrammarBenchEntries<FWorldActionEntry>(UACEWorldActionRegistry::JsonPath(), &UACEWorldActionRegistry::ParseJSON, World))
+    {
+        return 1;
+    }
+
+    const int32 MaxK = FMath::Max(Ks);
+    const int32 NumRealWorld = World.Num();
+    for (int32 Copy = 0; World.Num() < MaxK; ++Copy)
+    {
+        FWorldActionEntry E = World[Copy % NumRealWorld];
+        E.Intent = FString::Printf(TEXT("%s_%d"), *E.Intent, Copy / NumRealWorld + 1);
+        World.Add(MoveTemp(E));
+    }
+
+    TACERetrievalCore<FConsoleCommandEntry> ConsoleCore;
+    ConsoleCore.Build(Console);
+    TACERetrievalCore<FWorldActionEntry> WorldCore;
+    WorldCore.Build(World);
+
+    FString Json;
+    TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+    Writer->WriteObjectStart();
+    Writer->WriteValue(TEXT("schema"), 1);
+    Writer->WriteValue(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+    Writer->WriteValue(TEXT("engine"), FEngineVersion::Current().ToString());
+    Writer->WriteValue(TEXT("build_configuration"), LexToString(FApp::GetBuildConfiguration()));
+    Writer->WriteValue(TEXT("corpus"), FPaths::GetCleanFilename(CorpusPath));
+    Writer->WriteValue(TEXT("directives"), Corpus.Num());
+    Writer->WriteValue(TEXT("passes"), Passes);
+    Writer->WriteValue(TEXT("console_registry"), FPaths::GetCleanFilename(ConsolePath));
+    Writer->WriteValue(TEXT("console_entries"), Console.Num());
+    Writer->WriteValue(TEXT("world_entries"), World.Num());
+    Writer->WriteValue(TEXT("world_entries_synthetic"), World.Num() - NumRealWorld);
+
+    // flat and trie are the EBNF grammar unfactored and factored; json is the JSON Schema.
+    static const TCHAR* ModeNames[] = { TEXT("flat"), TEXT("trie"), TEXT("json") };
+    const bool bSavedFactor = FactorVar->GetBool();
+    TMap<FString, FGrammarBenchSeries> Series;
+
+    Writer->WriteArrayStart(TEXT("cases"));
+    for (const int32 K : Ks)
+    {
+        TArray<FACERetrievalHit> ConsoleHits, WorldHits;
+        ConsoleHits.SetNumUninitialized(K);
+        WorldHits.SetNumUninitialized(K);
+
+        for (int32 d = 0; d < Corpus.Num(); ++d)
+        {
+            const int32 NumConsole = ConsoleCore.Query(Corpus[d], ConsoleHits);
+            const int32 NumWorld = WorldCore.Query(Corpus[d], WorldHits);
+
+            TArray<FStringView> ConsoleNames, IntentNames, IntentSchemas;
+            for (int32 i = 0; i < NumConsole; ++i) ConsoleNames.Add(Console[ConsoleHits[i].Doc].Name);
+            for (int32 i = 0; i < NumWorld; ++i)
+            {
+                IntentNames.Add(World[WorldHits[i].Doc].Intent);
+                IntentSchemas.Add(World[WorldHits[i].Doc].ArgsSchemaJson);
+            }
+
+            // What every mode must accept: the top console command and the top intent.
+            TArray<FString> Samples;
+            if (NumConsole > 0) Samples.Add(MakeConsoleSample(ConsoleNames[0]));
+            if (NumWorld > 0) Samples.Add(MakeActSample(IntentNames[0], IntentSchemas[0]));
+
+            for (int32 Mode = 0; Mode < (int32)UE_ARRAY_COUNT(ModeNames); ++Mode)
+            {
+                const bool bJsonSchema = Mode == 2;
+                FactorVar->Set(Mode == 1, ECVF_SetByCode);
+                auto Build = [&]()
+                    {
+                        return bJsonSchema
+                            ? UACEToolGrammarBuilder::BuildPerQueryJsonSchema(IntentNames, ConsoleNames, IntentSchemas)
+                            : UACEToolGrammarBuilder::BuildPerQueryGrammar(IntentNames, ConsoleNames, IntentSchemas);
+                    };
+
+                FString Grammar = Build();
+                TArray<double> Micros;
+                for (int32 Pass = 0; Pass < Passes; ++Pass)
+                {
+                    const double Start = FPlatformTime::Seconds();
+                    Grammar = Build();
+                    Micros.Add((FPlatformTime::Seconds() - Start) * 1e6);
+                }
+                const double BuildUs = GrammarBenchPercentile(Micros, 0.5);
+                const int32 NumRules = CountGrammarRules(Grammar);
+
+                const FString File = FString::Printf(TEXT("k%d/%s/%03d.%s"), K, ModeNames[Mode], d, bJsonSchema ? TEXT("json") : TEXT("ebnf"));
+                if (!FFileHelper::SaveStringToFile(Grammar, *FPaths::Combine(OutputDir, File), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+                {
+                    UE_LOG(LogACEGrammarBench, Error, TEXT("Could not write %s"), *FPaths::Combine(OutputDir, File));
+                    FactorVar->Set(bSavedFactor, ECVF_SetByCode);
+                    return 1;
+                }
+
+                Writer->WriteObjectStart();
+                Writer->WriteValue(TEXT("k"), K);
+                Writer->WriteValue(TEXT("mode"), ModeNames[Mode]);
+                Writer->WriteValue(TEXT("format"), bJsonSchema ? TEXT("json_schema") : TEXT("ebnf"));
+                Writer->WriteValue(TEXT("file"), File);
+                Writer->WriteValue(TEXT("directive"), Corpus[d]);
+                Writer->WriteValue(TEXT("console_candidates"), NumConsole);
+                Writer->WriteValue(TEXT("world_candidates"), NumWorld);
+                Writer->WriteValue(TEXT("bytes"), Grammar.Len());
+                Writer->WriteValue(TEXT("rules"), NumRules);
+                Writer->WriteValue(TEXT("build_us"), BuildUs);
+                Writer->WriteArrayStart(TEXT("samples"));
+                for (const FString& Sample : Samples) Writer->WriteValue(Sample);
+                Writer->WriteArrayEnd();
+                Writer->WriteObjectEnd();
+
+                FGrammarBenchSeries& S = Series.FindOrAdd(FString::Printf(TEXT("%d/%s"), K, ModeNames[Mode]));
+                S.BuildUs.Add(BuildUs);
+                S.Bytes += Grammar.Len();
+                S.Rules += NumRules;
+                ++S.Cases;
+            }
+        }
+    }
+    Writer->WriteArrayEnd();
+    FactorVar->Set(bSavedFactor, ECVF_SetByCode);
+
+    Writer->WriteArrayStart(TEXT("summary"));
+    for (const int32 K : Ks)
+    {
+        for (const TCHAR* Mode : ModeNames)
+        {
+            const FGrammarBenchSeries* S = Series.Find(FString::Printf(TEXT("%d/%s"), K, Mode));
+            if (!S || S->Cases == 0) continue;
+            const double P50 = GrammarBenchPercentile(S->BuildUs, 0.5);
+            const double P99 = GrammarBenchPercentile(S->BuildUs, 0.99);
+
+            Writer->WriteObjectStart();
+            Writer->WriteValue(TEXT("k"), K);
+            Writer->WriteValue(TEXT("mode"), Mode);
+            Writer->WriteValue(TEXT("cases"), S->Cases);
+            Writer->WriteValue(TEXT("build_p50_us"), P50);
+            Writer->WriteValue(TEXT("build_p99_us"), P99);
+            Writer->WriteValue(TEXT("mean_bytes"), (double)S->Bytes / S->Cases);
+            Writer->WriteValue(TEXT("mean_rules"), (double)S->Rules / S->Cases);
+            Writer->WriteObjectEnd();
+
+            UE_LOG(LogACEGrammarBench, Display, TEXT("k=%-3d %-4s: build p50 %7.1f us, p99 %7.1f us, %6.0f bytes, %5.1f rules"),
+                K, Mode, P50, P99, (double)S->Bytes / S->Cases, (double)S->Rules / S->Cases);
+        }
+    }
+    Writer->WriteArrayEnd();
+
+    Writer->WriteObjectEnd();
+    Writer->Close();
+
+    const FString ManifestPath = FPaths::Combine(OutputDir, TEXT("manifest.json"));
+    IFileManager::Get().MakeDirectory(*OutputDir, true);
+    if (!FFileHelper::SaveStringToFile(Json, *ManifestPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+    {
+        UE_LOG(LogACEGrammarBench, Error, TEXT("Could not write %s"), *ManifestPath);
+        return 1;
+    }
+    UE_LOG(LogACEGrammarBench, Display, TEXT("Wrote %s; measure with: python ACE/bench/grammar_bench.py %s"), *ManifestPath, *ManifestPath);
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include "ACEHnswBenchCommandlet.h"
+#include "ACEConsoleCommandRegistry.h"
+#include "ACEWorldActionRegistry.h"
+#include "ACEHnswIndex.h"
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogACEHnswBench, Log, All);
+
+UACEHnswBenchCommandlet::UACEHnswBenchCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+template<typename EntryType>
+static void AppendRegistryDocs(const FString& JsonPath, bool (*Parse)(const FString&, TArray<EntryType>&), TArray<FString>& OutDocs)
+{
+    FString Raw;
+    TArray<EntryType> Entries;
+    if (!FFileHelper::LoadFileToString(Raw, *JsonPath) || !Parse(Raw, Entries))
+    {
+        UE_LOG(LogACEHnswBench, Warning, TEXT("Skipping %s: could not be parsed"), *JsonPath);
+        return;
+    }
+    for (const EntryType& E : Entries)
+    {
+        FString& Text = OutDocs.AddDefaulted_GetRef();
+        TACERetrievalTraits<EntryType>::AppendDocText(E, Text);
+    }
+}
+
+int32 UACEHnswBenchCommandlet::Main(const FString& Params)
+{
+    int32 NumDocs = 50000;
+    int32 NumQueries = 500;
+    int32 K = 5;
+    float Target = 0.95f;
+    FACEHnswParams Build = ACEHnsw::GetBuildParams();
+    FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ACE/Bench"),
+        FString::Printf(TEXT("HnswBench-%s.json"), *FDateTime::UtcNow().ToString(TEXT("%Y%m%d-%H%M%S"))));
+    FParse::Value(*Params, TEXT("docs="), NumDocs);
+    FParse::Value(*Params, TEXT("queries="), NumQueries);
+    FParse::Value(*Params, TEXT("k="), K);
+    FParse::Value(*Params, TEXT("target="), Target);
+    FParse::Value(*Params, TEXT("m="), Build.M);
+    FParse::Value(*Params, TEXT("efc="), Build.EfConstruction);
+    FParse::Value(*Params, TEXT("output="), OutputPath);
+    K = FMath::Max(1, K);
+    NumQueries = FMath::Max(1, NumQueries);
+
+    TArray<FString> Docs;
+    AppendRegistryDocs<FConsoleCommandEntry>(UACEConsoleCommandRegistry::JsonPath(), &UACEConsoleCommandRegistry::ParseJSON, Docs);
+    AppendRegistryDocs<FWorldActionEntry>(UACEWorldActionRegistry::JsonPath(), &UACEWorldActionRegistry::ParseJSON, Docs);
+    const int32 NumRegistryDocs = Docs.Num();
+
+    // Pad with entries stitched together from registry vocabulary, so the corpus has the same
+    // token statistics at title scale.
+    TArray<FString> Vocabulary;
+    for (const FString& Doc : Docs)
+    {
+        FACERetrievalIndex::ForEachToken(Doc, [&Vocabulary](FStringView Token) { Vocabulary.Emplace(Token); });
+    }
+    if (Vocabulary.Num() == 0)
+    {
+        UE_LOG(LogACEHnswBench, Error, TEXT("No registry text to build a corpus from"));
+        return 1;
+    }
+
+    FRandomStream Rng(1234);
+    while (Docs.Num() < NumDocs)
+    {
+        FString& Doc = Docs.AddDefaulted_GetRef();
+        const int32 NumWords = Rng.RandRange(3, 12);
+        for (int32 w = 0; w < NumWords; ++w)
+        {
+            if (w > 0) Doc += TEXT(' ');
+            Doc += Vocabulary[Rng.RandHelper(Vocabulary.Num())];
+        }
+    }
+
+    FACEDenseIndex Dense;
+    Dense.BeginBuild(Docs.Num());
+    for (const FString& Doc : Docs) Dense.AddDocument(Doc);
+    Dense.FinishBuild();
+
+    const double BuildStart = FPlatformTime::Seconds();
+    FACEHnswIndex Graph;
+    Graph.Build(Dense, Build);
+    const double BuildSeconds = FPlatformTime::Seconds() - BuildStart;
+
+    UE_LOG(LogACEHnswBench, Display, TEXT("%d docs (%d from registries), M=%d efConstruction=%d: graph built in %.2f s, %.1f MB (vectors %.1f MB)"),
+        Docs.Num(), NumRegistryDocs, Graph.GetM(), Build.EfConstruction, BuildSeconds,
+        Graph.GetAllocatedSize() / (1024.0 * 1024.0), Dense.GetAllocatedSize() / (1024.0 * 1024.0));
+
+    // Queries are a few consecutive words of a random document: short, like spoken directives.
+    struct FBenchQuery
+    {
+        int8 Vector[FACEDenseIndex::Dim];
+        float Scale = 0.f;
+        TArray<int32> Truth;
+    };
+    TArray<FBenchQuery> Queries;
+    Queries.SetNum(NumQueries);
+    TArray<FACERetrievalHit> Hits;
+    Hits.SetNumUninitialized(K);
+
+    double BruteSeconds = 0.0;
+    for (FBenchQuery& Q : Queries)
+    {
+        TArray<FString> Words;
+        FACERetrievalIndex::ForEachToken(Docs[Rng.RandHelper(Docs.Num())], [&Words](FStringView Token) { Words.Emplace(Token); });
+        const int32 First = Rng.RandHelper(FMath::Max(1, Words.Num() - 2));
+        const FString Text = FString::Join(MakeArrayView(Words).Mid(First, 3), TEXT(" "));
+        Q.Scale = FACEDenseIndex::Embed(Text, Q.Vector);
+
+        const double Start = FPlatformTime::Seconds();
+        const int32 Count = Dense.QueryEmbedded(Q.Vector, Q.Scale, Hits);
+        BruteSeconds += FPlatformTime::Seconds() - Start;
+        for (int32 i = 0; i < Count; ++i) Q.Truth.Add(Hits[i].Doc);
+    }
+    UE_LOG(LogACEHnswBench, Display, TEXT("brute force: %.1f us/query"), BruteSeconds * 1e6 / NumQueries);
+
+    FString Json;
+    TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+    Writer->WriteObjectStart();
+    Writer->WriteValue(TEXT("schema"), 1);
+    Writer->WriteValue(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+    Writer->WriteValue(TEXT("engine"), FEngineVersion::Current().ToString());
+    Writer->WriteValue(TEXT("build_configuration"), LexToString(FApp::GetBuildConfiguration()));
+    Writer->WriteValue(TEXT("docs"), Docs.Num());
+    Writer->WriteValue(TEXT("registry_docs"), NumRegistryDocs);
+    Writer->WriteValue(TEXT("queries"), NumQueries);
+    Writer->WriteValue(TEXT("k"), K);
+    Writer->WriteValue(TEXT("target"), Target);
+    Writer->WriteValue(TEXT("m"), Graph.GetM());
+    Writer->WriteValue(TEXT("ef_construction"), Build.EfConstruction);
+    Writer->WriteValue(TEXT("build_s"), BuildSeconds);
+    Writer->WriteValue(TEXT("graph_bytes"), (int64)Graph.GetAllocatedSize());
+    Writer->WriteValue(TEXT("vector_bytes"), (int64)Dense.GetAllocatedSize());
+    Writer->WriteValue(TEXT("brute_us"), BruteSeconds * 1e6 / NumQueries);
+
+    TArray<int32> EfValues = { K, 16, 32, 64, 128, 256, 512 };
+    EfValues.AddUnique(ACEHnsw::GetEfSearch());
+    EfValues.RemoveAll([K](int32 Ef) { return Ef < K; });
+    EfValues.Sort();
+
+    int32 RecommendedEf = INDEX_NONE;
+    Writer->WriteArrayStart(TEXT("sweep"));
+    for (const int32 Ef : EfValues)
+    {
+        int32 Found = 0;
+        int32 Expected = 0;
+        double Seconds = 0.0;
+        for (const FBenchQuery& Q : Queries)
+        {
+            const double Start = FPlatformTime::Seconds();
+            const int32 Count = Graph.Search(Dense, Q.Vector, Q.Scale, Ef, Hits);
+            Seconds += FPlatformTime::Seconds() - Start;
+
+            Expected += Q.Truth.Num();
+            for (int32 i = 0; i < Count; ++i) Found += Q.Truth.Contains(Hits[i].Doc) ? 1 : 0;
+        }
+        const double Recall = Expected > 0 ? (double)Found / Expected : 1.0;
+        if (RecommendedEf == INDEX_NONE && Recall >= Target) RecommendedEf = Ef;
+        UE_LOG(LogACEHnswBench, Display, TEXT("ef=%4d: recall@%d %.4f, %.1f us/query"), Ef, K, Recall, Seconds * 1e6 / NumQueries);
+
+        Writer->WriteObjectStart();
+        Writer->WriteValue(TEXT("ef"), Ef);
+        Writer->WriteValue(TEXT("recall"), Recall);
+        Writer->WriteValue(TEXT("us_per_query"), Seconds * 1e6 / NumQueries);
+        Writer->WriteObjectEnd();
+    }
+    Writer->WriteArrayEnd();
+
+    // -1 when no ef in the sweep reached the target.
+    Writer->WriteValue(TEXT("recommended_ef"), RecommendedEf);
+    Writer->WriteObjectEnd();
+    Writer->Close();
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(OutputPath), true);
+    if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+    {
+        UE_LOG(LogACEHnswBench, Error, TEXT("Could not write %s"), *OutputPath);
+        return 1;
+    }
+    UE_LOG(LogACEHnswBench, Display, TEXT("Wrote %s"), *OutputPath);
+
+    if (RecommendedEf == INDEX_NONE)
+    {
+        UE_LOG(LogACEHnswBench, Warning, TEXT("No ef reached recall %.2f; raise -m or -efc"), Target);
+        return 1;
+    }
+    UE_LOG(LogACEHnswBench, Display, TEXT("Recall %.2f reached at ef=%d (set ace.Hnsw.EfSearch=%d)"), Target, RecommendedEf, RecommendedEf);
+    return 0;
+}
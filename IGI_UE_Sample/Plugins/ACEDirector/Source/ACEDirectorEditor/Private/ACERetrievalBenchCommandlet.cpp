@@ -0,0 +1,462 @@
+#include "ACERetrievalBenchCommandlet.h"
+#include "ACEConsoleCommandRegistry.h"
+#include "ACEWorldActionRegistry.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogACERetrievalBench, Log, All);
+
+namespace
+{
+    // Forwards to the real allocator and counts what the bench thread allocates while counting is
+    // on. Installed as GMalloc only for the duration of the run.
+    class FRetrievalBenchMalloc final : public FMalloc
+    {
+    public:
+        explicit FRetrievalBenchMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+        virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+        {
+            Note(Size);
+            return Inner->Malloc(Size, Alignment);
+        }
+        virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+        {
+            if (NewSize > 0) Note(NewSize);
+            return Inner->Realloc(Ptr, NewSize, Alignment);
+        }
+        virtual void Free(void* Ptr) override { Inner->Free(Ptr); }
+        virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override { return Inner->QuantizeSize(Size, Alignment); }
+        virtual bool GetAllocationSize(void* Original, SIZE_T& OutSize) override { return Inner->GetAllocationSize(Original, OutSize); }
+        virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+        virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+        virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+        static thread_local bool bCounting;
+        static thread_local int64 NumAllocs;
+        static thread_local int64 NumBytes;
+
+    private:
+        static void Note(SIZE_T Size)
+        {
+            if (bCounting)
+            {
+                ++NumAllocs;
+                NumBytes += (int64)Size;
+            }
+        }
+
+        FMalloc* Inner;
+    };
+
+    thread_local bool FRetrievalBenchMalloc::bCounting = false;
+    thread_local int64 FRetrievalBenchMalloc::NumAllocs = 0;
+    thread_local int64 FRetrievalBenchMalloc::NumBytes = 0;
+
+    // Whether allocations were seen by FRetrievalBenchMalloc. When not, the allocs fields are left
+    // out of the results rather than reported as zero.
+    bool GRetrievalBenchCountsAllocs = false;
+
+    // Installs a counting FRetrievalBenchMalloc as GMalloc for its lifetime and restores the previous
+    // allocator on every way out. The counter is deliberately never freed: another thread may still be
+    // inside it after GMalloc is restored, and all it does is forward. FMemory can be built to call
+    // the platform allocator inline, bypassing GMalloc, so one probe allocation checks that counting
+    // actually sees anything.
+    class FScopedRetrievalBenchMalloc
+    {
+    public:
+        FScopedRetrievalBenchMalloc()
+            : Saved(GMalloc)
+        {
+            FRetrievalBenchMalloc* Counting = new FRetrievalBenchMalloc(Saved);
+            FPlatformMisc::MemoryBarrier();
+            GMalloc = Counting;
+
+            FRetrievalBenchMalloc::NumAllocs = 0;
+            FRetrievalBenchMalloc::bCounting = true;
+            FMemory::Free(FMemory::Malloc(16));
+            FRetrievalBenchMalloc::bCounting = false;
+            GRetrievalBenchCountsAllocs = FRetrievalBenchMalloc::NumAllocs > 0;
+            FRetrievalBenchMalloc::NumAllocs = 0;
+            FRetrievalBenchMalloc::NumBytes = 0;
+        }
+
+        ~FScopedRetrievalBenchMalloc()
+        {
+            GMalloc = Saved;
+            FPlatformMisc::MemoryBarrier();
+            GRetrievalBenchCountsAllocs = false;
+        }
+
+        // The allocator whose allocations are counted.
+        FMalloc* GetCounted() const { return Saved; }
+
+    private:
+        FMalloc* Saved;
+    };
+
+    struct FRetrievalBenchStats
+    {
+        int32 Samples = 0;
+        double P50Us = 0.0;
+        double P99Us = 0.0;
+        double MeanUs = 0.0;
+        double AllocsPerQuery = 0.0;
+        double AllocBytesPerQuery = 0.0;
+    };
+
+    double RetrievalBenchPercentile(const TArray<double>& Sorted, double P)
+    {
+        if (Sorted.Num() == 0) return 0.0;
+        const int32 At = FMath::Clamp(FMath::RoundToInt32(P * (Sorted.Num() - 1)), 0, Sorted.Num() - 1);
+        return Sorted[At];
+    }
+
+    // One untimed warm-up pass (thread-local scratch, lazily sized buffers), then Passes timed
+    // passes over the corpus, one sample per directive.
+    template<typename FnType>
+    FRetrievalBenchStats MeasureCorpus(const TArray<FString>& Corpus, int32 Passes, FnType&& Fn)
+    {
+        for (const FString& Directive : Corpus) Fn(Directive);
+
+        TArray<double> Micros;
+        Micros.Reserve(Corpus.Num() * Passes);
+        FRetrievalBenchMalloc::NumAllocs = 0;
+        FRetrievalBenchMalloc::NumBytes = 0;
+        for (int32 Pass = 0; Pass < Passes; ++Pass)
+        {
+            for (const FString& Directive : Corpus)
+            {
+                FRetrievalBenchMalloc::bCounting = true;
+                const double Start = FPlatformTime::Seconds();
+                Fn(Directive);
+                const double Seconds = FPlatformTime::Seconds() - Start;
+                FRetrievalBenchMalloc::bCounting = false;
+                Micros.Add(Seconds * 1e6);
+            }
+        }
+
+        FRetrievalBenchStats Stats;
+        Stats.Samples = Micros.Num();
+        if (Stats.Samples == 0) return Stats;
+        double Total = 0.0;
+        for (const double Us : Micros) Total += Us;
+        Micros.Sort();
+        Stats.P50Us = RetrievalBenchPercentile(Micros, 0.50);
+        Stats.P99Us = RetrievalBenchPercentile(Micros, 0.99);
+        Stats.MeanUs = Total / Stats.Samples;
+        Stats.AllocsPerQuery = (double)FRetrievalBenchMalloc::NumAllocs / Stats.Samples;
+        Stats.AllocBytesPerQuery = (double)FRetrievalBenchMalloc::NumBytes / Stats.Samples;
+        return Stats;
+    }
+
+    using FRetrievalBenchWriter = TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>;
+
+    void WriteRetrievalBenchStats(FRetrievalBenchWriter& Writer, const FRetrievalBenchStats& Stats)
+    {
+        Writer.WriteValue(TEXT("samples"), Stats.Samples);
+        Writer.WriteValue(TEXT("p50_us"), Stats.P50Us);
+        Writer.WriteValue(TEXT("p99_us"), Stats.P99Us);
+        Writer.WriteValue(TEXT("mean_us"), Stats.MeanUs);
+        if (GRetrievalBenchCountsAllocs)
+        {
+            Writer.WriteValue(TEXT("allocs_per_query"), Stats.AllocsPerQuery);
+            Writer.WriteValue(TEXT("alloc_bytes_per_query"), Stats.AllocBytesPerQuery);
+        }
+    }
+
+    template<typename EntryType>
+    bool LoadRetrievalBenchEntries(const FString& JsonPath, bool (*Parse)(const FString&, TArray<EntryType>&), TArray<EntryType>& Out)
+    {
+        FString Raw;
+        if (FFileHelper::LoadFileToString(Raw, *JsonPath) && Parse(Raw, Out) && Out.Num() > 0) return true;
+        UE_LOG(LogACERetrievalBench, Error, TEXT("%s could not be parsed"), *JsonPath);
+        return false;
+    }
+
+    // Resident bytes of the prompt-only text as FStrings in the entries versus in an
+    // FACEColdTextStore, plus the cost of inflating every frame once.
+    template<typename EntryType>
+    void ReportTextStorage(FRetrievalBenchWriter& Writer, const FString& JsonPath, const TArray<EntryType>& Entries)
+    {
+        using FTraits = TACERetrievalTraits<EntryType>;
+        int64 InEntries = 0;
+        for (const EntryType& E : Entries)
+        {
+            for (int32 Field = 0; Field < FTraits::NumColdFields; ++Field) InEntries += FTraits::GetColdField(E, Field).GetAllocatedSize();
+        }
+
+        FACEColdTextStore Store;
+        const double BuildStart = FPlatformTime::Seconds();
+        Store.Build(Entries.Num(), FTraits::NumColdFields, [&Entries](int32 Entry, int32 Field)
+        {
+            return FStringView(FTraits::GetColdField(Entries[Entry], Field));
+        });
+        const double BuildSeconds = FPlatformTime::Seconds() - BuildStart;
+        const int64 Stored = (int64)Store.GetAllocatedSize();
+
+        const double InflateStart = FPlatformTime::Seconds();
+        for (int32 Entry = 0; Entry < Entries.Num(); Entry += FACEColdTextStore::EntriesPerFrame) Store.Get(Entry);
+        const int32 NumFrames = (Entries.Num() + FACEColdTextStore::EntriesPerFrame - 1) / FACEColdTextStore::EntriesPerFrame;
+        const double InflateUs = NumFrames > 0 ? (FPlatformTime::Seconds() - InflateStart) * 1e6 / NumFrames : 0.0;
+
+        Writer.WriteObjectStart();
+        Writer.WriteValue(TEXT("file"), FPaths::GetCleanFilename(JsonPath));
+        Writer.WriteValue(TEXT("entries"), Entries.Num());
+        Writer.WriteValue(TEXT("text_bytes_in_entries"), InEntries);
+        Writer.WriteValue(TEXT("text_bytes_compressed"), Stored);
+        Writer.WriteValue(TEXT("saved_bytes"), InEntries - Stored);
+        Writer.WriteValue(TEXT("build_seconds"), BuildSeconds);
+        Writer.WriteValue(TEXT("inflate_us_per_frame"), InflateUs);
+        Writer.WriteObjectEnd();
+
+        UE_LOG(LogACERetrievalBench, Display, TEXT("%s: %d entries, text %.1f KB as FStrings -> %.1f KB compressed (%.0f%% saved), %.1f us to inflate a frame"),
+            *FPaths::GetCleanFilename(JsonPath), Entries.Num(), InEntries / 1024.0, Stored / 1024.0,
+            InEntries > 0 ? 100.0 * (InEntries - Stored) / InEntries : 0.0, InflateUs);
+    }
+
+    FString RandomPhrase(FRandomStream& Rng, const TArray<FString>& Vocabulary, int32 MinWords, int32 MaxWords)
+    {
+        FString Phrase;
+        const int32 NumWords = Rng.RandRange(MinWords, MaxWords);
+        for (int32 w = 0; w < NumWords; ++w)
+        {
+            if (w > 0) Phrase += TEXT(' ');
+            Phrase += Vocabulary[Rng.RandHelper(Vocabulary.Num())];
+        }
+        return Phrase;
+    }
+
+    // The real entries first, then copies of random real entries with a fresh name, aliases and doc
+    // drawn from the registry vocabulary, up to Size. Rename gives a copy its new unique name.
+    template<typename EntryType, typename RenameType>
+    TArray<EntryType> MakeSyntheticRegistry(const TArray<EntryType>& Real, const TArray<FString>& Vocabulary, int32 Size, int32 Seed, RenameType&& Rename)
+    {
+        TArray<EntryType> Entries(MakeArrayView(Real).Left(Size));
+        Entries.Reserve(Size);
+        FRandomStream Rng(Seed);
+        while (Entries.Num() < Size)
+        {
+            EntryType& E = Entries.Add_GetRef(Real[Rng.RandHelper(Real.Num())]);
+            Rename(E, Vocabulary[Rng.RandHelper(Vocabulary.Num())], Entries.Num());
+            E.Aliases.Reset();
+            const int32 NumAliases = Rng.RandRange(0, 2);
+            for (int32 a = 0; a < NumAliases; ++a) E.Aliases.Add(RandomPhrase(Rng, Vocabulary, 2, 3));
+            E.Doc = RandomPhrase(Rng, Vocabulary, 6, 20);
+        }
+        return Entries;
+    }
+
+    template<typename EntryType>
+    void BenchRegistry(FRetrievalBenchWriter& Writer, const TCHAR* Registry, const TArray<EntryType>& Entries, const TArray<FString>& Corpus, int32 Passes, int32 K)
+    {
+        const double BuildStart = FPlatformTime::Seconds();
+        TACERetrievalCore<EntryType> Core;
+        Core.Build(Entries);
+        const double BuildSeconds = FPlatformTime::Seconds() - BuildStart;
+
+        Writer.WriteObjectStart();
+        Writer.WriteValue(TEXT("registry"), Registry);
+        Writer.WriteValue(TEXT("entries"), Entries.Num());
+        Writer.WriteValue(TEXT("build_seconds"), BuildSeconds);
+        Writer.WriteValue(TEXT("index_bytes"), (int64)Core.GetAllocatedSize());
+        Writer.WriteObjectStart(TEXT("index_bytes_by_part"));
+        Writer.WriteValue(TEXT("sparse"), (int64)Core.GetIndex().GetAllocatedSize());
+        Writer.WriteValue(TEXT("dense"), (int64)Core.GetDenseIndex().GetAllocatedSize());
+        Writer.WriteValue(TEXT("hnsw"), (int64)Core.GetGraph().GetAllocatedSize());
+        Writer.WriteValue(TEXT("fuzzy"), (int64)Core.GetFuzzyIndex().GetAllocatedSize());
+        Writer.WriteValue(TEXT("tags"), (int64)Core.GetTagIndex().GetAllocatedSize());
+        Writer.WriteValue(TEXT("names"), (int64)Core.GetNameTrie().GetAllocatedSize());
+        Writer.WriteObjectEnd();
+        Writer.WriteValue(TEXT("hnsw_built"), Core.GetGraph().IsBuilt());
+
+        IConsoleVariable* ModeVar = IConsoleManager::Get().FindConsoleVariable(TEXT("ace.RetrievalMode"));
+        const int32 SavedMode = ModeVar ? ModeVar->GetInt() : 0;
+        static const TCHAR* ModeNames[] = { TEXT("sparse"), TEXT("dense"), TEXT("hybrid") };
+
+        TArray<FACERetrievalHit> Hits;
+        Hits.SetNumUninitialized(K);
+        Writer.WriteArrayStart(TEXT("modes"));
+        for (int32 Mode = 0; Mode < (int32)UE_ARRAY_COUNT(ModeNames) && ModeVar; ++Mode)
+        {
+            ModeVar->Set(Mode, ECVF_SetByCode);
+            const FRetrievalBenchStats Stats = MeasureCorpus(Corpus, Passes, [&Core, &Hits](const FString& Directive) { Core.Query(Directive, Hits); });
+
+            Writer.WriteObjectStart();
+            Writer.WriteValue(TEXT("mode"), ModeNames[Mode]);
+            WriteRetrievalBenchStats(Writer, Stats);
+            Writer.WriteObjectEnd();
+
+            UE_LOG(LogACERetrievalBench, Display, TEXT("%-7s %6d entries %-6s: p50 %7.1f us, p99 %7.1f us, %.1f allocs/query, index %.1f MB, built in %.2f s"),
+                Registry, Entries.Num(), ModeNames[Mode], Stats.P50Us, Stats.P99Us, Stats.AllocsPerQuery,
+                Core.GetAllocatedSize() / (1024.0 * 1024.0), BuildSeconds);
+        }
+        Writer.WriteArrayEnd();
+        Writer.WriteObjectEnd();
+
+        if (ModeVar) ModeVar->Set(SavedMode, ECVF_SetByCode);
+    }
+}
+
+UACERetrievalBenchCommandlet::UACERetrievalBenchCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UACERetrievalBenchCommandlet::Main(const FString& Params)
+{
+    FString SizesParam = TEXT("1000,10000,100000");
+    FString CorpusPath = FPaths::Combine(FPaths::ProjectDir(), TEXT("ACE/bench/directives.txt"));
+    FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ACE/Bench"),
+        FString::Printf(TEXT("RetrievalBench-%s.json"), *FDateTime::UtcNow().ToString(TEXT("%Y%m%d-%H%M%S"))));
+    int32 Passes = 5;
+    int32 K = 5;
+    FParse::Value(*Params, TEXT("sizes="), SizesParam, false);
+    FParse::Value(*Params, TEXT("corpus="), CorpusPath);
+    FParse::Value(*Params, TEXT("output="), OutputPath);
+    FParse::Value(*Params, TEXT("passes="), Passes);
+    FParse::Value(*Params, TEXT("k="), K);
+    Passes = FMath::Max(1, Passes);
+    K = FMath::Max(1, K);
+
+    TArray<int32> Sizes;
+    TArray<FString> SizeTokens;
+    SizesParam.ParseIntoArray(SizeTokens, TEXT(","));
+    for (const FString& Token : SizeTokens)
+    {
+        const int32 Size = FCString::Atoi(*Token);
+        if (Size > 0) Sizes.Add(Size);
+    }
+
+    TArray<FString> Lines;
+    TArray<FString> Corpus;
+    FFileHelper::LoadFileToStringArray(Lines, *CorpusPath);
+    for (FString& Line : Lines)
+    {
+        Line.TrimStartAndEndInline();
+        if (!Line.IsEmpty() && !Line.StartsWith(TEXT("#"))) Corpus.Add(MoveTemp(Line));
+    }
+    if (Corpus.Num() == 0 || Sizes.Num() == 0)
+    {
+        UE_LOG(LogACERetrievalBench, Error, TEXT("Nothing to run: %d directives in %s, %d sizes"), Corpus.Num(), *CorpusPath, Sizes.Num());
+        return 1;
+    }
+
+    TArray<FConsoleCommandEntry> Console;
+    TArray<FWorldActionEntry> World;
+    if (!LoadRetrievalBenchEntries<FConsoleCommandEntry>(UACEConsoleCommandRegistry::JsonPath(), &UACEConsoleCommandRegistry::ParseJSON, Console)
+        || !LoadRetrievalBenchEntries<FWorldActionEntry>(UACEWorldActionRegistry::JsonPath(), &UACEWorldActionRegistry::ParseJSON, World))
+    {
+        return 1;
+    }
+
+    TArray<FString> Vocabulary;
+    FString DocText;
+    const auto AddVocabulary = [&Vocabulary](FStringView Token) { Vocabulary.Emplace(Token); };
+    for (const FConsoleCommandEntry& E : Console)
+    {
+        DocText.Reset();
+        TACERetrievalTraits<FConsoleCommandEntry>::AppendDocText(E, DocText);
+        FACERetrievalIndex::ForEachToken(DocText, AddVocabulary);
+    }
+    for (const FWorldActionEntry& E : World)
+    {
+        DocText.Reset();
+        TACERetrievalTraits<FWorldActionEntry>::AppendDocText(E, DocText);
+        FACERetrievalIndex::ForEachToken(DocText, AddVocabulary);
+    }
+
+    FString Json;
+    TSharedRef<FRetrievalBenchWriter> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+    Writer->WriteObjectStart();
+    Writer->WriteValue(TEXT("schema"), 1);
+    Writer->WriteValue(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+    Writer->WriteValue(TEXT("engine"), FEngineVersion::Current().ToString());
+    Writer->WriteValue(TEXT("build_configuration"), LexToString(FApp::GetBuildConfiguration()));
+    Writer->WriteValue(TEXT("corpus"), FPaths::GetCleanFilename(CorpusPath));
+    Writer->WriteValue(TEXT("directives"), Corpus.Num());
+    Writer->WriteValue(TEXT("passes"), Passes);
+    Writer->WriteValue(TEXT("k"), K);
+
+    const FScopedRetrievalBenchMalloc CountingMalloc;
+    Writer->WriteValue(TEXT("allocator"), CountingMalloc.GetCounted()->GetDescriptiveName());
+    Writer->WriteValue(TEXT("allocs_counted"), GRetrievalBenchCountsAllocs);
+    if (!GRetrievalBenchCountsAllocs)
+    {
+        UE_LOG(LogACERetrievalBench, Warning, TEXT("Allocations bypass GMalloc (%s) in this build; results will not include allocation counts"),
+            CountingMalloc.GetCounted()->GetDescriptiveName());
+    }
+
+    // Per-directive costs that do not depend on registry size.
+    Writer->WriteObjectStart(TEXT("primitives"));
+    {
+        int32 NumTokens = 0;
+        const FRetrievalBenchStats Tokenize = MeasureCorpus(Corpus, Passes, [&NumTokens](const FString& Directive)
+        {
+            FACERetrievalIndex::ForEachToken(Directive, [&NumTokens](FStringView) { ++NumTokens; });
+        });
+        Writer->WriteObjectStart(TEXT("tokenize"));
+        WriteRetrievalBenchStats(*Writer, Tokenize);
+        Writer->WriteObjectEnd();
+
+        int8 Vector[FACEDenseIndex::Dim];
+        const FRetrievalBenchStats Embed = MeasureCorpus(Corpus, Passes, [&Vector](const FString& Directive) { FACEDenseIndex::Embed(Directive, Vector); });
+        Writer->WriteObjectStart(TEXT("embed"));
+        WriteRetrievalBenchStats(*Writer, Embed);
+        Writer->WriteObjectEnd();
+
+        UE_LOG(LogACERetrievalBench, Display, TEXT("tokenize: p50 %.2f us, p99 %.2f us; embed: p50 %.2f us, p99 %.2f us"),
+            Tokenize.P50Us, Tokenize.P99Us, Embed.P50Us, Embed.P99Us);
+    }
+    Writer->WriteObjectEnd();
+
+    // How much the compressed doc/schema/example storage saves on the shipped registries,
+    // including the exhaustive console list when it is present.
+    Writer->WriteArrayStart(TEXT("text_storage"));
+    ReportTextStorage(*Writer, UACEConsoleCommandRegistry::JsonPath(), Console);
+    {
+        const FString CompletePath = UACEConsoleCommandRegistry::CompleteJsonPath();
+        TArray<FConsoleCommandEntry> Complete;
+        if (FPaths::FileExists(CompletePath) && LoadRetrievalBenchEntries<FConsoleCommandEntry>(CompletePath, &UACEConsoleCommandRegistry::ParseJSON, Complete))
+        {
+            ReportTextStorage(*Writer, CompletePath, Complete);
+        }
+    }
+    ReportTextStorage(*Writer, UACEWorldActionRegistry::JsonPath(), World);
+    Writer->WriteArrayEnd();
+
+    Writer->WriteArrayStart(TEXT("results"));
+    for (const int32 Size : Sizes)
+    {
+        const TArray<FConsoleCommandEntry> SyntheticConsole = MakeSyntheticRegistry(Console, Vocabulary, Size, 0x41434531,
+            [](FConsoleCommandEntry& E, const FString& Word, int32 Number) { E.Name = FString::Printf(TEXT("%s.%s%d"), *E.Name, *Word, Number); });
+        BenchRegistry(*Writer, TEXT("console"), SyntheticConsole, Corpus, Passes, K);
+
+        const TArray<FWorldActionEntry> SyntheticWorld = MakeSyntheticRegistry(World, Vocabulary, Size, 0x41434532,
+            [](FWorldActionEntry& E, const FString& Word, int32 Number) { E.Intent = FString::Printf(TEXT("%s_%s%d"), *E.Intent, *Word, Number); });
+        BenchRegistry(*Writer, TEXT("world"), SyntheticWorld, Corpus, Passes, K);
+    }
+    Writer->WriteArrayEnd();
+
+    Writer->WriteObjectEnd();
+    Writer->Close();
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(OutputPath), true);
+    if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+    {
+        UE_LOG(LogACERetrievalBench, Error, TEXT("Could not write %s"), *OutputPath);
+        return 1;
+    }
+    UE_LOG(LogACERetrievalBench, Display, TEXT("Wrote %s"), *OutputPath);
+    return 0;
+}
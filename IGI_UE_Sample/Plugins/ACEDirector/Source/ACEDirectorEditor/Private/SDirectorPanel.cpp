@@ -12,17 +12,65 @@
 #include "Widgets/Layout/SExpandableArea.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Layout/SSpacer.h"
+#include "Widgets/Views/SListView.h"
+#include "Widgets/Views/STableRow.h"
+#include "Widgets/Text/STextBlock.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
+#include "Framework/Application/SlateApplication.h"
 
 #include "Modules/ModuleManager.h"
 #include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/GameInstance.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
 
 #include "CommandRouterComponent.h"
 #include "PlannerListener.h"
 #include "MicCaptureComponent.h"
+#include "ACEConsoleTool.h"
+#include "WorldSnapshot.h"
 #include "IGIModule.h"
 #include "IGIASR.h"
 
+DEFINE_LOG_CATEGORY_STATIC(LogACEDirectorPanel, Log, All);
+
+static TAutoConsoleVariable<int32> CVarACE_SuggestDebounceMs(
+    TEXT("ace.Suggest.DebounceMs"),
+    75,
+    TEXT("Director panel type-ahead: milliseconds without typing before suggestions are looked up."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarACE_SuggestBudgetMs(
+    TEXT("ace.Suggest.BudgetMs"),
+    1.0f,
+    TEXT("Director panel type-ahead: time a lookup may spend gathering suggestions, in milliseconds. It runs off the ")
+    TEXT("game thread; when the budget runs out it returns what it has."),
+    ECVF_Default);
+
+static constexpr int32 MaxDirectorSuggestions = 8;
+
+// True when the intent's ArgsSchemaJson ({"<arg>": {"type", "required", ...}, ...}) marks any arg
+// required; such an intent cannot run from its name alone.
+static bool HasRequiredArgs(FStringView SchemaJson)
+{
+    TSharedPtr<FJsonObject> Schema;
+    if (SchemaJson.IsEmpty() || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::CreateFromView(SchemaJson), Schema) || !Schema.IsValid())
+    {
+        return false;
+    }
+    for (const TPair<FString, TSharedPtr<FJsonValue>>& Arg : Schema->Values)
+    {
+        bool bRequired = false;
+        if (Arg.Value.IsValid() && Arg.Value->Type == EJson::Object && Arg.Value->AsObject()->TryGetBoolField(TEXT("required"), bRequired) && bRequired)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 static FString TimeStamp()
 {
     return FDateTime::Now().ToString(TEXT("%H:%M:%S"));
@@ -144,10 +192,30 @@ void SDirectorPanel::Construct(const FArguments& InArgs)
                                             SAssignNew(PromptBox, SMultiLineEditableTextBox)
                                                 .HintText(FText::FromString(TEXT("Type or say a directive...")))
                                                 .AutoWrapText(true)
+                                                .OnTextChanged(this, &SDirectorPanel::OnPromptChanged)
                                         ]
                                 ]
                         ]
 
+                    // Type-ahead suggestions; picking one sends without the planner
+                    + SVerticalBox::Slot()
+                        .AutoHeight()
+                        [
+                            SNew(SBox)
+                                .MaxDesiredHeight(160.0f)
+                                .Visibility_Lambda([this]()
+                                    {
+                                        return Suggestions.Num() > 0 ? EVisibility::Visible : EVisibility::Collapsed;
+                                    })
+                                [
+                                    SAssignNew(SuggestionList, SListView<FSuggestionPtr>)
+                                        .ListItemsSource(&Suggestions)
+                                        .SelectionMode(ESelectionMode::Single)
+                                        .OnGenerateRow(this, &SDirectorPanel::OnGenerateSuggestionRow)
+                                        .OnMouseButtonClick(this, &SDirectorPanel::AcceptSuggestion)
+                                ]
+                        ]
+
                     + SVerticalBox::Slot()
                         .AutoHeight()
                         .Padding(0, 4)
@@ -322,11 +390,261 @@ FReply SDirectorPanel::OnSendClicked()
         return FReply::Handled();
     }
 
+    ClearSuggestions();
+    if (Accepted.IsValid() && SendAccepted(Prompt, Router, RuntimeTarget))
+    {
+        return FReply::Handled();
+    }
+
     Router->RouteFromText(Prompt, RuntimeTarget);
     AppendLog(FString::Printf(TEXT(">> %s"), *Prompt));
     return FReply::Handled();
 }
 
+bool SDirectorPanel::SendAccepted(const FString& Prompt, UCommandRouterComponent* Router, AActor* RuntimeTarget)
+{
+    // An accepted suggestion already says what to run, so retrieval and the planner are skipped.
+    const FSuggestionPtr Item = MoveTemp(Accepted);
+    Accepted.Reset();
+
+    if (Item->bConsole)
+    {
+        // The command name, optionally followed by arguments the user typed after accepting it. The
+        // suggestion may come from the complete registry and the arguments are free text, so it runs
+        // only when the router's own exact-command check accepts it (curated command, arguments that
+        // fit); anything else goes to the planner.
+        const int32 NameLen = Item->Text.Len();
+        if (!Prompt.StartsWith(Item->Text, ESearchCase::IgnoreCase) || (Prompt.Len() > NameLen && !FChar::IsWhitespace(Prompt[NameLen])))
+        {
+            return false;
+        }
+        UGameInstance* GI = RuntimeTarget->GetGameInstance();
+        const UACEConsoleCommandRegistry* RC = GI ? GI->GetSubsystem<UACEConsoleCommandRegistry>() : nullptr;
+        FString CommandLine;
+        if (!RC || !RC->MatchExactCommand(Prompt, CommandLine))
+        {
+            return false;
+        }
+        UACEConsoleTool::Execute(Router, CommandLine);
+    }
+    else
+    {
+        // Only an ungated intent with nothing to fill in skips the planner. Required args need the
+        // planner to fill them, and the router re-checks "requires:" tags against the target now.
+        if (Item->bNeedsRouter || !Prompt.Equals(Item->Text, ESearchCase::IgnoreCase))
+        {
+            return false;
+        }
+        FACECommand Command;
+        Command.intent = Item->Text;
+        Router->RouteCommand(Command, RuntimeTarget);
+    }
+
+    AppendLog(FString::Printf(TEXT(">> %s (suggestion; planner skipped)"), *Prompt));
+    return true;
+}
+
+void SDirectorPanel::OnPromptChanged(const FText& NewText)
+{
+    if (bSettingPrompt)
+    {
+        return;
+    }
+
+    // An accepted suggestion holds only while the prompt still starts with it.
+    if (Accepted.IsValid() && !NewText.ToString().TrimStart().StartsWith(Accepted->Text, ESearchCase::IgnoreCase))
+    {
+        Accepted.Reset();
+    }
+
+    // Keystrokes only stamp the time; the lookup runs once typing pauses.
+    ++SuggestGeneration;
+    LastEditTime = FPlatformTime::Seconds();
+    if (!SuggestTimer.IsValid())
+    {
+        const float Period = FMath::Max(1, CVarACE_SuggestDebounceMs.GetValueOnGameThread()) / 1000.0f;
+        SuggestTimer = RegisterActiveTimer(Period, FWidgetActiveTimerDelegate::CreateSP(this, &SDirectorPanel::OnSuggestTimer));
+    }
+}
+
+EActiveTimerReturnType SDirectorPanel::OnSuggestTimer(double InCurrentTime, float InDeltaTime)
+{
+    const double Debounce = FMath::Max(1, CVarACE_SuggestDebounceMs.GetValueOnGameThread()) / 1000.0;
+    if (FPlatformTime::Seconds() - LastEditTime < Debounce)
+    {
+        return EActiveTimerReturnType::Continue;
+    }
+
+    SuggestTimer.Reset();
+    RequestSuggestions();
+    return EActiveTimerReturnType::Stop;
+}
+
+void SDirectorPanel::RequestSuggestions()
+{
+    const FString Prefix = PromptBox.IsValid() ? PromptBox->GetText().ToString().TrimStart() : FString();
+    int32 NewLine = INDEX_NONE;
+    if (Prefix.IsEmpty() || Prefix.FindChar(TEXT('\n'), NewLine))
+    {
+        ClearSuggestions();
+        return;
+    }
+
+    // The registries live in the PIE GameInstance. Only their snapshots are handed to the lookup
+    // task, so ending PIE while it runs is fine.
+    UGameInstance* GI = (GEditor && GEditor->PlayWorld) ? GEditor->PlayWorld->GetGameInstance() : nullptr;
+    UACEConsoleCommandRegistry* RC = GI ? GI->GetSubsystem<UACEConsoleCommandRegistry>() : nullptr;
+    UACEWorldActionRegistry* RW = GI ? GI->GetSubsystem<UACEWorldActionRegistry>() : nullptr;
+    UACEConsoleCommandRegistry::FSnapshots ConsoleSnapshots = RC ? RC->PinSnapshots() : UACEConsoleCommandRegistry::FSnapshots();
+    FWorldActionHits::FDataPtr WorldSnapshot;
+    FACERetrievalFilter WorldFilter;
+    if (RW)
+    {
+        WorldSnapshot = RW->PinSnapshot();
+
+        // Same context gating as RouteFromText, so the list never offers an action the router
+        // would filter out for this target.
+        UWorldSnapshot* Snapshotter = GI->GetSubsystem<UWorldSnapshot>();
+        AActor* RuntimeTarget = ResolveRuntimeActor();
+        if (Snapshotter && RuntimeTarget && RW->UsesContextTags())
+        {
+            WorldFilter = UWorldSnapshot::MakeRetrievalFilter(Snapshotter->BuildSnapshot(RuntimeTarget));
+        }
+    }
+    if (ConsoleSnapshots.Num() == 0 && !WorldSnapshot.IsValid())
+    {
+        ClearSuggestions();
+        return;
+    }
+
+    const double Budget = FMath::Max(0.f, CVarACE_SuggestBudgetMs.GetValueOnGameThread()) / 1000.0;
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+        [WeakPanel = TWeakPtr<SDirectorPanel>(SharedThis(this)), Generation = SuggestGeneration, Prefix,
+        ConsoleSnapshots = MoveTemp(ConsoleSnapshots), WorldSnapshot = MoveTemp(WorldSnapshot), WorldFilter = MoveTemp(WorldFilter), Budget]()
+        {
+            const double Start = FPlatformTime::Seconds();
+            FConsoleHits ConsoleHits;
+            FWorldActionHits WorldHits;
+            // Console gets the first half of the budget, world actions whatever is left of the whole,
+            // so neither can starve the other.
+            UACEConsoleCommandRegistry::Suggest(ConsoleSnapshots, Prefix, MaxDirectorSuggestions, Start + Budget * 0.5, ConsoleHits);
+            UACEWorldActionRegistry::Suggest(WorldSnapshot, Prefix, WorldFilter, MaxDirectorSuggestions, Start + Budget, WorldHits);
+
+            // Both lists are best first; interleave them by score.
+            TArray<FSuggestionPtr> Rows;
+            int32 c = 0;
+            int32 w = 0;
+            while (Rows.Num() < MaxDirectorSuggestions && (c < ConsoleHits.Num() || w < WorldHits.Num()))
+            {
+                FSuggestionPtr Row = MakeShared<FSuggestion>();
+                if (w < WorldHits.Num() && (c >= ConsoleHits.Num() || WorldHits.GetScore(w) >= ConsoleHits.GetScore(c)))
+                {
+                    const FWorldActionEntry& E = WorldHits.GetEntry(w);
+                    Row->Text = E.Intent;
+                    Row->bTakesArgs = HasRequiredArgs(WorldHits.GetText(w).Get(TACERetrievalTraits<FWorldActionEntry>::ColdArgsSchemaJson));
+                    Row->bNeedsRouter = Row->bTakesArgs
+                        || E.Tags.ContainsByPredicate([](const FString& Tag) { return Tag.StartsWith(FACETagIndex::RequirePrefix, ESearchCase::IgnoreCase); });
+                    Row->Hint = Row->bTakesArgs ? FString(TEXT("world action (args)")) : FString(TEXT("world action"));
+                    ++w;
+                }
+                else
+                {
+                    const FConsoleCommandEntry& E = ConsoleHits.GetEntry(c++);
+                    Row->Text = E.Name;
+                    Row->Hint = E.ArgNames.IsEmpty() ? FString(TEXT("console")) : E.ArgNames;
+                    Row->bConsole = true;
+                    Row->bTakesArgs = !E.ArgNames.IsEmpty();
+                }
+                Rows.Add(MoveTemp(Row));
+            }
+
+            const double Elapsed = FPlatformTime::Seconds() - Start;
+            UE_CLOG(Elapsed > Budget, LogACEDirectorPanel, Verbose, TEXT("Suggestions for \"%s\" took %.2f ms (budget %.2f ms)"),
+                *Prefix, Elapsed * 1000.0, Budget * 1000.0);
+
+            AsyncTask(ENamedThreads::GameThread, [WeakPanel, Generation, Rows = MoveTemp(Rows)]() mutable
+                {
+                    if (const TSharedPtr<SDirectorPanel> Panel = WeakPanel.Pin())
+                    {
+                        Panel->ApplySuggestions(Generation, MoveTemp(Rows));
+                    }
+                });
+        });
+}
+
+void SDirectorPanel::ApplySuggestions(uint32 Generation, TArray<FSuggestionPtr>&& Rows)
+{
+    if (Generation != SuggestGeneration)
+    {
+        return;
+    }
+
+    Suggestions = MoveTemp(Rows);
+    if (SuggestionList.IsValid())
+    {
+        SuggestionList->RequestListRefresh();
+    }
+}
+
+void SDirectorPanel::ClearSuggestions()
+{
+    ++SuggestGeneration;
+    if (SuggestTimer.IsValid())
+    {
+        UnRegisterActiveTimer(SuggestTimer.ToSharedRef());
+        SuggestTimer.Reset();
+    }
+    if (Suggestions.Num() == 0)
+    {
+        return;
+    }
+
+    Suggestions.Reset();
+    if (SuggestionList.IsValid())
+    {
+        SuggestionList->RequestListRefresh();
+    }
+}
+
+TSharedRef<ITableRow> SDirectorPanel::OnGenerateSuggestionRow(FSuggestionPtr Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(STableRow<FSuggestionPtr>, OwnerTable)
+        [
+            SNew(SHorizontalBox)
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                [
+                    SNew(STextBlock)
+                        .Text(FText::FromString(Item->Text))
+                ]
+                + SHorizontalBox::Slot()
+                .FillWidth(1.f)
+                .Padding(8, 0, 0, 0)
+                [
+                    SNew(STextBlock)
+                        .Text(FText::FromString(Item->Hint))
+                        .ColorAndOpacity(FSlateColor::UseSubduedForeground())
+                ]
+        ];
+}
+
+void SDirectorPanel::AcceptSuggestion(FSuggestionPtr Item)
+{
+    if (!Item.IsValid() || !PromptBox.IsValid())
+    {
+        return;
+    }
+
+    {
+        // Commands that take arguments get a trailing space to type them after.
+        TGuardValue<bool> Guard(bSettingPrompt, true);
+        PromptBox->SetText(FText::FromString(Item->bTakesArgs ? Item->Text + TEXT(" ") : Item->Text));
+    }
+    Accepted = Item;
+    ClearSuggestions();
+    FSlateApplication::Get().SetKeyboardFocus(PromptBox);
+}
+
 FReply SDirectorPanel::OnPushToTalkClicked()
 {
     AActor* Target = TargetActor.Get();
@@ -0,0 +1,22 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ACECompileRegistryCommandlet.generated.h"
+
+// Bakes ACE/data/*.json (including the optional complete console tier) into the compiled registry
+// blob loaded by the runtime registries. Every cook runs the same compile when it starts (see
+// FACEDirectorEditorModule), so packaged builds never stage a blob older than its JSON.
+// Usage: UnrealEditor-Cmd <Project> -run=ACECompileRegistry [-output=<path>]
+UCLASS()
+class ACEDIRECTOREDITOR_API UACECompileRegistryCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+public:
+    UACECompileRegistryCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+    // Parses the registry JSON and writes the blob to OutputPath. Logs an error and returns false
+    // when a source does not parse or the blob cannot be written.
+    static bool CompileRegistry(const FString& OutputPath);
+};
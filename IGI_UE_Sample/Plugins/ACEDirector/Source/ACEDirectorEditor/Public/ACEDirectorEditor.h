@@ -6,6 +6,8 @@
 #include "Modules/ModuleManager.h"
 #include "Modules/ModuleInterface.h"
 
+namespace UE::Cook { class ICookInfo; }
+
 class FACEDirectorEditorModule : public IModuleInterface
 {
 public:
@@ -16,8 +18,10 @@ public:
 
 private:
 	void RegisterMenus();
+	void OnCookStarted(UE::Cook::ICookInfo& CookInfo);
 	TSharedRef<class SDockTab> OnSpawnTab(const class FSpawnTabArgs& Args);
 
 private:
 	TSharedPtr<class FUICommandList> CommandList;
+	FDelegateHandle CookStartedHandle;
 };
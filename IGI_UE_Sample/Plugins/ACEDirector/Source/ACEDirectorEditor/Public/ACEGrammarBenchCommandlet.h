@@ -0,0 +1,24 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ACEGrammarBenchCommandlet.generated.h"
+
+// Per-query grammar benchmark, engine half. For each -k, retrieves K console and K world candidates
+// per directive of the corpus and builds the grammar both flat and trie-factored
+// (ace.Grammar.FactorCandidates), and the JSON Schema, timing each build. Writes them with a sample
+// output they must accept, plus manifest.json, to -output. ACE/bench/grammar_bench.py then measures
+// what the structured-output backend pays for them: compile time and per-token mask cost, which is
+// what ace.Planner.Constraint should be chosen by.
+// The world registry is padded with renamed copies of its entries when it has fewer than K.
+// Usage: UnrealEditor-Cmd <Project> -run=ACEGrammarBench -nullrhi [-k=3,16,64]
+//        [-corpus=<ACE/bench/directives.txt>] [-passes=5]
+//        [-output=<Saved/ACE/Bench/GrammarBench-<time>>]
+UCLASS()
+class ACEDIRECTOREDITOR_API UACEGrammarBenchCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+public:
+    UACEGrammarBenchCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ACEHnswBenchCommandlet.generated.h"
+
+// Measures HNSW recall@K against the brute-force dense scan over the registry text, padded with
+// synthetic entries up to -docs, and reports the smallest ef that meets -target. The ef sweep
+// (recall@K and latency per ef) is written as JSON so runs can be compared.
+// Usage: UnrealEditor-Cmd <Project> -run=ACEHnswBench [-docs=50000] [-queries=500] [-k=5]
+//        [-m=<ace.Hnsw.M>] [-efc=<ace.Hnsw.EfConstruction>] [-target=0.95]
+//        [-output=<Saved/ACE/Bench/HnswBench-<time>.json>]
+UCLASS()
+class ACEDIRECTOREDITOR_API UACEHnswBenchCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+public:
+    UACEHnswBenchCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
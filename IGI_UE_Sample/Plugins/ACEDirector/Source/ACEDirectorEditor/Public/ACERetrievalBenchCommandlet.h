@@ -0,0 +1,24 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ACERetrievalBenchCommandlet.generated.h"
+
+// Headless retrieval benchmark. Builds console and world-action registries at each of -sizes
+// (the real entries padded with synthetic ones), replays the directive corpus against them under
+// every ace.RetrievalMode, and writes p50/p99 latency, allocations per query (when the build routes
+// them through GMalloc; the JSON names the allocator and says whether they were counted), index
+// bytes and build time as JSON. Also reports how much memory compressed doc/schema/example storage saves on
+// the shipped registry files (console_registry_complete.json included). Needs no GPU; run with
+// -nullrhi on build machines.
+// Usage: UnrealEditor-Cmd <Project> -run=ACERetrievalBench -nullrhi [-sizes=1000,10000,100000]
+//        [-corpus=<ACE/bench/directives.txt>] [-passes=5] [-k=5]
+//        [-output=<Saved/ACE/Bench/RetrievalBench-<time>.json>]
+UCLASS()
+class ACEDIRECTOREDITOR_API UACERetrievalBenchCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+public:
+    UACERetrievalBenchCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -6,6 +6,9 @@ class UCommandRouterComponent;
 class UPlannerListener;
 class UMicCaptureComponent;
 class SMultiLineEditableTextBox;
+class ITableRow;
+class STableViewBase;
+template<typename ItemType> class SListView;
 
 class SDirectorPanel : public SCompoundWidget
 {
@@ -34,6 +37,26 @@ private:
 
     bool IsLikelyGPTLog(const FString& Msg, const FName& Category) const;
 
+    // Type-ahead: what accepting a row puts in the prompt, and how Send then runs it.
+    struct FSuggestion
+    {
+        FString Text;       // console command name or world intent
+        FString Hint;
+        bool bConsole = false;
+        bool bTakesArgs = false;
+        bool bNeedsRouter = false;  // world intent with required args or "requires:" tags
+    };
+    using FSuggestionPtr = TSharedPtr<FSuggestion>;
+
+    void OnPromptChanged(const FText& NewText);
+    EActiveTimerReturnType OnSuggestTimer(double InCurrentTime, float InDeltaTime);
+    void RequestSuggestions();
+    void ApplySuggestions(uint32 Generation, TArray<FSuggestionPtr>&& Rows);
+    void ClearSuggestions();
+    TSharedRef<ITableRow> OnGenerateSuggestionRow(FSuggestionPtr Item, const TSharedRef<STableViewBase>& OwnerTable);
+    void AcceptSuggestion(FSuggestionPtr Item);
+    bool SendAccepted(const FString& Prompt, UCommandRouterComponent* Router, AActor* RuntimeTarget);
+
 private:
     TWeakObjectPtr<AActor> TargetActor;
 
@@ -42,6 +65,14 @@ private:
     TSharedPtr<SMultiLineEditableTextBox> LogBox;
     TSharedPtr<SMultiLineEditableTextBox> DebugBox;
 
+    TSharedPtr<SListView<FSuggestionPtr>> SuggestionList;
+    TArray<FSuggestionPtr> Suggestions;
+    FSuggestionPtr Accepted;
+    TSharedPtr<FActiveTimerHandle> SuggestTimer;
+    double LastEditTime = 0.0;
+    uint32 SuggestGeneration = 0;   // bumped per edit; older lookups are dropped
+    bool bSettingPrompt = false;
+
     bool bIsRecording = false;
 
     FString LogBuffer;
@@ -41,6 +41,11 @@ public class ACEDirectorRuntime : ModuleRules
                 "IGI"
             }
 			);
+
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("DirectoryWatcher");
+		}
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(
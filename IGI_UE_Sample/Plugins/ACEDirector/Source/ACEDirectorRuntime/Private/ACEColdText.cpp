@@ -0,0 +1,157 @@
+#include "ACEColdText.h"
+#include "ACEStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Compression.h"
+#include "Misc/ScopeLock.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cold text frames inflated"), STAT_ACE_ColdTextInflates, STATGROUP_ACE);
+
+static TAutoConsoleVariable<bool> CVarACE_CompressRegistryText(
+    TEXT("ace.CompressRegistryText"),
+    true,
+    TEXT("Keep registry docs, argument schemas and examples compressed, inflating them only for the candidates packed into ")
+    TEXT("a prompt. Read when a registry loads."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarACE_ColdTextCacheFrames(
+    TEXT("ace.ColdTextCacheFrames"),
+    8,
+    TEXT("Inflated frames of compressed registry text kept per registry. Each frame holds the docs, schemas and examples of ")
+    TEXT("32 entries."),
+    ECVF_Default);
+
+bool ACEColdText::IsEnabled()
+{
+    return CVarACE_CompressRegistryText.GetValueOnAnyThread();
+}
+
+void FACEColdTextStore::Build(int32 NumEntries, int32 InNumFields, TFunctionRef<FStringView(int32 Entry, int32 Field)> GetField)
+{
+    {
+        FScopeLock Lock(&CacheLock);
+        Cache.Reset();
+    }
+    NumFields = FMath::Max(0, InNumFields);
+    NumStoredEntries = 0;
+    RawBytes = 0;
+    Compressed.Reset();
+    Frames.Reset();
+    FieldStart.Reset();
+    if (NumEntries <= 0 || NumFields == 0) return;
+
+    FieldStart.Reserve(NumEntries * (NumFields + 1));
+    Frames.Reserve((NumEntries + EntriesPerFrame - 1) / EntriesPerFrame);
+    TArray<TCHAR> Raw;
+    TArray<uint8> Scratch;
+    for (int32 First = 0; First < NumEntries; First += EntriesPerFrame)
+    {
+        Raw.Reset();
+        const int32 Last = FMath::Min(NumEntries, First + EntriesPerFrame);
+        for (int32 Entry = First; Entry < Last; ++Entry)
+        {
+            for (int32 Field = 0; Field < NumFields; ++Field)
+            {
+                FieldStart.Add(Raw.Num());
+                const FStringView Text = GetField(Entry, Field);
+                Raw.Append(Text.GetData(), Text.Len());
+                if (Text.Len() > 0) RawBytes += (Text.Len() + 1) * sizeof(TCHAR);
+            }
+            FieldStart.Add(Raw.Num());
+        }
+
+        FFrame& Frame = Frames.AddDefaulted_GetRef();
+        Frame.Offset = Compressed.Num();
+        Frame.NumChars = Raw.Num();
+        const int32 RawSize = Raw.Num() * sizeof(TCHAR);
+        int32 Size = FCompression::CompressMemoryBound(NAME_Oodle, RawSize);
+        Scratch.SetNumUninitialized(Size, EAllowShrinking::No);
+        Frame.bCompressed = RawSize > 0
+            && FCompression::CompressMemory(NAME_Oodle, Scratch.GetData(), Size, Raw.GetData(), RawSize)
+            && Size < RawSize;
+        if (Frame.bCompressed)
+        {
+            Compressed.Append(Scratch.GetData(), Size);
+        }
+        else
+        {
+            // Tiny frames can grow; keep those as they are.
+            Size = RawSize;
+            Compressed.Append(reinterpret_cast<const uint8*>(Raw.GetData()), RawSize);
+        }
+        Frame.Size = Size;
+    }
+
+    NumStoredEntries = NumEntries;
+    Compressed.Shrink();
+    FieldStart.Shrink();
+}
+
+FACEColdText FACEColdTextStore::Get(int32 Entry) const
+{
+    FACEColdText Out;
+    if (Entry < 0 || Entry >= NumStoredEntries) return Out;
+
+    Out.Frame = Inflate(Entry / EntriesPerFrame);
+    if (!Out.Frame.IsValid()) return Out;
+
+    const int32* Starts = FieldStart.GetData() + (SIZE_T)Entry * (NumFields + 1);
+    for (int32 Field = 0; Field < NumFields; ++Field)
+    {
+        Out.Fields.Add(FStringView(Out.Frame->GetData() + Starts[Field], Starts[Field + 1] - Starts[Field]));
+    }
+    return Out;
+}
+
+FACEColdTextStore::FFramePtr FACEColdTextStore::Inflate(int32 FrameIndex) const
+{
+    auto FindCached = [this, FrameIndex]() -> FFramePtr
+        {
+            for (int32 i = 0; i < Cache.Num(); ++i)
+            {
+                if (Cache[i].Key != FrameIndex) continue;
+                TPair<int32, FFramePtr> Hit = Cache[i];
+                Cache.RemoveAt(i, 1, EAllowShrinking::No);
+                Cache.Insert(Hit, 0);
+                return Hit.Value;
+            }
+            return nullptr;
+        };
+
+    {
+        FScopeLock Lock(&CacheLock);
+        if (FFramePtr Cached = FindCached()) return Cached;
+    }
+
+    // Inflate outside the lock; a racing thread may do the same frame, and the first one in wins.
+    const FFrame& Frame = Frames[FrameIndex];
+    TSharedPtr<TArray<TCHAR>, ESPMode::ThreadSafe> Chars = MakeShared<TArray<TCHAR>, ESPMode::ThreadSafe>();
+    Chars->SetNumUninitialized(Frame.NumChars);
+    const int32 RawSize = Frame.NumChars * sizeof(TCHAR);
+    if (!Frame.bCompressed)
+    {
+        FMemory::Memcpy(Chars->GetData(), Compressed.GetData() + Frame.Offset, RawSize);
+    }
+    else if (!FCompression::UncompressMemory(NAME_Oodle, Chars->GetData(), RawSize, Compressed.GetData() + Frame.Offset, Frame.Size))
+    {
+        return nullptr;
+    }
+    INC_DWORD_STAT(STAT_ACE_ColdTextInflates);
+
+    FScopeLock Lock(&CacheLock);
+    if (FFramePtr Cached = FindCached()) return Cached;
+    Cache.Insert(TPair<int32, FFramePtr>(FrameIndex, Chars), 0);
+    const int32 Capacity = FMath::Max(1, CVarACE_ColdTextCacheFrames.GetValueOnAnyThread());
+    if (Cache.Num() > Capacity) Cache.SetNum(Capacity, EAllowShrinking::No);
+    return Chars;
+}
+
+SIZE_T FACEColdTextStore::GetAllocatedSize() const
+{
+    SIZE_T Size = Compressed.GetAllocatedSize() + Frames.GetAllocatedSize() + FieldStart.GetAllocatedSize();
+    FScopeLock Lock(&CacheLock);
+    for (const TPair<int32, FFramePtr>& Entry : Cache)
+    {
+        Size += Entry.Value->GetAllocatedSize();
+    }
+    return Size;
+}
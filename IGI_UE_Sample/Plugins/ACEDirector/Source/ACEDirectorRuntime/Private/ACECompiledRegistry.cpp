@@ -0,0 +1,247 @@
+#include "ACECompiledRegistry.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Hash/xxhash.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+static void SerializeEntry(FArchive& Ar, FConsoleCommandEntry& E)
+{
+    Ar << E.Name << E.Aliases << E.Doc << E.Tags << E.ArgNames;
+}
+
+static void SerializeEntry(FArchive& Ar, FWorldActionEntry& E)
+{
+    Ar << E.Intent << E.Aliases << E.Doc << E.Tags;
+    Ar << E.ArgsSchemaJson << E.ArgsSummary << E.ConstraintsSummary << E.ExamplesJson << E.ExamplesSummary;
+}
+
+template<typename EntryType>
+static void WriteEntries(TArray<uint8>& Out, TConstArrayView<EntryType> Entries)
+{
+    FMemoryWriter Ar(Out, /*bIsPersistent=*/true, /*bSetOffset=*/true);
+    int32 Num = Entries.Num();
+    Ar << Num;
+    for (const EntryType& E : Entries)
+    {
+        SerializeEntry(Ar, const_cast<EntryType&>(E));
+    }
+}
+
+template<typename EntryType>
+static bool ReadEntries(const uint8* Begin, const uint8* End, TArray<EntryType>& OutEntries)
+{
+    FMemoryReaderView Ar(MakeArrayView(Begin, (int32)(End - Begin)), /*bIsPersistent=*/true);
+    int32 Num = 0;
+    Ar << Num;
+    if (Ar.IsError() || Num < 0) return false;
+
+    OutEntries.Reset(Num);
+    for (int32 i = 0; i < Num && !Ar.IsError(); ++i)
+    {
+        SerializeEntry(Ar, OutEntries.AddDefaulted_GetRef());
+    }
+    return !Ar.IsError();
+}
+
+FString FACECompiledRegistry::DefaultPath()
+{
+    return FPaths::Combine(FPaths::ProjectContentDir(), TEXT("ACE/Compiled/ACERegistry.acereg"));
+}
+
+FACECompiledRegistry::FSourceStamp FACECompiledRegistry::StampFile(const FString& Path)
+{
+    FSourceStamp Stamp;
+    const FFileStatData Stat = IFileManager::Get().GetStatData(*Path);
+    if (Stat.bIsValid)
+    {
+        Stamp.FileSize = Stat.FileSize;
+        Stamp.TimestampTicks = Stat.ModificationTime.GetTicks();
+    }
+    return Stamp;
+}
+
+void FACECompiledRegistry::Compile(TConstArrayView<FConsoleCommandEntry> ConsoleEntries, TConstArrayView<FWorldActionEntry> WorldEntries, TArray<uint8>& OutBlob,
+    TConstArrayView<FConsoleCommandEntry> CompleteEntries)
+{
+    FHeader Header;
+    Header.ConsoleSource = StampFile(UACEConsoleCommandRegistry::JsonPath());
+    Header.WorldSource = StampFile(UACEWorldActionRegistry::JsonPath());
+    Header.CompleteSource = StampFile(UACEConsoleCommandRegistry::CompleteJsonPath());
+
+    OutBlob.Reset();
+    ACERetrievalBlob::WritePod(OutBlob, Header);
+
+    auto BeginSection = [&](ESection S)
+        {
+            ACERetrievalBlob::Pad16(OutBlob);
+            Header.SectionOffset[(uint32)S] = OutBlob.Num();
+        };
+    auto EndSection = [&](ESection S)
+        {
+            Header.SectionSize[(uint32)S] = OutBlob.Num() - Header.SectionOffset[(uint32)S];
+        };
+
+    TACERetrievalCore<FConsoleCommandEntry> ConsoleIndex;
+    ConsoleIndex.Build(ConsoleEntries);
+    TACERetrievalCore<FWorldActionEntry> WorldIndex;
+    WorldIndex.Build(WorldEntries);
+
+    BeginSection(ESection::ConsoleEntries); WriteEntries(OutBlob, ConsoleEntries); EndSection(ESection::ConsoleEntries);
+    BeginSection(ESection::ConsoleIndex);   ConsoleIndex.Write(OutBlob);           EndSection(ESection::ConsoleIndex);
+    BeginSection(ESection::WorldEntries);   WriteEntries(OutBlob, WorldEntries);   EndSection(ESection::WorldEntries);
+    BeginSection(ESection::WorldIndex);     WorldIndex.Write(OutBlob);             EndSection(ESection::WorldIndex);
+
+    // The complete tier is the largest registry; baking it is what keeps its JSON parse and index
+    // build off startup. Left as empty sections when there is none.
+    BeginSection(ESection::CompleteEntries);
+    if (CompleteEntries.Num() > 0) WriteEntries(OutBlob, CompleteEntries);
+    EndSection(ESection::CompleteEntries);
+    BeginSection(ESection::CompleteIndex);
+    if (CompleteEntries.Num() > 0)
+    {
+        TACERetrievalCore<FConsoleCommandEntry> CompleteIndex;
+        CompleteIndex.Build(CompleteEntries);
+        CompleteIndex.Write(OutBlob);
+    }
+    EndSection(ESection::CompleteIndex);
+
+    Header.ContentHash = FXxHash64::HashBuffer(OutBlob.GetData() + sizeof(Header), OutBlob.Num() - sizeof(Header)).Hash;
+    FMemory::Memcpy(OutBlob.GetData(), &Header, sizeof(Header));
+}
+
+TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe> FACECompiledRegistry::Open(const FString& Path)
+{
+    // Both registry subsystems (and every GameInstance) share one mapping per file.
+    static FCriticalSection OpenLock;
+    static TMap<FString, TWeakPtr<const FACECompiledRegistry, ESPMode::ThreadSafe>> OpenFiles;
+
+    FScopeLock Lock(&OpenLock);
+    if (TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe> Existing = OpenFiles.FindRef(Path).Pin())
+    {
+        // Re-check staleness: a hot reload after a JSON edit must not get the old blob back.
+        return Existing->Validate() ? Existing : nullptr;
+    }
+
+    if (!FPaths::FileExists(Path)) return nullptr;
+
+    TSharedPtr<FACECompiledRegistry, ESPMode::ThreadSafe> Reg = MakeShared<FACECompiledRegistry, ESPMode::ThreadSafe>();
+
+    IPlatformFile& PF = FPlatformFileManager::Get().GetPlatformFile();
+    Reg->MappedHandle.Reset(PF.OpenMapped(*Path));
+    if (Reg->MappedHandle.IsValid())
+    {
+        Reg->MappedRegion.Reset(Reg->MappedHandle->MapRegion(0, Reg->MappedHandle->GetFileSize()));
+    }
+
+    if (Reg->MappedRegion.IsValid())
+    {
+        Reg->Data = Reg->MappedRegion->GetMappedPtr();
+        Reg->Size = Reg->MappedRegion->GetMappedSize();
+    }
+    else
+    {
+        Reg->MappedHandle.Reset();
+        if (!FFileHelper::LoadFileToArray(Reg->LoadedBytes, *Path)) return nullptr;
+        Reg->Data = Reg->LoadedBytes.GetData();
+        Reg->Size = Reg->LoadedBytes.Num();
+    }
+
+    if (!Reg->Validate())
+    {
+        return nullptr;
+    }
+    // Read from the header: hashing the blob here would page in all of it.
+    Reg->ContentHash = reinterpret_cast<const FHeader*>(Reg->Data)->ContentHash;
+
+    UE_LOG(LogACERegistry, Log, TEXT("Opened compiled registry %s (%lld bytes, %s)"),
+        *Path, Reg->Size, Reg->IsMemoryMapped() ? TEXT("mapped") : TEXT("loaded"));
+
+    OpenFiles.Add(Path, Reg);
+    return Reg;
+}
+
+bool FACECompiledRegistry::Validate() const
+{
+    FHeader Header;
+    if (!Data || Size < (int64)sizeof(FHeader) || !IsAligned(Data, 16)) return false;
+    FMemory::Memcpy(&Header, Data, sizeof(Header));
+
+    if (Header.Magic != FileMagic || Header.Version != FileVersion || Header.CharSize != sizeof(TCHAR)
+        || Header.NumSections != (uint32)ESection::Num)
+    {
+        UE_LOG(LogACERegistry, Warning, TEXT("Compiled registry is incompatible (version %u, expected %u); falling back to JSON."),
+            Header.Version, FileVersion);
+        return false;
+    }
+
+    for (uint32 s = 0; s < (uint32)ESection::Num; ++s)
+    {
+        if (Header.SectionOffset[s] < (int64)sizeof(FHeader) || Header.SectionSize[s] < 0
+            || Header.SectionOffset[s] + Header.SectionSize[s] > Size)
+        {
+            return false;
+        }
+    }
+
+#if WITH_EDITOR
+    // Designers edit the JSON directly in editor builds; never serve a blob older than its source.
+    auto IsStale = [](const FSourceStamp& Stamp, const FString& Source)
+        {
+            const FSourceStamp Now = StampFile(Source);
+            return Now.FileSize >= 0 && (Now.FileSize != Stamp.FileSize || Now.TimestampTicks != Stamp.TimestampTicks);
+        };
+    if (IsStale(Header.ConsoleSource, UACEConsoleCommandRegistry::JsonPath()) || IsStale(Header.WorldSource, UACEWorldActionRegistry::JsonPath())
+        || IsStale(Header.CompleteSource, UACEConsoleCommandRegistry::CompleteJsonPath()))
+    {
+        UE_LOG(LogACERegistry, Log, TEXT("Compiled registry is older than its JSON sources; falling back to JSON."));
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool FACECompiledRegistry::GetSection(ESection Section, const uint8*& OutBegin, const uint8*& OutEnd) const
+{
+    FHeader Header;
+    FMemory::Memcpy(&Header, Data, sizeof(Header));
+    OutBegin = Data + Header.SectionOffset[(uint32)Section];
+    OutEnd = OutBegin + Header.SectionSize[(uint32)Section];
+    return true;
+}
+
+template<typename EntryType>
+bool FACECompiledRegistry::LoadSections(ESection EntriesSection, ESection IndexSection, TArray<EntryType>& OutEntries, TACERetrievalCore<EntryType>& OutIndex) const
+{
+    const uint8* Begin = nullptr;
+    const uint8* End = nullptr;
+    if (!GetSection(EntriesSection, Begin, End) || Begin == End || !ReadEntries(Begin, End, OutEntries)) return false;
+    if (!GetSection(IndexSection, Begin, End) || !OutIndex.Attach(Begin, End)) return false;
+    return OutIndex.GetIndex().NumDocs() == OutEntries.Num();
+}
+
+bool FACECompiledRegistry::LoadConsole(TArray<FConsoleCommandEntry>& OutEntries, TACERetrievalCore<FConsoleCommandEntry>& OutIndex) const
+{
+    return LoadSections(ESection::ConsoleEntries, ESection::ConsoleIndex, OutEntries, OutIndex);
+}
+
+bool FACECompiledRegistry::LoadWorld(TArray<FWorldActionEntry>& OutEntries, TACERetrievalCore<FWorldActionEntry>& OutIndex) const
+{
+    return LoadSections(ESection::WorldEntries, ESection::WorldIndex, OutEntries, OutIndex);
+}
+
+bool FACECompiledRegistry::LoadConsoleComplete(TArray<FConsoleCommandEntry>& OutEntries, TACERetrievalCore<FConsoleCommandEntry>& OutIndex) const
+{
+    return LoadSections(ESection::CompleteEntries, ESection::CompleteIndex, OutEntries, OutIndex);
+}
+
+FACECompiledRegistry::~FACECompiledRegistry()
+{
+    // Region before handle.
+    MappedRegion.Reset();
+    MappedHandle.Reset();
+}
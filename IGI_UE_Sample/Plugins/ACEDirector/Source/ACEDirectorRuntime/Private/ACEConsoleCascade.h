@@ -0,0 +1,14 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "ACEConsoleCommandRegistry.h"
+
+// The console cascade's building blocks, shared by UACEConsoleCommandRegistry and its tests.
+
+// Top K hits for Query from Tier's current snapshot, through its cache. Empty while Tier has none.
+void QueryConsoleTier(TACERegistryState<FConsoleCommandEntry>& Tier, FStringView Query, int32 K, const FACERetrievalFilter& Policy, FConsoleHits& Out);
+
+// Out = Curated when it is confident (ace.ConsoleCascade.MinTopScore / MinMargin) or there is no
+// Complete tier; otherwise Curated merged with Complete's hits for Query (raw scores, best K).
+// Curated and Out may be the same list.
+void CascadeConsoleHits(FConsoleHits& Curated, TACERegistryState<FConsoleCommandEntry>* Complete, FStringView Query, int32 K,
+    const FACERetrievalFilter& Policy, FConsoleHits& Out);
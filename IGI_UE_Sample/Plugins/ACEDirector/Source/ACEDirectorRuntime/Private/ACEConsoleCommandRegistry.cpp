@@ -1,98 +1,645 @@
 #include "ACEConsoleCommandRegistry.h"
+#include "ACECompiledRegistry.h"
+#include "ACEConsoleCascade.h"
+#include "ACEJsonStream.h"
+#include "ACEStats.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
-#include "Dom/JsonObject.h"
-#include "Serialization/JsonSerializer.h"
-#include "Serialization/JsonReader.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/IConsoleManager.h"
+#include "Modules/ModuleManager.h"
+#include "String/Find.h"
+
+static TAutoConsoleVariable<int32> CVarACE_ConsoleRegistrySource(
+    TEXT("ace.ConsoleRegistrySource"),
+    0,
+    TEXT("Where the console registry comes from. 0 = curated JSON (or the compiled blob), ")
+    TEXT("1 = live IConsoleManager objects merged with the curated JSON aliases and tags. Read when the GameInstance starts."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarACE_AllowDebugCommands(
+    TEXT("ace.AllowDebugCommands"),
+    !UE_BUILD_SHIPPING,
+    TEXT("When false, console entries tagged \"debug\" are filtered out before retrieval scores anything, ")
+    TEXT("so they never reach the planner's grammar."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarACE_ConsoleCascade(
+    TEXT("ace.ConsoleCascade"),
+    true,
+    TEXT("Also load console_registry_complete.json and search it when the curated registry is not confident about a query ")
+    TEXT("(see ace.ConsoleCascade.MinTopScore and MinMargin). Read when the GameInstance starts; ignored when ace.ConsoleRegistrySource=1."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarACE_ConsoleCascadeMinTopScore(
+    TEXT("ace.ConsoleCascade.MinTopScore"),
+    0.35f,
+    TEXT("The complete console registry is searched when the best curated hit scores below this."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarACE_ConsoleCascadeMinMargin(
+    TEXT("ace.ConsoleCascade.MinMargin"),
+    0.05f,
+    TEXT("The complete console registry is searched when the best curated hit leads the runner-up by less than this."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarACE_ConsoleCascadeAgreementBonus(
+    TEXT("ace.ConsoleCascade.AgreementBonus"),
+    0.1f,
+    TEXT("Added to the score of a command both the curated and the complete registry return when their hits are merged. ")
+    TEXT("In raw retrieval score units; the default is ace.ConsoleCascade.MinMargin doubled, so agreement settles a near tie."),
+    ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Console cascade queries"), STAT_ACE_ConsoleCascadeQueries, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Console cascade complete-registry searches"), STAT_ACE_ConsoleCascadeEscalations, STATGROUP_ACE);
+
+// Live console objects the curated JSON does not describe.
+static const TCHAR* const HarvestedTag = TEXT("harvested");
+
+struct UACEConsoleCommandRegistry::FLiveSource {
+    FCriticalSection Lock;
+    TArray<FConsoleCommandEntry> Harvested;  // latest game-thread harvest, guarded by Lock
+
+    // Parsed curated JSON, reused across rebuilds. Only the loader task touches Curated.
+    TArray<FConsoleCommandEntry> Curated;
+    std::atomic<bool> bCuratedValid{ false };
+};
 
 void UACEConsoleCommandRegistry::Initialize(FSubsystemCollectionBase& Collection) {
-    LoadJSON();
+    if (CVarACE_ConsoleRegistrySource.GetValueOnGameThread() == 1) {
+        Live = MakeShared<FLiveSource, ESPMode::ThreadSafe>();
+        Harvest();
+        // Plugins register console objects as their modules load; pick those up too.
+        ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddWeakLambda(this, [this](FName, EModuleChangeReason Reason) {
+            if (Reason == EModuleChangeReason::ModuleLoaded) ScheduleHarvest();
+        });
+    }
+
+    State = MakeShared<FRegistryState, ESPMode::ThreadSafe>([LiveSource = Live]() {
+        return LiveSource.IsValid() ? LoadLive(*LiveSource) : Load();
+    });
+    State->RequestLoad();
+
+    Watcher.Start(JsonPath(), [WeakState = TWeakPtr<FRegistryState, ESPMode::ThreadSafe>(State), WeakLive = TWeakPtr<FLiveSource, ESPMode::ThreadSafe>(Live)]() {
+        if (auto Pinned = WeakState.Pin()) {
+            UE_LOG(LogACERegistry, Log, TEXT("%s changed; rebuilding console registry."), *JsonPath());
+            if (auto PinnedLive = WeakLive.Pin()) PinnedLive->bCuratedValid.store(false);
+            Pinned->RequestLoad();
+        }
+    });
+
+    // The exhaustive registry is only a fallback tier; the live source already covers it.
+    if (!Live.IsValid() && CVarACE_ConsoleCascade.GetValueOnGameThread() && FPaths::FileExists(CompleteJsonPath())) {
+        CompleteState = MakeShared<FRegistryState, ESPMode::ThreadSafe>(&UACEConsoleCommandRegistry::LoadComplete);
+        CompleteState->RequestLoad();
+        CompleteWatcher.Start(CompleteJsonPath(), [WeakComplete = TWeakPtr<FRegistryState, ESPMode::ThreadSafe>(CompleteState)]() {
+            if (auto Pinned = WeakComplete.Pin()) {
+                UE_LOG(LogACERegistry, Log, TEXT("%s changed; rebuilding complete console registry."), *CompleteJsonPath());
+                Pinned->RequestLoad();
+            }
+        });
+    }
 }
 
-static FString RegPathJSON() { return FPaths::Combine(FPaths::ProjectDir(), TEXT("ACE/data/console_registry.json")); }
+void UACEConsoleCommandRegistry::Deinitialize() {
+    Watcher.Stop();
+    CompleteWatcher.Stop();
+    FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+    FTSTicker::GetCoreTicker().RemoveTicker(HarvestTickHandle);
+    HarvestTickHandle.Reset();
+    Live.Reset();
+    State.Reset();
+    CompleteState.Reset();
+}
 
-bool UACEConsoleCommandRegistry::LoadJSON() {
-    FString Raw;
-    if (!FPaths::FileExists(RegPathJSON()) || !FFileHelper::LoadFileToString(Raw, *RegPathJSON())) return false;
+void UACEConsoleCommandRegistry::ScheduleHarvest() {
+    // Modules load in bursts; harvest once on the next tick.
+    if (HarvestTickHandle.IsValid()) return;
+    HarvestTickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float) {
+        HarvestTickHandle.Reset();
+        Harvest();
+        if (State.IsValid()) State->RequestLoad();
+        return false;
+    }));
+}
 
-    TSharedPtr<FJsonValue> RootVal;
-    auto Reader = TJsonReaderFactory<>::Create(Raw);
-    if (!FJsonSerializer::Deserialize(Reader, RootVal) || !RootVal.IsValid() || RootVal->Type != EJson::Array) return false;
+void UACEConsoleCommandRegistry::Harvest() {
+    check(IsInGameThread());
+    const double Start = FPlatformTime::Seconds();
 
-    const auto& Arr = RootVal->AsArray();
-    Entries.Reset();
-    for (const auto& V : Arr) {
-        if (!V.IsValid() || V->Type != EJson::Object) continue;
-        const auto& O = V->AsObject();
+    TArray<FConsoleCommandEntry> Harvested;
+    IConsoleManager::Get().ForEachConsoleObjectThatStartsWith(FConsoleObjectVisitor::CreateLambda([&Harvested](const TCHAR* Name, IConsoleObject* Obj) {
+        if (!Obj || Obj->TestFlags(ECVF_Unregistered)) return;
         FConsoleCommandEntry E;
-        O->TryGetStringField(TEXT("name"), E.Name);
-        O->TryGetStringField(TEXT("doc"), E.Doc);
-        O->TryGetStringField(TEXT("argNames"), E.ArgNames);
+        E.Name = Name;
+        E.Doc = FString(Obj->GetHelp()).TrimStartAndEnd();
+        const bool bVariable = Obj->AsVariable() != nullptr;
+        E.Tags.Add(bVariable ? TEXT("cvar") : TEXT("command"));
+        int32 Dot = INDEX_NONE;
+        if (E.Name.FindChar(TEXT('.'), Dot) && Dot > 0) E.Tags.Add(E.Name.Left(Dot).ToLower());
+        if (bVariable) E.ArgNames = TEXT("value");
+        Harvested.Add(MoveTemp(E));
+    }), TEXT(""));
+
+    UE_LOG(LogACERegistry, Log, TEXT("Harvested %d console objects on the game thread in %.1f ms"),
+        Harvested.Num(), (FPlatformTime::Seconds() - Start) * 1000.0);
+
+    FScopeLock Lock(&Live->Lock);
+    Live->Harvested = MoveTemp(Harvested);
+}
+
+TSharedPtr<const UACEConsoleCommandRegistry::FRegistryData, ESPMode::ThreadSafe> UACEConsoleCommandRegistry::LoadLive(FLiveSource& Source) {
+    const double Start = FPlatformTime::Seconds();
+
+    TSharedPtr<FRegistryData, ESPMode::ThreadSafe> Loaded = MakeShared<FRegistryData, ESPMode::ThreadSafe>();
+    {
+        FScopeLock Lock(&Source.Lock);
+        Loaded->Entries = Source.Harvested;
+    }
+
+    if (!Source.bCuratedValid.exchange(true)) {
+        FString Raw;
+        Source.Curated.Reset();
+        if (FFileHelper::LoadFileToString(Raw, *JsonPath())) ParseJSON(Raw, Source.Curated);
+    }
+    const double CuratedDone = FPlatformTime::Seconds();
+
+    // Curated metadata wins for objects that exist; curated-only entries (Exec handlers such as
+    // "stat fps" are not console objects) are kept as they are.
+    TMap<FString, int32> CuratedByName;
+    CuratedByName.Reserve(Source.Curated.Num());
+    for (int32 i = 0; i < Source.Curated.Num(); ++i) CuratedByName.Add(Source.Curated[i].Name, i);
+
+    TBitArray<> CuratedUsed(false, Source.Curated.Num());
+    const int32 NumLive = Loaded->Entries.Num();
+    for (FConsoleCommandEntry& E : Loaded->Entries) {
+        const int32* Found = CuratedByName.Find(E.Name);
+        // Nobody vetted these for the planner-free path; see MatchExactCommand.
+        if (!Found) { E.Tags.Add(HarvestedTag); continue; }
+        const FConsoleCommandEntry& C = Source.Curated[*Found];
+        CuratedUsed[*Found] = true;
+        E.Aliases = C.Aliases;
+        for (const FString& Tag : C.Tags) E.Tags.AddUnique(Tag);
+        if (!C.Doc.IsEmpty()) E.Doc = C.Doc;
+        if (!C.ArgNames.IsEmpty()) E.ArgNames = C.ArgNames;
+    }
+    for (int32 i = 0; i < Source.Curated.Num(); ++i) {
+        if (!CuratedUsed[i]) Loaded->Entries.Add(Source.Curated[i]);
+    }
+    const double MergeDone = FPlatformTime::Seconds();
+
+    if (Loaded->Entries.Num() == 0) return nullptr;
+    Loaded->Index.Build(Loaded->Entries);
+    Loaded->CompactText(TEXT("Console"));
+    const double IndexDone = FPlatformTime::Seconds();
+
+    UE_LOG(LogACERegistry, Log, TEXT("Console registry (live): %d commands (%d live, %d curated-only); curated JSON %.1f ms, merge %.1f ms, index %.1f ms"),
+        Loaded->Entries.Num(), NumLive, Loaded->Entries.Num() - NumLive,
+        (CuratedDone - Start) * 1000.0, (MergeDone - CuratedDone) * 1000.0, (IndexDone - MergeDone) * 1000.0);
+    return Loaded;
+}
 
-        const TArray<TSharedPtr<FJsonValue>>* Ali = nullptr; if (O->TryGetArrayField(TEXT("aliases"), Ali)) for (auto& x : *Ali) if (x.IsValid()) E.Aliases.Add(x->AsString());
-        const TArray<TSharedPtr<FJsonValue>>* Tags = nullptr; if (O->TryGetArrayField(TEXT("tags"), Tags)) for (auto& x : *Tags) if (x.IsValid()) E.Tags.Add(x->AsString());
+TSharedPtr<const UACEConsoleCommandRegistry::FRegistryData, ESPMode::ThreadSafe> UACEConsoleCommandRegistry::Load() {
+    // Every GameInstance in the process asks for the same files; only the first one parses and
+    // indexes them, the rest share its immutable data through the store.
+    const double Start = FPlatformTime::Seconds();
+    bool bShared = false;
+    const TCHAR* Source = TEXT("compiled blob");
+    TSharedPtr<const FRegistryData, ESPMode::ThreadSafe> Loaded;
+    if (TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe> Compiled = FACECompiledRegistry::Open(FACECompiledRegistry::DefaultPath())) {
+        Loaded = FRegistryStore::FindOrBuild(FACECompiledRegistry::DefaultPath(), Compiled->GetContentHash(), [&Compiled]() {
+            TSharedPtr<FRegistryData, ESPMode::ThreadSafe> Data = MakeShared<FRegistryData, ESPMode::ThreadSafe>();
+            return LoadCompiled(*Data, Compiled) ? Data : nullptr;
+        }, &bShared);
+    }
+    if (!Loaded) {
+        TArray<uint8> Bytes;
+        if (!FPaths::FileExists(JsonPath()) || !FFileHelper::LoadFileToArray(Bytes, *JsonPath())) return nullptr;
+        Source = TEXT("JSON");
+        Loaded = FRegistryStore::FindOrBuild(JsonPath(), FRegistryStore::HashContent(Bytes.GetData(), Bytes.Num()), [&Bytes]() {
+            TSharedPtr<FRegistryData, ESPMode::ThreadSafe> Data = MakeShared<FRegistryData, ESPMode::ThreadSafe>();
+            return LoadJSON(*Data, Bytes) ? Data : nullptr;
+        }, &bShared);
+        if (!Loaded) return nullptr;
+    }
+    UE_LOG(LogACERegistry, Log, TEXT("Console registry: %d commands from %s%s in %.1f ms"),
+        Loaded->Entries.Num(), Source, bShared ? TEXT(" (shared with another GameInstance)") : TEXT(""), (FPlatformTime::Seconds() - Start) * 1000.0);
+    return Loaded;
+}
 
-        if (!E.Name.IsEmpty()) Entries.Add(MoveTemp(E));
+TSharedPtr<const UACEConsoleCommandRegistry::FRegistryData, ESPMode::ThreadSafe> UACEConsoleCommandRegistry::LoadComplete() {
+    // Same order as the curated tier: the baked sections when the blob carries them, JSON otherwise.
+    // The blob is shared with Load(), so the complete tier gets its own store key.
+    const double Start = FPlatformTime::Seconds();
+    bool bShared = false;
+    const TCHAR* Source = TEXT("compiled blob");
+    TSharedPtr<const FRegistryData, ESPMode::ThreadSafe> Loaded;
+    if (TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe> Compiled = FACECompiledRegistry::Open(FACECompiledRegistry::DefaultPath())) {
+        Loaded = FRegistryStore::FindOrBuild(FACECompiledRegistry::DefaultPath() + TEXT("|complete"), Compiled->GetContentHash(), [&Compiled]() {
+            TSharedPtr<FRegistryData, ESPMode::ThreadSafe> Data = MakeShared<FRegistryData, ESPMode::ThreadSafe>();
+            return LoadCompiled(*Data, Compiled, /*bCompleteTier=*/true) ? Data : nullptr;
+        }, &bShared);
+    }
+    if (!Loaded) {
+        TArray<uint8> Bytes;
+        if (!FFileHelper::LoadFileToArray(Bytes, *CompleteJsonPath())) return nullptr;
+        Source = TEXT("JSON");
+        Loaded = FRegistryStore::FindOrBuild(CompleteJsonPath(), FRegistryStore::HashContent(Bytes.GetData(), Bytes.Num()), [&Bytes]() {
+            TSharedPtr<FRegistryData, ESPMode::ThreadSafe> Data = MakeShared<FRegistryData, ESPMode::ThreadSafe>();
+            return LoadJSON(*Data, Bytes) ? Data : nullptr;
+        }, &bShared);
+        if (!Loaded) return nullptr;
     }
-    return Entries.Num() > 0;
+    UE_LOG(LogACERegistry, Log, TEXT("Console registry (complete tier): %d commands from %s%s in %.1f ms"),
+        Loaded->Entries.Num(), Source, bShared ? TEXT(" (shared with another GameInstance)") : TEXT(""), (FPlatformTime::Seconds() - Start) * 1000.0);
+    return Loaded;
 }
 
-// Simple retrieval
-TArray<FString> UACEConsoleCommandRegistry::Tokenize(const FString& S) {
-    FString Lower = S.ToLower();
-    for (TCHAR& c : Lower) if (!FChar::IsAlnum(c)) c = ' ';
-    TArray<FString> Out; Lower.ParseIntoArrayWS(Out);
+FString UACEConsoleCommandRegistry::JsonPath() { return FPaths::Combine(FPaths::ProjectDir(), TEXT("ACE/data/console_registry.json")); }
+FString UACEConsoleCommandRegistry::CompleteJsonPath() { return FPaths::Combine(FPaths::ProjectDir(), TEXT("ACE/data/console_registry_complete.json")); }
+
+bool UACEConsoleCommandRegistry::LoadCompiled(FRegistryData& Out, const TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe>& Compiled, bool bCompleteTier) {
+    Out.Compiled = Compiled;
+    const bool bLoaded = Out.Compiled.IsValid()
+        && (bCompleteTier ? Out.Compiled->LoadConsoleComplete(Out.Entries, Out.Index) : Out.Compiled->LoadConsole(Out.Entries, Out.Index));
+    if (bLoaded) { Out.CompactText(TEXT("Console")); return true; }
+    Out.Compiled.Reset();
+    Out.Entries.Reset();
+    return false;
+}
+
+bool UACEConsoleCommandRegistry::LoadJSON(FRegistryData& Out, const TArray<uint8>& Bytes) {
+    FString Raw;
+    FFileHelper::BufferToString(Raw, Bytes.GetData(), Bytes.Num());
+    if (!ParseJSON(Raw, Out.Entries)) return false;
+    Out.Index.Build(Out.Entries);
+    Out.CompactText(TEXT("Console"));
+    return Out.Entries.Num() > 0;
+}
+
+static bool ReadConsoleEntry(TJsonReader<TCHAR>& Reader, FConsoleCommandEntry& E) {
+    EJsonNotation Notation;
+    while (Reader.ReadNext(Notation)) {
+        if (Notation == EJsonNotation::ObjectEnd) return true;
+        const FString& Key = Reader.GetIdentifier();
+        if (Notation == EJsonNotation::String) {
+            if (Key == TEXT("name")) E.Name = Reader.GetValueAsString();
+            else if (Key == TEXT("doc")) E.Doc = Reader.GetValueAsString();
+            else if (Key == TEXT("argNames")) E.ArgNames = Reader.GetValueAsString();
+        }
+        else if (Notation == EJsonNotation::ArrayStart && Key == TEXT("aliases")) { if (!ACEJsonStream::ReadStringArray(Reader, E.Aliases)) return false; }
+        else if (Notation == EJsonNotation::ArrayStart && Key == TEXT("tags")) { if (!ACEJsonStream::ReadStringArray(Reader, E.Tags)) return false; }
+        else if (!ACEJsonStream::SkipValue(Reader, Notation)) return false;
+    }
+    return false;
+}
+
+bool UACEConsoleCommandRegistry::ParseJSON(const FString& Raw, TArray<FConsoleCommandEntry>& OutEntries) {
+    // Token-level reader: no DOM for the (large) console registry.
+    TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::CreateFromView(Raw);
+    EJsonNotation Notation;
+    if (!Reader->ReadNext(Notation) || Notation != EJsonNotation::ArrayStart) return false;
+
+    OutEntries.Reset();
+    while (Reader->ReadNext(Notation)) {
+        if (Notation == EJsonNotation::ArrayEnd) return true;
+        if (Notation != EJsonNotation::ObjectStart) { if (!ACEJsonStream::SkipValue(*Reader, Notation)) return false; continue; }
+        FConsoleCommandEntry E;
+        if (!ReadConsoleEntry(*Reader, E)) return false;
+        if (!E.Name.IsEmpty()) OutEntries.Add(MoveTemp(E));
+    }
+    return false;
+}
+
+TArray<FConsoleCommandEntry> UACEConsoleCommandRegistry::GetAll() const {
+    if (!State.IsValid()) return {};
+    FRegistryState::FReadScope Snapshot(State->Snapshot);
+    TArray<FConsoleCommandEntry> Out;
+    if (!Snapshot) return Out;
+    Out.Reserve(Snapshot->Entries.Num());
+    for (int32 i = 0; i < Snapshot->Entries.Num(); ++i) Out.Add(Snapshot->CopyEntry(i));
     return Out;
 }
 
-float UACEConsoleCommandRegistry::CosineLike(const TArray<FString>& Q, const TArray<FString>& D) {
-    if (Q.Num() == 0 || D.Num() == 0) return 0.f;
-    TMap<FString, int32> fq, fd;
-    for (auto& t : Q) fq.FindOrAdd(t)++; for (auto& t : D) fd.FindOrAdd(t)++;
-    float dot = 0, n1 = 0, n2 = 0;
-    for (auto& kv : fq) { n1 += kv.Value * kv.Value; dot += kv.Value * (float)fd.FindRef(kv.Key); }
-    for (auto& kv : fd) { n2 += kv.Value * kv.Value; }
-    if (n1 == 0 || n2 == 0) return 0.f;
-    return dot / (FMath::Sqrt(n1) * FMath::Sqrt(n2));
+static FConsoleCandidate MakeConsoleCandidate(const TACERegistryData<FConsoleCommandEntry>& Data, int32 Doc, float Score) {
+    const FConsoleCommandEntry& E = Data.Entries[Doc];
+    FConsoleCandidate C;
+    C.Name = E.Name; C.Aliases = E.Aliases; C.Tags = E.Tags; C.ArgNames = E.ArgNames; C.Score = Score;
+    C.Doc = FString(Data.GetText(Doc).Get(TACERetrievalTraits<FConsoleCommandEntry>::ColdDoc));
+    return C;
+}
+
+// The caller's filter plus what this build allows regardless of caller.
+static FACERetrievalFilter WithConsolePolicy(const FACERetrievalFilter& Filter) {
+    FACERetrievalFilter Out = Filter;
+    if (!CVarACE_AllowDebugCommands.GetValueOnAnyThread()) Out.ExcludeTags.AddUnique(TEXT("debug"));
+    return Out;
+}
+
+void UACEConsoleCommandRegistry::RetrieveTopK(const FString& Query, int32 K, TArray<FConsoleCandidate>& Out) const {
+    RetrieveTopKFiltered(Query, K, FACERetrievalFilter(), Out);
+}
+
+void UACEConsoleCommandRegistry::RetrieveTopKFiltered(const FString& Query, int32 K, const FACERetrievalFilter& Filter, TArray<FConsoleCandidate>& Out) const {
+    Out.Reset();
+    FConsoleHits Hits;
+    RetrieveHits(Query, K, Filter, Hits);
+    Out.Reserve(Hits.Num());
+    for (int32 i = 0; i < Hits.Num(); ++i) Out.Add(MakeConsoleCandidate(Hits.GetData(i), Hits.Hits[i].Doc, Hits.GetScore(i)));
+}
+
+// Curated hits stand when the best one scores well and clearly leads the runner-up.
+static bool IsConsoleTierConfident(const FConsoleHits& Hits) {
+    if (Hits.IsEmpty()) return false;
+    const float Top = Hits.GetScore(0);
+    const float Margin = Hits.Num() > 1 ? Top - Hits.GetScore(1) : Top;
+    return Top >= CVarACE_ConsoleCascadeMinTopScore.GetValueOnAnyThread() && Margin >= CVarACE_ConsoleCascadeMinMargin.GetValueOnAnyThread();
 }
 
-float UACEConsoleCommandRegistry::LexicalBonus(const TArray<FString>& Q, const FConsoleCommandEntry& E) {
-    float bonus = 0.f;
-    // exact command token match gives a big bump
-    for (auto& q : Q) {
-        if (q == E.Name.ToLower()) { bonus += 1.0f; }
+void QueryConsoleTier(TACERegistryState<FConsoleCommandEntry>& Tier, FStringView Query, int32 K, const FACERetrievalFilter& Policy, FConsoleHits& Out) {
+    Out.Reset();
+    TACERegistryState<FConsoleCommandEntry>::FReadScope Snapshot(Tier.Snapshot);
+    if (!Snapshot) return;
+    Out.Hits.SetNumUninitialized(FMath::Max(0, K));
+    Out.Hits.SetNum(Tier.QueryCached(Snapshot, Query, Out.Hits, Policy), EAllowShrinking::No);
+    if (Out.Hits.Num() > 0) Out.Data = Snapshot.Pin();
+}
+
+// A hit in a list merged across registry tiers; Source indexes the tiers' snapshots.
+struct FConsoleTierHit { int32 Doc; float Score; uint8 Source; };
+
+// The best K of Hits, best first, as a multi-source hit list.
+static void EmitConsoleTierHits(TArray<FConsoleTierHit, TInlineAllocator<16>>& Hits, TConstArrayView<FConsoleHits::FDataPtr> Sources, int32 K,
+    FConsoleHits& Out) {
+    Hits.StableSort([](const FConsoleTierHit& A, const FConsoleTierHit& B) { return A.Score > B.Score; });
+    if (Hits.Num() > K) Hits.SetNum(FMath::Max(0, K), EAllowShrinking::No);
+
+    Out.Reset();
+    if (Hits.IsEmpty()) return;
+    Out.Sources.Append(Sources.GetData(), Sources.Num());
+    for (const FConsoleTierHit& H : Hits) {
+        Out.Hits.Add({ H.Doc, H.Score });
+        Out.SourceOf.Add(H.Source);
     }
-    // alias contains / fuzzy-ish (substring) bumps
-    for (auto& a : E.Aliases) {
-        const FString al = a.ToLower();
-        for (auto& q : Q) if (al.Contains(q)) bonus += 0.15f;
+}
+
+// A raw max-merge. Both tiers are scored by the same retrieval code against the same query, so
+// their raw scores are kept as they are: the weak curated hit that made the cascade escalate stays
+// weak next to a strong complete hit, and ace.MinConsoleCandidateScore applies unchanged. A command
+// both tiers found keeps its better score plus ace.ConsoleCascade.AgreementBonus.
+static void MergeConsoleTiers(const FConsoleHits& Curated, const FConsoleHits& Complete, int32 K, FConsoleHits& Out) {
+    const float AgreementBonus = FMath::Max(0.f, CVarACE_ConsoleCascadeAgreementBonus.GetValueOnAnyThread());
+    const FConsoleHits* Tiers[] = { &Curated, &Complete };
+
+    TArray<FConsoleTierHit, TInlineAllocator<16>> Merged;
+    for (uint8 Source = 0; Source < UE_ARRAY_COUNT(Tiers); ++Source) {
+        const FConsoleHits& Tier = *Tiers[Source];
+        for (int32 i = 0; i < Tier.Num(); ++i) {
+            const float Score = Tier.GetScore(i);
+            const FString& Name = Tier.GetEntry(i).Name;
+            FConsoleTierHit* Same = Merged.FindByPredicate([&Tiers, &Name](const FConsoleTierHit& M) {
+                return Tiers[M.Source]->Data->Entries[M.Doc].Name.Equals(Name, ESearchCase::IgnoreCase);
+            });
+            if (Same) Same->Score = FMath::Max(Same->Score, Score) + AgreementBonus;
+            else Merged.Add({ Tier.Hits[i].Doc, Score, Source });
+        }
     }
-    // tags overlap
-    for (auto& t : E.Tags) {
-        const FString tl = t.ToLower();
-        for (auto& q : Q) if (tl == q) bonus += 0.1f;
+    const FConsoleHits::FDataPtr TierData[] = { Curated.Data, Complete.Data };
+    EmitConsoleTierHits(Merged, TierData, K, Out);
+}
+
+void CascadeConsoleHits(FConsoleHits& Curated, TACERegistryState<FConsoleCommandEntry>* Complete, FStringView Query, int32 K,
+    const FACERetrievalFilter& Policy, FConsoleHits& Out) {
+    INC_DWORD_STAT(STAT_ACE_ConsoleCascadeQueries);
+    if (!Complete || !Complete->Snapshot.IsSet() || IsConsoleTierConfident(Curated)) {
+        if (&Curated != &Out) Out = MoveTemp(Curated);
+        return;
     }
-    return FMath::Clamp(bonus, 0.f, 2.0f);
+    INC_DWORD_STAT(STAT_ACE_ConsoleCascadeEscalations);
+    FConsoleHits Full;
+    QueryConsoleTier(*Complete, Query, K, Policy, Full);
+    if (Full.IsEmpty()) { if (&Curated != &Out) Out = MoveTemp(Curated); return; }
+    if (Curated.IsEmpty()) { Out = MoveTemp(Full); return; }
+    FConsoleHits Merged;
+    MergeConsoleTiers(Curated, Full, K, Merged);
+    Out = MoveTemp(Merged);
 }
 
-void UACEConsoleCommandRegistry::RetrieveTopK(const FString& Query, int32 K, TArray<FConsoleCandidate>& Out) const {
-    TArray<FString> QTok = Tokenize(Query);
-    struct Scored { int32 Idx; float Score; };
-    TArray<Scored> scored; scored.Reserve(Entries.Num());
-    for (int32 i = 0; i < Entries.Num(); ++i) {
-        const auto& E = Entries[i];
-        FString Docline = E.Name + TEXT(" ") + FString::Join(E.Aliases, TEXT(" ")) + TEXT(" ") + E.Doc + TEXT(" ") + FString::Join(E.Tags, TEXT(" ")) + TEXT(" ") + E.ArgNames;
-        float cos = CosineLike(QTok, Tokenize(Docline));
-        float lex = LexicalBonus(QTok, E);
-        float s = 0.8f * cos + 0.2f * lex;
-        if (s > 0.f) scored.Add({ i, s });
-    }
-    scored.Sort([](const Scored& A, const Scored& B) { return A.Score > B.Score; });
+void UACEConsoleCommandRegistry::RetrieveHits(const FString& Query, int32 K, const FACERetrievalFilter& Filter, FConsoleHits& Out) const {
+    Out.Reset();
+    if (!State.IsValid()) return;
+    const FACERetrievalFilter Policy = WithConsolePolicy(Filter);
+    QueryConsoleTier(*State, Query, K, Policy, Out);
+    if (CompleteState.IsValid()) CascadeConsoleHits(Out, CompleteState.Get(), Query, K, Policy, Out);
+}
+
+void UACEConsoleCommandRegistry::RetrieveTopKBatch(TConstArrayView<FString> Queries, int32 K, TArray<TArray<FConsoleCandidate>>& Out, const FACERetrievalFilter& Filter) const {
+    Out.SetNum(Queries.Num());
+    for (auto& Row : Out) Row.Reset();
+    if (!State.IsValid()) return;
+    FRegistryState::FReadScope Snapshot(State->Snapshot);
+    if (!Snapshot) return;
+
+    const FACERetrievalFilter Policy = WithConsolePolicy(Filter);
+    TArray<FACERetrievalHit> Hits;
+    TArray<int32> Counts;
+    State->QueryBatch(Snapshot, Queries, K, Hits, Counts, Policy);
+    K = FMath::Max(0, K);
+    const FConsoleHits::FDataPtr SnapshotData = Snapshot.Pin();
+    TACERegistryState<FConsoleCommandEntry>* Complete = CompleteState.Get();
+    ParallelFor(Queries.Num(), [&Queries, &Policy, &SnapshotData, Complete, &Hits, &Counts, &Out, K](int32 q) {
+        FConsoleHits Row;
+        Row.Data = SnapshotData;
+        Row.Hits.Append(Hits.GetData() + q * K, Counts[q]);
+        if (Complete) CascadeConsoleHits(Row, Complete, Queries[q], K, Policy, Row);
+        Out[q].Reserve(Row.Num());
+        for (int32 i = 0; i < Row.Num(); ++i) Out[q].Add(MakeConsoleCandidate(Row.GetData(i), Row.Hits[i].Doc, Row.GetScore(i)));
+    });
+}
+
+UACEConsoleCommandRegistry::FSnapshots UACEConsoleCommandRegistry::PinSnapshots() const {
+    FSnapshots Out;
+    for (const TSharedPtr<FRegistryState, ESPMode::ThreadSafe>* Tier : { &State, &CompleteState }) {
+        if (!Tier->IsValid()) continue;
+        FRegistryState::FReadScope Snapshot((*Tier)->Snapshot);
+        if (Snapshot) Out.Add(Snapshot.Pin());
+    }
+    return Out;
+}
+
+void UACEConsoleCommandRegistry::Suggest(TConstArrayView<FConsoleHits::FDataPtr> Snapshots, FStringView Prefix, int32 K, double Deadline, FConsoleHits& Out) {
     Out.Reset();
-    for (int32 i = 0; i < scored.Num() && i < K; ++i) {
-        const auto& E = Entries[scored[i].Idx];
-        FConsoleCandidate C;
-        C.Name = E.Name; C.Aliases = E.Aliases; C.Doc = E.Doc; C.Tags = E.Tags; C.ArgNames = E.ArgNames; C.Score = scored[i].Score;
-        Out.Add(MoveTemp(C));
+    K = FMath::Max(0, K);
+    const FACERetrievalFilter Policy = WithConsolePolicy(FACERetrievalFilter());
+    TArray<FConsoleTierHit, TInlineAllocator<16>> Merged;
+    TArray<FACERetrievalHit, TInlineAllocator<16>> Hits;
+    for (int32 s = 0; s < Snapshots.Num() && s <= MAX_uint8; ++s) {
+        const FRegistryData& Data = *Snapshots[s];
+        Hits.SetNumUninitialized(K);
+        Hits.SetNum(Data.Index.Suggest(Prefix, Hits, Data.Index.MakeFilter(Policy), Deadline), EAllowShrinking::No);
+        // The curated tier is asked first, so its entry wins a name both tiers know.
+        for (const FACERetrievalHit& H : Hits) {
+            const FString& Name = Data.Entries[H.Doc].Name;
+            const bool bSeen = Merged.ContainsByPredicate([&Snapshots, &Name](const FConsoleTierHit& M) {
+                return Snapshots[M.Source]->Entries[M.Doc].Name.Equals(Name, ESearchCase::IgnoreCase);
+            });
+            if (!bSeen) Merged.Add({ H.Doc, H.Score, uint8(s) });
+        }
+    }
+    EmitConsoleTierHits(Merged, Snapshots, K, Out);
+}
+
+// Argument shapes from ArgNames, e.g. "percent", "name [value:float]", "x:int y:int", "args...".
+// Separators are whitespace or commas; [x] and x? are optional, x... takes the rest of the line.
+enum class EConsoleArgType : uint8 { Any, Int, Float, Bool, String };
+
+struct FConsoleArgSpec {
+    EConsoleArgType Type = EConsoleArgType::Any;
+    bool bOptional = false;
+    bool bRest = false;
+};
+
+static EConsoleArgType ConsoleArgTypeFromName(FStringView Name) {
+    int32 Colon = INDEX_NONE;
+    if (Name.FindChar(TEXT(':'), Colon)) {
+        const FStringView Type = Name.RightChop(Colon + 1);
+        if (Type.Equals(TEXT("int"), ESearchCase::IgnoreCase)) return EConsoleArgType::Int;
+        if (Type.Equals(TEXT("float"), ESearchCase::IgnoreCase) || Type.Equals(TEXT("number"), ESearchCase::IgnoreCase)) return EConsoleArgType::Float;
+        if (Type.Equals(TEXT("bool"), ESearchCase::IgnoreCase)) return EConsoleArgType::Bool;
+        if (Type.Equals(TEXT("string"), ESearchCase::IgnoreCase) || Type.Equals(TEXT("name"), ESearchCase::IgnoreCase)) return EConsoleArgType::String;
+        return EConsoleArgType::Any;
+    }
+    // Untyped names that clearly take free text.
+    static const TCHAR* StringHints[] = { TEXT("name"), TEXT("map"), TEXT("path"), TEXT("command"), TEXT("text") };
+    for (const TCHAR* Hint : StringHints) {
+        if (UE::String::FindFirst(Name, Hint, ESearchCase::IgnoreCase) != INDEX_NONE) return EConsoleArgType::String;
+    }
+    return EConsoleArgType::Any;
+}
+
+static void ParseConsoleArgSpecs(FStringView ArgNames, TArray<FConsoleArgSpec, TInlineAllocator<4>>& Out) {
+    int32 i = 0;
+    while (i < ArgNames.Len()) {
+        while (i < ArgNames.Len() && (FChar::IsWhitespace(ArgNames[i]) || ArgNames[i] == TEXT(','))) ++i;
+        const int32 Start = i;
+        while (i < ArgNames.Len() && !FChar::IsWhitespace(ArgNames[i]) && ArgNames[i] != TEXT(',')) ++i;
+        FStringView Name = ArgNames.Mid(Start, i - Start);
+        if (Name.IsEmpty()) continue;
+
+        FConsoleArgSpec Spec;
+        if (Name.StartsWith(TEXT('[')) || Name.StartsWith(TEXT('<'))) {
+            Spec.bOptional = Name.StartsWith(TEXT('['));
+            Name.RightChopInline(1);
+            if (Name.EndsWith(TEXT(']')) || Name.EndsWith(TEXT('>'))) Name.LeftChopInline(1);
+        }
+        if (Name.EndsWith(TEXT("..."))) { Spec.bRest = true; Spec.bOptional = true; Name.LeftChopInline(3); }
+        if (Name.EndsWith(TEXT('?'))) { Spec.bOptional = true; Name.LeftChopInline(1); }
+        Spec.Type = ConsoleArgTypeFromName(Name);
+        Out.Add(Spec);
+    }
+}
+
+static bool IsConsoleNumber(FStringView Token, bool bAllowFraction) {
+    int32 i = (Token.Len() > 0 && (Token[0] == TEXT('-') || Token[0] == TEXT('+'))) ? 1 : 0;
+    bool bDigits = false, bDot = false;
+    for (; i < Token.Len(); ++i) {
+        if (FChar::IsDigit(Token[i])) bDigits = true;
+        else if (Token[i] == TEXT('.') && bAllowFraction && !bDot) bDot = true;
+        else return false;
+    }
+    return bDigits;
+}
+
+static bool IsConsoleBool(FStringView Token) {
+    static const TCHAR* Words[] = { TEXT("0"), TEXT("1"), TEXT("true"), TEXT("false"), TEXT("on"), TEXT("off") };
+    for (const TCHAR* W : Words) if (Token.Equals(W, ESearchCase::IgnoreCase)) return true;
+    return false;
+}
+
+static bool ConsoleArgFits(EConsoleArgType Type, FStringView Token) {
+    switch (Type) {
+    case EConsoleArgType::Int: return IsConsoleNumber(Token, false);
+    case EConsoleArgType::Float: return IsConsoleNumber(Token, true);
+    case EConsoleArgType::Bool: return IsConsoleBool(Token);
+    case EConsoleArgType::String: return true;
+    default:
+        // Untyped: values, identifiers and paths pass; a plain word is more likely the rest of a
+        // sentence ("fly over there") than an argument, so that goes to the planner.
+        if (IsConsoleNumber(Token, true) || IsConsoleBool(Token)) return true;
+        for (const TCHAR C : Token) if (!FChar::IsAlpha(C)) return true;
+        return false;
     }
 }
+
+// Arguments split on whitespace; a double-quoted run counts as one token.
+static bool ConsoleArgsFit(FStringView Args, FStringView ArgNames) {
+    TArray<FConsoleArgSpec, TInlineAllocator<4>> Specs;
+    ParseConsoleArgSpecs(ArgNames, Specs);
+
+    int32 Arg = 0, i = 0;
+    while (i < Args.Len()) {
+        while (i < Args.Len() && FChar::IsWhitespace(Args[i])) ++i;
+        if (i >= Args.Len()) break;
+        if (Arg >= Specs.Num()) return false;
+        const FConsoleArgSpec& Spec = Specs[Arg];
+        if (Spec.bRest) return true;
+
+        const int32 Start = i;
+        if (Args[i] == TEXT('"')) {
+            do { ++i; } while (i < Args.Len() && Args[i] != TEXT('"'));
+            if (i >= Args.Len()) return false;
+            ++i;
+        } else {
+            while (i < Args.Len() && !FChar::IsWhitespace(Args[i])) ++i;
+        }
+        const FStringView Token = Args.Mid(Start, i - Start);
+        const bool bQuoted = Token[0] == TEXT('"');
+        if (bQuoted ? Spec.Type != EConsoleArgType::String && Spec.Type != EConsoleArgType::Any : !ConsoleArgFits(Spec.Type, Token)) return false;
+        ++Arg;
+    }
+    for (; Arg < Specs.Num(); ++Arg) if (!Specs[Arg].bOptional) return false;
+    return true;
+}
+
+// MatchExactCommand against one registry snapshot.
+static bool MatchExactCommandIn(const TACERegistryData<FConsoleCommandEntry>& Data, FStringView Text, FString& OutCommandLine) {
+    TArray<FACENameMatch, TInlineAllocator<8>> Matches;
+    Matches.SetNumUninitialized(8);
+    Matches.SetNum(Data.Index.GetNameTrie().MatchPrefixes(Text, Matches), EAllowShrinking::No);
+    if (Matches.Num() == 0) return false;
+
+    // The longest key wins ("stat fps" over "stat"); a key whose arguments do not fit falls back
+    // to the next shorter one. Two different commands at the same length is ambiguous.
+    FACERetrievalFilter Policy = WithConsolePolicy(FACERetrievalFilter());
+    Policy.ExcludeTags.AddUnique(HarvestedTag);
+    const FACEDocFilter Filter = Data.Index.MakeFilter(Policy);
+    for (int32 m = Matches.Num() - 1; m >= 0; --m) {
+        const FStringView Args = Text.RightChop(Matches[m].End).TrimStart();
+        const FConsoleCommandEntry* Found = nullptr;
+        for (const int32 Doc : Data.Index.GetNameTrie().GetDocs(Matches[m].Node)) {
+            const FConsoleCommandEntry& E = Data.Entries[Doc];
+            if (!Filter.Passes(Doc) || !ConsoleArgsFit(Args, E.ArgNames)) continue;
+            if (Found && !Found->Name.Equals(E.Name, ESearchCase::IgnoreCase)) return false;
+            Found = &E;
+        }
+        if (!Found) continue;
+
+        OutCommandLine = Found->Name;
+        if (!Args.IsEmpty()) { OutCommandLine += TEXT(" "); OutCommandLine += Args; }
+        return true;
+    }
+    return false;
+}
+
+bool UACEConsoleCommandRegistry::MatchExactCommand(const FString& Directive, FString& OutCommandLine) const {
+    if (!State.IsValid()) return false;
+
+    FStringView Text = FStringView(Directive).TrimStartAndEnd();
+    while (Text.Len() > 0 && (Text.EndsWith(TEXT('.')) || Text.EndsWith(TEXT('!')) || Text.EndsWith(TEXT('?')))) Text.LeftChopInline(1);
+    if (Text.IsEmpty()) return false;
+
+    // Only the curated commands are eligible; the complete tier ("exit", "quit") goes through
+    // retrieval and the planner like any other directive.
+    FRegistryState::FReadScope Snapshot(State->Snapshot);
+    return Snapshot && MatchExactCommandIn(*Snapshot, Text, OutCommandLine);
+}
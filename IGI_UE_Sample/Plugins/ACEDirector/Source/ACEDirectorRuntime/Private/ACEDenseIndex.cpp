@@ -0,0 +1,354 @@
+#include "ACEDenseIndex.h"
+#include "ACEHnswIndex.h"
+#include "HAL/IConsoleManager.h"
+
+#if PLATFORM_ALWAYS_HAS_AVX_2
+    #define ACE_DENSE_AVX2 1
+    #include <immintrin.h>
+#elif PLATFORM_CPU_X86_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS
+    #define ACE_DENSE_SSE2 1
+    #include <emmintrin.h>
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+    #define ACE_DENSE_NEON 1
+    #include <arm_neon.h>
+#endif
+
+static TAutoConsoleVariable<int32> CVarACE_RetrievalMode(
+    TEXT("ace.RetrievalMode"),
+    0,
+    TEXT("Candidate retrieval for the console and world-action registries. ")
+    TEXT("0 = sparse BM25, 1 = dense hashed n-gram vectors, 2 = hybrid blend (see ace.RetrievalDenseWeight). ")
+    TEXT("Dense cosine scores run higher than BM25 on unrelated text; retune ace.Min*CandidateScore when switching."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarACE_RetrievalDenseWeight(
+    TEXT("ace.RetrievalDenseWeight"),
+    0.35f,
+    TEXT("Share of the dense score in hybrid retrieval (ace.RetrievalMode=2); the sparse score gets the rest."),
+    ECVF_Default);
+
+namespace
+{
+    constexpr int32 MaxDenseTokenChars = 64;
+
+    bool DenseWeakerHit(const FACERetrievalHit& A, const FACERetrievalHit& B)
+    {
+        return A.Score < B.Score || (A.Score == B.Score && A.Doc > B.Doc);
+    }
+
+    // FNV-1a with a murmur finalizer so both the bucket and the sign bit are well mixed.
+    uint32 HashGram(const TCHAR* Chars, int32 Num, uint32 Seed)
+    {
+        uint32 H = 2166136261u ^ Seed;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            H = (H ^ (uint32)Chars[i]) * 16777619u;
+        }
+        H ^= H >> 16; H *= 0x85ebca6bu;
+        H ^= H >> 13; H *= 0xc2b2ae35u;
+        H ^= H >> 16;
+        return H;
+    }
+
+    struct FDenseSectionHeader
+    {
+        int32 NumDocs = 0;
+        int32 Dim = 0;
+    };
+
+    thread_local TArray<FACERetrievalHit> GDenseHeap;
+}
+
+FACEDenseIndex& FACEDenseIndex::operator=(const FACEDenseIndex& Other)
+{
+    Vectors = Other.Vectors;
+    Scales = Other.Scales;
+    bAttached = Other.bAttached;
+    if (bAttached)
+    {
+        VectorsView = Other.VectorsView;
+        ScalesView = Other.ScalesView;
+    }
+    else
+    {
+        SyncViews();
+    }
+    return *this;
+}
+
+void FACEDenseIndex::SyncViews()
+{
+    VectorsView = MakeArrayView(Vectors.GetData(), Vectors.Num());
+    ScalesView = Scales;
+}
+
+void FACEDenseIndex::BeginBuild(int32 ExpectedDocs)
+{
+    bAttached = false;
+    Vectors.Reset(ExpectedDocs * Dim);
+    Scales.Reset(ExpectedDocs);
+    SyncViews();
+}
+
+void FACEDenseIndex::AddDocument(FStringView Text)
+{
+    const int32 Offset = Vectors.AddUninitialized(Dim);
+    Scales.Add(Embed(Text, Vectors.GetData() + Offset));
+}
+
+void FACEDenseIndex::FinishBuild()
+{
+    SyncViews();
+}
+
+float FACEDenseIndex::Embed(FStringView Text, int8* OutVector)
+{
+    float Acc[Dim] = {};
+    auto AddFeature = [&Acc](uint32 H, float W)
+        {
+            Acc[H & (Dim - 1)] += (H & 0x80000000u) ? -W : W;
+        };
+
+    FACERetrievalIndex::ForEachToken(Text, [&AddFeature](FStringView Token)
+        {
+            // "#word#" so grams at the word boundaries differ from grams inside it.
+            TCHAR Buf[MaxDenseTokenChars + 2];
+            const int32 Len = FMath::Min(Token.Len(), MaxDenseTokenChars);
+            Buf[0] = TEXT('#');
+            for (int32 i = 0; i < Len; ++i) Buf[i + 1] = FChar::ToLower(Token[i]);
+            Buf[Len + 1] = TEXT('#');
+            const int32 N = Len + 2;
+
+            AddFeature(HashGram(Buf, N, 0), 2.f);
+            for (int32 Gram = 3; Gram <= 4; ++Gram)
+            {
+                for (int32 i = 0; i + Gram <= N; ++i)
+                {
+                    AddFeature(HashGram(Buf + i, Gram, Gram), 1.f);
+                }
+            }
+        });
+
+    float SumSq = 0.f;
+    float MaxAbs = 0.f;
+    for (int32 i = 0; i < Dim; ++i)
+    {
+        SumSq += Acc[i] * Acc[i];
+        MaxAbs = FMath::Max(MaxAbs, FMath::Abs(Acc[i]));
+    }
+    if (MaxAbs <= 0.f)
+    {
+        FMemory::Memzero(OutVector, Dim);
+        return 0.f;
+    }
+
+    // Symmetric [-127, 127] keeps the AVX2 maddubs path free of int16 saturation.
+    const float ToInt8 = 127.f / MaxAbs;
+    for (int32 i = 0; i < Dim; ++i)
+    {
+        OutVector[i] = (int8)FMath::Clamp(FMath::RoundToInt(Acc[i] * ToInt8), -127, 127);
+    }
+    return MaxAbs / (127.f * FMath::Sqrt(SumSq));
+}
+
+int32 FACEDenseIndex::Dot(const int8* A, const int8* B)
+{
+#if ACE_DENSE_AVX2
+    __m256i Acc = _mm256_setzero_si256();
+    const __m256i Ones = _mm256_set1_epi16(1);
+    for (int32 i = 0; i < Dim; i += 32)
+    {
+        const __m256i VA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(A + i));
+        const __m256i VB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(B + i));
+        // maddubs multiplies unsigned by signed bytes, so move A's sign onto B.
+        const __m256i Pairs = _mm256_maddubs_epi16(_mm256_abs_epi8(VA), _mm256_sign_epi8(VB, VA));
+        Acc = _mm256_add_epi32(Acc, _mm256_madd_epi16(Pairs, Ones));
+    }
+    __m128i Sum = _mm_add_epi32(_mm256_castsi256_si128(Acc), _mm256_extracti128_si256(Acc, 1));
+    Sum = _mm_add_epi32(Sum, _mm_shuffle_epi32(Sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    Sum = _mm_add_epi32(Sum, _mm_shuffle_epi32(Sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(Sum);
+#elif ACE_DENSE_SSE2
+    __m128i Acc = _mm_setzero_si128();
+    for (int32 i = 0; i < Dim; i += 16)
+    {
+        const __m128i VA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(A + i));
+        const __m128i VB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(B + i));
+        // Sign-extend bytes to int16 by unpacking each byte with itself and shifting arithmetically.
+        const __m128i ALo = _mm_srai_epi16(_mm_unpacklo_epi8(VA, VA), 8);
+        const __m128i AHi = _mm_srai_epi16(_mm_unpackhi_epi8(VA, VA), 8);
+        const __m128i BLo = _mm_srai_epi16(_mm_unpacklo_epi8(VB, VB), 8);
+        const __m128i BHi = _mm_srai_epi16(_mm_unpackhi_epi8(VB, VB), 8);
+        Acc = _mm_add_epi32(Acc, _mm_madd_epi16(ALo, BLo));
+        Acc = _mm_add_epi32(Acc, _mm_madd_epi16(AHi, BHi));
+    }
+    Acc = _mm_add_epi32(Acc, _mm_shuffle_epi32(Acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    Acc = _mm_add_epi32(Acc, _mm_shuffle_epi32(Acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(Acc);
+#elif ACE_DENSE_NEON
+    int32x4_t Acc = vdupq_n_s32(0);
+    for (int32 i = 0; i < Dim; i += 16)
+    {
+        const int8x16_t VA = vld1q_s8(A + i);
+        const int8x16_t VB = vld1q_s8(B + i);
+        Acc = vpadalq_s16(Acc, vmull_s8(vget_low_s8(VA), vget_low_s8(VB)));
+        Acc = vpadalq_s16(Acc, vmull_s8(vget_high_s8(VA), vget_high_s8(VB)));
+    }
+    return vaddvq_s32(Acc);
+#else
+    int32 Sum = 0;
+    for (int32 i = 0; i < Dim; ++i)
+    {
+        Sum += (int32)A[i] * (int32)B[i];
+    }
+    return Sum;
+#endif
+}
+
+int32 FACEDenseIndex::Query(FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter) const
+{
+    alignas(32) int8 QueryVector[Dim];
+    const float QueryScale = Embed(Query, QueryVector);
+    return QueryEmbedded(QueryVector, QueryScale, OutHits, Filter);
+}
+
+int32 FACEDenseIndex::QueryEmbedded(const int8* QueryVector, float QueryScale, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter) const
+{
+    const int32 K = OutHits.Num();
+    const int32 N = NumDocs();
+    if (K <= 0 || N == 0 || QueryScale <= 0.f) return 0;
+
+    TArray<FACERetrievalHit>& Heap = GDenseHeap;
+    Heap.Reset();
+    const bool bFiltered = Filter.IsActive();
+    for (int32 Doc = 0; Doc < N; ++Doc)
+    {
+        if (bFiltered && !Filter.Passes(Doc)) continue;
+        const float S = Score(QueryVector, QueryScale, Doc);
+        if (S <= 0.f) continue;
+        if (Heap.Num() < K)
+        {
+            Heap.HeapPush({ Doc, S }, DenseWeakerHit);
+        }
+        else if (S > Heap.HeapTop().Score)
+        {
+            Heap.HeapPopDiscard(DenseWeakerHit, EAllowShrinking::No);
+            Heap.HeapPush({ Doc, S }, DenseWeakerHit);
+        }
+    }
+
+    Heap.Sort([](const FACERetrievalHit& A, const FACERetrievalHit& B) { return DenseWeakerHit(B, A); });
+    const int32 Count = Heap.Num();
+    for (int32 i = 0; i < Count; ++i) OutHits[i] = Heap[i];
+    return Count;
+}
+
+SIZE_T FACEDenseIndex::GetAllocatedSize() const
+{
+    if (bAttached)
+    {
+        return VectorsView.Num() + ScalesView.Num() * sizeof(float);
+    }
+    return Vectors.GetAllocatedSize() + Scales.GetAllocatedSize();
+}
+
+void FACEDenseIndex::Write(TArray<uint8>& Out) const
+{
+    using namespace ACERetrievalBlob;
+
+    FDenseSectionHeader H;
+    H.NumDocs = NumDocs();
+    H.Dim = Dim;
+    Pad16(Out);
+    WritePod(Out, H);
+    WriteArray(Out, ScalesView);
+    WriteArray(Out, VectorsView);
+}
+
+bool FACEDenseIndex::Attach(const uint8*& Cursor, const uint8* End)
+{
+    using namespace ACERetrievalBlob;
+    BeginBuild(0);
+
+    FDenseSectionHeader H;
+    const uint8* C = reinterpret_cast<const uint8*>(::Align(reinterpret_cast<UPTRINT>(Cursor), 16));
+    if (C > End || !ReadPod(C, End, H) || H.Dim != Dim || H.NumDocs < 0) return false;
+
+    if (!ReadArray(C, End, H.NumDocs, ScalesView) || !ReadArray(C, End, H.NumDocs * Dim, VectorsView))
+    {
+        BeginBuild(0);
+        return false;
+    }
+
+    bAttached = true;
+    Cursor = C;
+    return true;
+}
+
+EACERetrievalMode ACERetrieval::GetMode()
+{
+    const int32 Mode = CVarACE_RetrievalMode.GetValueOnAnyThread();
+    return (Mode >= 0 && Mode <= (int32)EACERetrievalMode::Hybrid) ? (EACERetrievalMode)Mode : EACERetrievalMode::Sparse;
+}
+
+float ACERetrieval::GetDenseWeight()
+{
+    return FMath::Clamp(CVarACE_RetrievalDenseWeight.GetValueOnAnyThread(), 0.f, 1.f);
+}
+
+int32 ACERetrieval::Query(const FACERetrievalIndex& Sparse, const FACEDenseIndex& Dense, const FACEHnswIndex& Graph, FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter)
+{
+    const EACERetrievalMode Mode = Dense.NumDocs() == Sparse.NumDocs() ? GetMode() : EACERetrievalMode::Sparse;
+    if (Mode == EACERetrievalMode::Sparse) return Sparse.Query(Query, OutHits, Filter);
+
+    alignas(32) int8 QueryVector[FACEDenseIndex::Dim];
+    const float QueryScale = FACEDenseIndex::Embed(Query, QueryVector);
+    auto QueryDense = [&Dense, &Graph, &QueryVector, QueryScale, &Filter](TArrayView<FACERetrievalHit> Hits)
+        {
+            if (Graph.NumNodes() != Dense.NumDocs()) return Dense.QueryEmbedded(QueryVector, QueryScale, Hits, Filter);
+
+            // The graph drops filtered documents from its candidates; when a strict filter leaves
+            // too few of them, scan the documents that pass instead.
+            const int32 Count = Graph.Search(Dense, QueryVector, QueryScale, ACEHnsw::GetEfSearch(), Hits, Filter);
+            return Count < Hits.Num() && Filter.IsActive() ? Dense.QueryEmbedded(QueryVector, QueryScale, Hits, Filter) : Count;
+        };
+    if (Mode == EACERetrievalMode::Dense) return QueryDense(OutHits);
+
+    // Hybrid: shortlist from both indices, then blend. Sparse-shortlisted documents get their exact
+    // dense score; dense-only documents count as sparse 0, since they fell outside the sparse shortlist.
+    const int32 K = OutHits.Num();
+    if (K <= 0) return 0;
+    const int32 M = FMath::Clamp(K * 4, 16, 64);
+    const float W = GetDenseWeight();
+
+    TArray<FACERetrievalHit, TInlineAllocator<64>> SparseHits;
+    SparseHits.SetNumUninitialized(M);
+    SparseHits.SetNum(Sparse.Query(Query, SparseHits, Filter), EAllowShrinking::No);
+
+    TArray<FACERetrievalHit, TInlineAllocator<64>> DenseHits;
+    DenseHits.SetNumUninitialized(M);
+    DenseHits.SetNum(QueryDense(DenseHits), EAllowShrinking::No);
+
+    TArray<FACERetrievalHit, TInlineAllocator<128>> Blended;
+    for (const FACERetrievalHit& H : SparseHits)
+    {
+        const float DenseScore = QueryScale > 0.f ? FMath::Max(0.f, Dense.Score(QueryVector, QueryScale, H.Doc)) : 0.f;
+        Blended.Add({ H.Doc, (1.f - W) * H.Score + W * DenseScore });
+    }
+    for (const FACERetrievalHit& H : DenseHits)
+    {
+        if (!SparseHits.ContainsByPredicate([&H](const FACERetrievalHit& S) { return S.Doc == H.Doc; }))
+        {
+            Blended.Add({ H.Doc, W * H.Score });
+        }
+    }
+
+    Blended.Sort([](const FACERetrievalHit& A, const FACERetrievalHit& B) { return DenseWeakerHit(B, A); });
+    int32 Count = 0;
+    for (const FACERetrievalHit& H : Blended)
+    {
+        if (Count == K || H.Score <= 0.f) break;
+        OutHits[Count++] = H;
+    }
+    return Count;
+}
@@ -0,0 +1,538 @@
+#include "ACEFuzzyIndex.h"
+#include "HAL/IConsoleManager.h"
+#include "Algo/BinarySearch.h"
+
+static TAutoConsoleVariable<float> CVarACE_FuzzyWeight(
+    TEXT("ace.Fuzzy.Weight"),
+    0.3f,
+    TEXT("Score added per unit of fuzzy name/alias similarity (typos, ASR mishearings). 0 disables fuzzy matching."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarACE_FuzzyMaxEdits(
+    TEXT("ace.Fuzzy.MaxEdits"),
+    2,
+    TEXT("Upper bound on edits for a trigram fuzzy match; short keys allow fewer (<=3 chars: 0, <=7 chars: 1)."),
+    ECVF_Default);
+
+namespace
+{
+    constexpr int32 MaxFuzzyKeyChars = 48;
+    constexpr int32 MaxFuzzySpanTokens = 3;
+    constexpr int32 MaxFuzzyQueryTokens = 16;
+    constexpr int32 MinPhoneticCode = 3;
+
+    bool FuzzyWeakerHit(const FACERetrievalHit& A, const FACERetrievalHit& B)
+    {
+        return A.Score < B.Score || (A.Score == B.Score && A.Doc > B.Doc);
+    }
+
+    bool IsVowel(TCHAR C)
+    {
+        return C == TEXT('a') || C == TEXT('e') || C == TEXT('i') || C == TEXT('o') || C == TEXT('u');
+    }
+
+    // Lowercase alphanumerics only, so "r.ScreenPercentage" and "screen percentage" line up. Writes at
+    // most Capacity characters; a result of Capacity may have been cut short.
+    int32 NormalizeKey(FStringView Text, TCHAR* Out, int32 Capacity)
+    {
+        int32 Len = 0;
+        for (int32 i = 0; i < Text.Len() && Len < Capacity; ++i)
+        {
+            if (FChar::IsAlnum(Text[i])) Out[Len++] = FChar::ToLower(Text[i]);
+        }
+        return Len;
+    }
+
+    uint32 HashChars(const TCHAR* Chars, int32 Num)
+    {
+        uint32 H = 2166136261u;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            H = (H ^ (uint32)Chars[i]) * 16777619u;
+        }
+        return H;
+    }
+
+    // Unique hashes of the trigrams of "$Key$"; a key of length L has L of them.
+    int32 KeyTrigrams(FStringView Key, uint32* Out)
+    {
+        TCHAR Padded[MaxFuzzyKeyChars + 2];
+        Padded[0] = TEXT('$');
+        for (int32 i = 0; i < Key.Len(); ++i) Padded[i + 1] = Key[i];
+        Padded[Key.Len() + 1] = TEXT('$');
+
+        int32 Num = 0;
+        for (int32 i = 0; i < Key.Len(); ++i)
+        {
+            const uint32 H = HashChars(Padded + i, 3);
+            bool bDuplicate = false;
+            for (int32 j = 0; j < Num && !bDuplicate; ++j) bDuplicate = Out[j] == H;
+            if (!bDuplicate) Out[Num++] = H;
+        }
+        return Num;
+    }
+
+    int32 AllowedEdits(int32 Len)
+    {
+        const int32 ByLength = Len <= 3 ? 0 : (Len <= 7 ? 1 : 2);
+        return FMath::Min(ByLength, ACEFuzzy::GetMaxEdits());
+    }
+
+    struct FFuzzySectionHeader
+    {
+        int32 NumDocs = 0;
+        int32 NumKeys = 0;
+        int32 NumChars = 0;
+        int32 NumGrams = 0;
+        int32 NumGramKeys = 0;
+        int32 NumPhones = 0;
+    };
+
+    // Per-thread trigram counters, stamped so a span never clears them.
+    struct FFuzzyScratch
+    {
+        TArray<uint32> KeyStamp;
+        TArray<uint16> KeyCount;
+        TArray<int32> Touched;
+        TArray<FACERetrievalHit> Best;
+        uint32 Stamp = 0;
+
+        void BeginSpan(int32 NumKeys)
+        {
+            Touched.Reset();
+            if (KeyStamp.Num() < NumKeys)
+            {
+                KeyStamp.SetNumZeroed(NumKeys);
+                KeyCount.SetNumZeroed(NumKeys);
+            }
+            if (++Stamp == 0)
+            {
+                FMemory::Memzero(KeyStamp.GetData(), KeyStamp.Num() * sizeof(uint32));
+                Stamp = 1;
+            }
+        }
+    };
+
+    thread_local FFuzzyScratch GFuzzyScratch;
+}
+
+FACEFuzzyIndex& FACEFuzzyIndex::operator=(const FACEFuzzyIndex& Other)
+{
+    NumIndexedDocs = Other.NumIndexedDocs;
+    KeyChars = Other.KeyChars;
+    KeyStart = Other.KeyStart;
+    KeyDoc = Other.KeyDoc;
+    GramHash = Other.GramHash;
+    GramStart = Other.GramStart;
+    GramKey = Other.GramKey;
+    PhoneHash = Other.PhoneHash;
+    PhoneKey = Other.PhoneKey;
+    bAttached = Other.bAttached;
+    if (bAttached)
+    {
+        KeyCharsView = Other.KeyCharsView;
+        KeyStartView = Other.KeyStartView;
+        KeyDocView = Other.KeyDocView;
+        GramHashView = Other.GramHashView;
+        GramStartView = Other.GramStartView;
+        GramKeyView = Other.GramKeyView;
+        PhoneHashView = Other.PhoneHashView;
+        PhoneKeyView = Other.PhoneKeyView;
+    }
+    else
+    {
+        SyncViews();
+    }
+    return *this;
+}
+
+void FACEFuzzyIndex::SyncViews()
+{
+    KeyCharsView = KeyChars;
+    KeyStartView = KeyStart;
+    KeyDocView = KeyDoc;
+    GramHashView = GramHash;
+    GramStartView = GramStart;
+    GramKeyView = GramKey;
+    PhoneHashView = PhoneHash;
+    PhoneKeyView = PhoneKey;
+}
+
+void FACEFuzzyIndex::BeginBuild()
+{
+    NumIndexedDocs = 0;
+    KeyChars.Reset();
+    KeyStart.Reset();
+    KeyStart.Add(0);
+    KeyDoc.Reset();
+    GramHash.Reset();
+    GramStart.Reset();
+    GramKey.Reset();
+    PhoneHash.Reset();
+    PhoneKey.Reset();
+    bAttached = false;
+    SyncViews();
+}
+
+void FACEFuzzyIndex::AddKey(FStringView Text, int32 Doc)
+{
+    TCHAR Buf[MaxFuzzyKeyChars];
+    const int32 Len = NormalizeKey(Text, Buf, MaxFuzzyKeyChars);
+    if (Len == 0) return;
+
+    // Aliases often normalize to the name ("slomo" / "slo-mo"); one key per document is enough.
+    const FStringView Key(Buf, Len);
+    for (int32 k = KeyDoc.Num() - 1; k >= 0 && KeyDoc[k] == Doc; --k)
+    {
+        if (FStringView(KeyChars.GetData() + KeyStart[k], KeyStart[k + 1] - KeyStart[k]).Equals(Key)) return;
+    }
+
+    KeyChars.Append(Buf, Len);
+    KeyStart.Add(KeyChars.Num());
+    KeyDoc.Add(Doc);
+}
+
+void FACEFuzzyIndex::AddDocument(FStringView Name, TConstArrayView<FString> Aliases)
+{
+    const int32 Doc = NumIndexedDocs++;
+    AddKey(Name, Doc);
+    for (const FString& Alias : Aliases)
+    {
+        AddKey(Alias, Doc);
+    }
+}
+
+void FACEFuzzyIndex::FinishBuild()
+{
+    SyncViews();
+    const int32 NumKeyEntries = KeyDoc.Num();
+
+    TArray<TPair<uint32, int32>> Grams;
+    TArray<TPair<uint32, int32>> Phones;
+    uint32 KeyGrams[MaxFuzzyKeyChars];
+    TCHAR Code[MaxFuzzyKeyChars * 2];
+    for (int32 k = 0; k < NumKeyEntries; ++k)
+    {
+        const FStringView Key = GetKey(k);
+        const int32 NumGrams = KeyTrigrams(Key, KeyGrams);
+        for (int32 g = 0; g < NumGrams; ++g) Grams.Add({ KeyGrams[g], k });
+
+        const int32 CodeLen = Encode(Key, Code, UE_ARRAY_COUNT(Code));
+        if (CodeLen >= MinPhoneticCode) Phones.Add({ HashChars(Code, CodeLen), k });
+    }
+
+    auto ByHashThenKey = [](const TPair<uint32, int32>& A, const TPair<uint32, int32>& B)
+        {
+            return A.Key < B.Key || (A.Key == B.Key && A.Value < B.Value);
+        };
+    Grams.Sort(ByHashThenKey);
+    Phones.Sort(ByHashThenKey);
+
+    for (const TPair<uint32, int32>& G : Grams)
+    {
+        if (GramHash.Num() == 0 || GramHash.Last() != G.Key)
+        {
+            GramHash.Add(G.Key);
+            GramStart.Add(GramKey.Num());
+        }
+        GramKey.Add(G.Value);
+    }
+    GramStart.Add(GramKey.Num());
+
+    for (const TPair<uint32, int32>& P : Phones)
+    {
+        PhoneHash.Add(P.Key);
+        PhoneKey.Add(P.Value);
+    }
+    SyncViews();
+}
+
+int32 FACEFuzzyIndex::Encode(FStringView Key, TCHAR* OutCode, int32 MaxCode)
+{
+    // Metaphone-like consonant skeleton. Voiced consonants fold onto their unvoiced pair (b/p,
+    // d/t, g/k, v/f, z/s) because speech recognizers confuse those far more often than letters.
+    int32 Num = 0;
+    TCHAR Last = 0;
+    auto Emit = [&Num, &Last, OutCode, MaxCode](TCHAR C)
+        {
+            if (C != Last && Num < MaxCode) OutCode[Num++] = C;
+            Last = C;
+        };
+
+    const int32 Len = Key.Len();
+    for (int32 i = 0; i < Len; ++i)
+    {
+        const TCHAR C = Key[i];
+        const TCHAR Prev = i > 0 ? Key[i - 1] : 0;
+        const TCHAR Next = i + 1 < Len ? Key[i + 1] : 0;
+        const bool bSoftNext = Next == TEXT('e') || Next == TEXT('i') || Next == TEXT('y');
+
+        if (FChar::IsDigit(C)) { Emit(C); continue; }
+        if (IsVowel(C)) { if (i == 0) Emit(TEXT('A')); continue; }
+
+        switch (C)
+        {
+        case TEXT('b'): if (!(Prev == TEXT('m') && i + 1 == Len)) Emit(TEXT('P')); break;
+        case TEXT('c'):
+            if (Next == TEXT('h')) { Emit(TEXT('X')); ++i; }
+            else Emit(bSoftNext ? TEXT('S') : TEXT('K'));
+            break;
+        case TEXT('d'): Emit(TEXT('T')); break;
+        case TEXT('f'):
+        case TEXT('v'): Emit(TEXT('F')); break;
+        case TEXT('g'):
+            if (Next == TEXT('h')) { if (i == 0) Emit(TEXT('K')); ++i; }
+            else Emit(bSoftNext ? TEXT('J') : TEXT('K'));
+            break;
+        case TEXT('h'): if (IsVowel(Next) && (i == 0 || IsVowel(Prev))) Emit(TEXT('H')); break;
+        case TEXT('j'): Emit(TEXT('J')); break;
+        case TEXT('k'):
+        case TEXT('q'): Emit(TEXT('K')); break;
+        case TEXT('p'):
+            if (Next == TEXT('h')) { Emit(TEXT('F')); ++i; }
+            else Emit(TEXT('P'));
+            break;
+        case TEXT('s'):
+            if (Next == TEXT('h')) { Emit(TEXT('X')); ++i; }
+            else Emit(TEXT('S'));
+            break;
+        case TEXT('t'):
+            if (Next == TEXT('h')) { Emit(TEXT('0')); ++i; }
+            else Emit(TEXT('T'));
+            break;
+        case TEXT('w'):
+        case TEXT('y'): if (IsVowel(Next)) Emit(FChar::ToUpper(C)); break;
+        case TEXT('x'): Emit(TEXT('K')); Emit(TEXT('S')); break;
+        case TEXT('z'): Emit(TEXT('S')); break;
+        default: Emit(FChar::ToUpper(C)); break;
+        }
+    }
+    return Num;
+}
+
+int32 FACEFuzzyIndex::BoundedEditDistance(FStringView A, FStringView B, int32 MaxEdits)
+{
+    const int32 La = A.Len();
+    const int32 Lb = B.Len();
+    if (FMath::Abs(La - Lb) > MaxEdits) return MaxEdits + 1;
+
+    TArray<int32, TInlineAllocator<MaxFuzzyKeyChars + 1>> Row;
+    Row.SetNumUninitialized(Lb + 1);
+    for (int32 j = 0; j <= Lb; ++j) Row[j] = j;
+
+    for (int32 i = 1; i <= La; ++i)
+    {
+        int32 Diagonal = Row[0];
+        Row[0] = i;
+        int32 RowMin = Row[0];
+        for (int32 j = 1; j <= Lb; ++j)
+        {
+            const int32 Above = Row[j];
+            Row[j] = FMath::Min(FMath::Min(Above, Row[j - 1]) + 1, Diagonal + (A[i - 1] == B[j - 1] ? 0 : 1));
+            Diagonal = Above;
+            RowMin = FMath::Min(RowMin, Row[j]);
+        }
+        if (RowMin > MaxEdits) return MaxEdits + 1;
+    }
+    return FMath::Min(Row[Lb], MaxEdits + 1);
+}
+
+int32 FACEFuzzyIndex::Query(FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter) const
+{
+    const int32 K = OutHits.Num();
+    if (K == 0 || NumKeys() == 0) return 0;
+
+    FFuzzyScratch& S = GFuzzyScratch;
+    S.Best.Reset();
+    auto Record = [&S, this](int32 Key, float Similarity)
+        {
+            const int32 Doc = KeyDocView[Key];
+            FACERetrievalHit* Existing = S.Best.FindByPredicate([Doc](const FACERetrievalHit& H) { return H.Doc == Doc; });
+            if (!Existing) S.Best.Add({ Doc, Similarity });
+            else Existing->Score = FMath::Max(Existing->Score, Similarity);
+        };
+
+    FStringView Tokens[MaxFuzzyQueryTokens];
+    int32 NumTokens = 0;
+    FACERetrievalIndex::ForEachToken(Query, [&Tokens, &NumTokens](FStringView Token)
+        {
+            if (NumTokens < MaxFuzzyQueryTokens) Tokens[NumTokens++] = Token;
+        });
+
+    TCHAR Span[MaxFuzzyKeyChars];
+    uint32 SpanGrams[MaxFuzzyKeyChars];
+    TCHAR Code[MaxFuzzyKeyChars * 2];
+    for (int32 First = 0; First < NumTokens; ++First)
+    {
+        int32 SpanLen = 0;
+        for (int32 Last = First; Last < NumTokens && Last - First < MaxFuzzySpanTokens; ++Last)
+        {
+            // Spans that fill the buffer are as long as keys get (or longer); stop there.
+            const int32 Added = NormalizeKey(Tokens[Last], Span + SpanLen, MaxFuzzyKeyChars - SpanLen);
+            if (SpanLen + Added >= MaxFuzzyKeyChars) break;
+            SpanLen += Added;
+            const FStringView SpanView(Span, SpanLen);
+            const int32 Edits = AllowedEdits(SpanLen);
+
+            // Trigram side: a key within Edits edits shares at least max(len) - 3 * Edits trigrams.
+            S.BeginSpan(NumKeys());
+            const int32 NumGrams = KeyTrigrams(SpanView, SpanGrams);
+            for (int32 g = 0; g < NumGrams; ++g)
+            {
+                const int32 At = Algo::BinarySearch(GramHashView, SpanGrams[g]);
+                if (At == INDEX_NONE) continue;
+                for (int32 p = GramStartView[At]; p < GramStartView[At + 1]; ++p)
+                {
+                    const int32 Key = GramKeyView[p];
+                    if (S.KeyStamp[Key] != S.Stamp)
+                    {
+                        S.KeyStamp[Key] = S.Stamp;
+                        S.KeyCount[Key] = 0;
+                        S.Touched.Add(Key);
+                    }
+                    ++S.KeyCount[Key];
+                }
+            }
+            for (const int32 Key : S.Touched)
+            {
+                const FStringView KeyView = GetKey(Key);
+                const int32 MaxLen = FMath::Max(SpanLen, KeyView.Len());
+                if (FMath::Abs(SpanLen - KeyView.Len()) > Edits || S.KeyCount[Key] < MaxLen - 3 * Edits) continue;
+                if (!Filter.Passes(KeyDocView[Key])) continue;
+                const int32 Distance = BoundedEditDistance(SpanView, KeyView, Edits);
+                if (Distance <= Edits) Record(Key, 1.f - (float)Distance / MaxLen);
+            }
+
+            // Phonetic side: same sound, looser spelling bound.
+            const int32 CodeLen = Encode(SpanView, Code, UE_ARRAY_COUNT(Code));
+            if (CodeLen < MinPhoneticCode) continue;
+            const uint32 PhoneticHash = HashChars(Code, CodeLen);
+            for (int32 p = Algo::LowerBound(PhoneHashView, PhoneticHash); p < PhoneHashView.Num() && PhoneHashView[p] == PhoneticHash; ++p)
+            {
+                if (!Filter.Passes(KeyDocView[PhoneKeyView[p]])) continue;
+                const FStringView KeyView = GetKey(PhoneKeyView[p]);
+                const int32 MaxLen = FMath::Max(SpanLen, KeyView.Len());
+                const int32 Distance = BoundedEditDistance(SpanView, KeyView, (MaxLen + 1) / 2);
+                if (Distance <= (MaxLen + 1) / 2) Record(PhoneKeyView[p], 1.f - (float)Distance / MaxLen);
+            }
+        }
+    }
+
+    S.Best.Sort([](const FACERetrievalHit& A, const FACERetrievalHit& B) { return FuzzyWeakerHit(B, A); });
+    const int32 Count = FMath::Min(K, S.Best.Num());
+    for (int32 i = 0; i < Count; ++i) OutHits[i] = S.Best[i];
+    return Count;
+}
+
+int32 FACEFuzzyIndex::Rescore(FStringView Query, TArrayView<FACERetrievalHit> Hits, int32 NumHits, const FACEDocFilter& Filter) const
+{
+    const float Weight = ACEFuzzy::GetWeight();
+    const int32 K = Hits.Num();
+    if (Weight <= 0.f || K == 0 || NumKeys() == 0) return NumHits;
+
+    TArray<FACERetrievalHit, TInlineAllocator<16>> Fuzzy;
+    Fuzzy.SetNumUninitialized(K);
+    Fuzzy.SetNum(this->Query(Query, Fuzzy, Filter), EAllowShrinking::No);
+    if (Fuzzy.Num() == 0) return NumHits;
+
+    // Documents outside the original top K enter with their fuzzy score alone.
+    TArray<FACERetrievalHit, TInlineAllocator<32>> Combined(Hits.GetData(), NumHits);
+    for (const FACERetrievalHit& F : Fuzzy)
+    {
+        FACERetrievalHit* Existing = Combined.FindByPredicate([&F](const FACERetrievalHit& H) { return H.Doc == F.Doc; });
+        if (Existing) Existing->Score += Weight * F.Score;
+        else Combined.Add({ F.Doc, Weight * F.Score });
+    }
+
+    Combined.Sort([](const FACERetrievalHit& A, const FACERetrievalHit& B) { return FuzzyWeakerHit(B, A); });
+    const int32 Count = FMath::Min(K, Combined.Num());
+    for (int32 i = 0; i < Count; ++i) Hits[i] = Combined[i];
+    return Count;
+}
+
+SIZE_T FACEFuzzyIndex::GetAllocatedSize() const
+{
+    if (bAttached)
+    {
+        return KeyCharsView.Num() * sizeof(TCHAR)
+            + (KeyStartView.Num() + KeyDocView.Num() + GramStartView.Num() + GramKeyView.Num() + PhoneKeyView.Num()) * sizeof(int32)
+            + (GramHashView.Num() + PhoneHashView.Num()) * sizeof(uint32);
+    }
+    return KeyChars.GetAllocatedSize() + KeyStart.GetAllocatedSize() + KeyDoc.GetAllocatedSize()
+        + GramHash.GetAllocatedSize() + GramStart.GetAllocatedSize() + GramKey.GetAllocatedSize()
+        + PhoneHash.GetAllocatedSize() + PhoneKey.GetAllocatedSize();
+}
+
+void FACEFuzzyIndex::Write(TArray<uint8>& Out) const
+{
+    using namespace ACERetrievalBlob;
+
+    FFuzzySectionHeader H;
+    H.NumDocs = NumIndexedDocs;
+    H.NumKeys = KeyDocView.Num();
+    H.NumChars = KeyCharsView.Num();
+    H.NumGrams = GramHashView.Num();
+    H.NumGramKeys = GramKeyView.Num();
+    H.NumPhones = PhoneHashView.Num();
+    Pad16(Out);
+    WritePod(Out, H);
+    WriteArray(Out, KeyCharsView);
+    WriteArray(Out, KeyStartView);
+    WriteArray(Out, KeyDocView);
+    WriteArray(Out, GramHashView);
+    WriteArray(Out, GramStartView);
+    WriteArray(Out, GramKeyView);
+    WriteArray(Out, PhoneHashView);
+    WriteArray(Out, PhoneKeyView);
+}
+
+bool FACEFuzzyIndex::Attach(const uint8*& Cursor, const uint8* End)
+{
+    using namespace ACERetrievalBlob;
+    BeginBuild();
+
+    FFuzzySectionHeader H;
+    const uint8* C = reinterpret_cast<const uint8*>(::Align(reinterpret_cast<UPTRINT>(Cursor), 16));
+    if (C > End || !ReadPod(C, End, H) || H.NumDocs < 0 || H.NumKeys < 0) return false;
+
+    const bool bRead = ReadArray(C, End, H.NumChars, KeyCharsView)
+        && ReadArray(C, End, H.NumKeys + 1, KeyStartView)
+        && ReadArray(C, End, H.NumKeys, KeyDocView)
+        && ReadArray(C, End, H.NumGrams, GramHashView)
+        && ReadArray(C, End, H.NumGrams + 1, GramStartView)
+        && ReadArray(C, End, H.NumGramKeys, GramKeyView)
+        && ReadArray(C, End, H.NumPhones, PhoneHashView)
+        && ReadArray(C, End, H.NumPhones, PhoneKeyView);
+
+    // Offsets and ids are checked once so queries can index without bounds checks.
+    bool bValid = bRead && KeyStartView[0] == 0 && KeyStartView[H.NumKeys] == H.NumChars
+        && GramStartView[0] == 0 && GramStartView[H.NumGrams] == H.NumGramKeys;
+    for (int32 k = 0; bValid && k < H.NumKeys; ++k)
+    {
+        const int32 Len = KeyStartView[k + 1] - KeyStartView[k];
+        bValid = Len > 0 && Len <= MaxFuzzyKeyChars && KeyDocView[k] >= 0 && KeyDocView[k] < H.NumDocs;
+    }
+    for (int32 g = 0; bValid && g < H.NumGrams; ++g) bValid = GramStartView[g] <= GramStartView[g + 1];
+    for (int32 p = 0; bValid && p < H.NumGramKeys; ++p) bValid = GramKeyView[p] >= 0 && GramKeyView[p] < H.NumKeys;
+    for (int32 p = 0; bValid && p < H.NumPhones; ++p) bValid = PhoneKeyView[p] >= 0 && PhoneKeyView[p] < H.NumKeys;
+    if (!bValid)
+    {
+        BeginBuild();
+        return false;
+    }
+
+    NumIndexedDocs = H.NumDocs;
+    bAttached = true;
+    Cursor = C;
+    return true;
+}
+
+float ACEFuzzy::GetWeight()
+{
+    return CVarACE_FuzzyWeight.GetValueOnAnyThread();
+}
+
+int32 ACEFuzzy::GetMaxEdits()
+{
+    return FMath::Max(0, CVarACE_FuzzyMaxEdits.GetValueOnAnyThread());
+}
@@ -0,0 +1,415 @@
+#include "ACEHnswIndex.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+static TAutoConsoleVariable<int32> CVarACE_HnswMinDocs(
+    TEXT("ace.Hnsw.MinDocs"),
+    5000,
+    TEXT("Registries with at least this many entries get an HNSW graph for dense retrieval; smaller ones are scanned. ")
+    TEXT("0 disables the graph. Read when a registry is (re)built."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarACE_HnswM(
+    TEXT("ace.Hnsw.M"),
+    16,
+    TEXT("HNSW links per node (layer 0 keeps twice as many). Higher improves recall at the cost of memory and build time."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarACE_HnswEfConstruction(
+    TEXT("ace.Hnsw.EfConstruction"),
+    100,
+    TEXT("HNSW candidate list size while building. Higher gives a better graph and a slower build."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarACE_HnswEfSearch(
+    TEXT("ace.Hnsw.EfSearch"),
+    64,
+    TEXT("HNSW candidate list size per query (never below K). Raise it until -run=ACEHnswBench reports the recall you need."),
+    ECVF_Default);
+
+namespace
+{
+    constexpr int32 MaxHnswLayers = 16;
+
+    bool HnswWorse(const FACERetrievalHit& A, const FACERetrievalHit& B)
+    {
+        return A.Score < B.Score || (A.Score == B.Score && A.Doc > B.Doc);
+    }
+
+    bool HnswBetter(const FACERetrievalHit& A, const FACERetrievalHit& B)
+    {
+        return HnswWorse(B, A);
+    }
+
+    struct FHnswSectionHeader
+    {
+        int32 NumNodes = 0;
+        int32 M = 0;
+        int32 EntryPoint = INDEX_NONE;
+        int32 MaxLevel = -1;
+        int32 NumLinks = 0;
+    };
+
+    // Per-thread search state: visited marks are generation stamps, so a search never clears them.
+    struct FHnswScratch
+    {
+        TArray<uint32> Visited;
+        uint32 Stamp = 0;
+        TArray<FACERetrievalHit> Candidates;
+        TArray<FACERetrievalHit> Found;
+
+        void BeginVisit(int32 NumNodes)
+        {
+            if (Visited.Num() < NumNodes)
+            {
+                Visited.SetNumZeroed(NumNodes);
+            }
+            if (++Stamp == 0)
+            {
+                FMemory::Memzero(Visited.GetData(), Visited.Num() * sizeof(uint32));
+                Stamp = 1;
+            }
+        }
+
+        bool Visit(int32 Node)
+        {
+            if (Visited[Node] == Stamp) return false;
+            Visited[Node] = Stamp;
+            return true;
+        }
+    };
+
+    thread_local FHnswScratch GHnswScratch;
+}
+
+FACEHnswIndex& FACEHnswIndex::operator=(const FACEHnswIndex& Other)
+{
+    M = Other.M;
+    EntryPoint = Other.EntryPoint;
+    MaxLevel = Other.MaxLevel;
+    Levels = Other.Levels;
+    LinkStart = Other.LinkStart;
+    Links = Other.Links;
+    bAttached = Other.bAttached;
+    if (bAttached)
+    {
+        LevelsView = Other.LevelsView;
+        LinkStartView = Other.LinkStartView;
+        LinksView = Other.LinksView;
+    }
+    else
+    {
+        SyncViews();
+    }
+    return *this;
+}
+
+void FACEHnswIndex::SyncViews()
+{
+    LevelsView = Levels;
+    LinkStartView = LinkStart;
+    LinksView = Links;
+}
+
+void FACEHnswIndex::Reset()
+{
+    M = 0;
+    EntryPoint = INDEX_NONE;
+    MaxLevel = -1;
+    Levels.Empty();
+    LinkStart.Empty();
+    Links.Empty();
+    bAttached = false;
+    SyncViews();
+}
+
+void FACEHnswIndex::Build(const FACEDenseIndex& Vectors, const FACEHnswParams& Params)
+{
+    Reset();
+    const int32 N = Vectors.NumDocs();
+    if (N == 0) return;
+
+    M = FMath::Clamp(Params.M, 2, 64);
+    const int32 EfConstruction = FMath::Max(Params.EfConstruction, M);
+
+    // Layer of each node drawn up front (P(layer >= l) = M^-l), so every link block can be
+    // allocated before the first insert. Fixed seed keeps rebuilds of the same data identical.
+    FRandomStream Rng(0x41434548);
+    const double LevelMult = 1.0 / FMath::Loge((double)M);
+    Levels.SetNumUninitialized(N);
+    LinkStart.SetNumUninitialized(N + 1);
+    int32 NumSlots = 0;
+    for (int32 Node = 0; Node < N; ++Node)
+    {
+        const double U = 1.0 - (double)Rng.GetFraction();
+        const int32 Level = FMath::Min((int32)(-FMath::Loge(U) * LevelMult), MaxHnswLayers - 1);
+        Levels[Node] = (uint8)Level;
+        LinkStart[Node] = NumSlots;
+        NumSlots += LayerOffset(Level + 1);
+    }
+    LinkStart[N] = NumSlots;
+    Links.SetNumZeroed(NumSlots);
+    SyncViews();
+
+    for (int32 Node = 0; Node < N; ++Node)
+    {
+        Insert(Vectors, Node, EfConstruction);
+    }
+}
+
+template<typename SimilarityFn>
+int32 FACEHnswIndex::GreedyClosest(int32 Entry, int32 Layer, SimilarityFn&& Similarity) const
+{
+    int32 Best = Entry;
+    float BestScore = Similarity(Entry);
+    for (bool bMoved = true; bMoved;)
+    {
+        bMoved = false;
+        const int32* Block = GetLayer(Best, Layer);
+        for (int32 i = 1; i <= Block[0]; ++i)
+        {
+            const float S = Similarity(Block[i]);
+            if (S > BestScore)
+            {
+                BestScore = S;
+                Best = Block[i];
+                bMoved = true;
+            }
+        }
+    }
+    return Best;
+}
+
+template<typename SimilarityFn>
+void FACEHnswIndex::SearchLayer(int32 Entry, int32 Layer, int32 Ef, SimilarityFn&& Similarity, TArray<FACERetrievalHit>& OutResults) const
+{
+    FHnswScratch& Scratch = GHnswScratch;
+    Scratch.BeginVisit(NumNodes());
+    TArray<FACERetrievalHit>& Candidates = Scratch.Candidates;
+    Candidates.Reset();
+    OutResults.Reset();
+
+    // Candidates pop closest first; OutResults keeps its worst on top so it can be trimmed to Ef.
+    const FACERetrievalHit Start{ Entry, Similarity(Entry) };
+    Scratch.Visit(Entry);
+    Candidates.HeapPush(Start, HnswBetter);
+    OutResults.HeapPush(Start, HnswWorse);
+
+    while (Candidates.Num() > 0)
+    {
+        FACERetrievalHit Current;
+        Candidates.HeapPop(Current, HnswBetter, EAllowShrinking::No);
+        if (OutResults.Num() >= Ef && Current.Score < OutResults.HeapTop().Score) break;
+
+        const int32* Block = GetLayer(Current.Doc, Layer);
+        for (int32 i = 1; i <= Block[0]; ++i)
+        {
+            const int32 Next = Block[i];
+            if (!Scratch.Visit(Next)) continue;
+            const float S = Similarity(Next);
+            if (OutResults.Num() < Ef || S > OutResults.HeapTop().Score)
+            {
+                Candidates.HeapPush({ Next, S }, HnswBetter);
+                OutResults.HeapPush({ Next, S }, HnswWorse);
+                if (OutResults.Num() > Ef) OutResults.HeapPopDiscard(HnswWorse, EAllowShrinking::No);
+            }
+        }
+    }
+    OutResults.Sort(HnswBetter);
+}
+
+void FACEHnswIndex::SelectNeighbors(const FACEDenseIndex& Vectors, TArray<FACERetrievalHit>& Candidates, int32 Cap) const
+{
+    // Keep a candidate only if it is closer to the node than to every neighbour kept so far, so
+    // links spread across clusters instead of piling into the nearest one. Candidates are best first.
+    int32 Kept = 0;
+    for (int32 i = 0; i < Candidates.Num() && Kept < Cap; ++i)
+    {
+        const FACERetrievalHit Candidate = Candidates[i];
+        bool bDiverse = true;
+        for (int32 j = 0; j < Kept && bDiverse; ++j)
+        {
+            bDiverse = Vectors.ScoreDocs(Candidate.Doc, Candidates[j].Doc) <= Candidate.Score;
+        }
+        if (bDiverse) Candidates[Kept++] = Candidate;
+    }
+    Candidates.SetNum(Kept, EAllowShrinking::No);
+}
+
+void FACEHnswIndex::Insert(const FACEDenseIndex& Vectors, int32 Node, int32 EfConstruction)
+{
+    const int32 Level = Levels[Node];
+    if (EntryPoint == INDEX_NONE)
+    {
+        EntryPoint = Node;
+        MaxLevel = Level;
+        return;
+    }
+
+    auto Similarity = [&Vectors, Node](int32 Other) { return Vectors.ScoreDocs(Node, Other); };
+
+    int32 Entry = EntryPoint;
+    for (int32 Layer = MaxLevel; Layer > Level; --Layer)
+    {
+        Entry = GreedyClosest(Entry, Layer, Similarity);
+    }
+
+    TArray<FACERetrievalHit> Neighbors;
+    TArray<FACERetrievalHit> Pool;
+    for (int32 Layer = FMath::Min(Level, MaxLevel); Layer >= 0; --Layer)
+    {
+        SearchLayer(Entry, Layer, EfConstruction, Similarity, Neighbors);
+        Entry = Neighbors[0].Doc;
+        SelectNeighbors(Vectors, Neighbors, M);
+
+        int32* Own = GetMutableLayer(Node, Layer);
+        Own[0] = Neighbors.Num();
+        for (int32 i = 0; i < Neighbors.Num(); ++i) Own[i + 1] = Neighbors[i].Doc;
+
+        const int32 Cap = LayerCap(Layer);
+        for (const FACERetrievalHit& Neighbor : Neighbors)
+        {
+            int32* Theirs = GetMutableLayer(Neighbor.Doc, Layer);
+            if (Theirs[0] < Cap)
+            {
+                Theirs[++Theirs[0]] = Node;
+                continue;
+            }
+
+            // Full: re-select the neighbour's links from its current ones plus the new node.
+            Pool.Reset();
+            Pool.Add({ Node, Neighbor.Score });
+            for (int32 i = 1; i <= Theirs[0]; ++i) Pool.Add({ Theirs[i], Vectors.ScoreDocs(Neighbor.Doc, Theirs[i]) });
+            Pool.Sort(HnswBetter);
+            SelectNeighbors(Vectors, Pool, Cap);
+            Theirs[0] = Pool.Num();
+            for (int32 i = 0; i < Pool.Num(); ++i) Theirs[i + 1] = Pool[i].Doc;
+        }
+    }
+
+    if (Level > MaxLevel)
+    {
+        MaxLevel = Level;
+        EntryPoint = Node;
+    }
+}
+
+int32 FACEHnswIndex::Search(const FACEDenseIndex& Vectors, const int8* QueryVector, float QueryScale, int32 Ef, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter) const
+{
+    const int32 K = OutHits.Num();
+    if (K <= 0 || !IsBuilt() || Vectors.NumDocs() != NumNodes() || QueryScale <= 0.f) return 0;
+
+    auto Similarity = [&Vectors, QueryVector, QueryScale](int32 Doc) { return Vectors.Score(QueryVector, QueryScale, Doc); };
+
+    int32 Entry = EntryPoint;
+    for (int32 Layer = MaxLevel; Layer > 0; --Layer)
+    {
+        Entry = GreedyClosest(Entry, Layer, Similarity);
+    }
+
+    TArray<FACERetrievalHit>& Found = GHnswScratch.Found;
+    SearchLayer(Entry, 0, FMath::Max(Ef, K), Similarity, Found);
+
+    int32 Count = 0;
+    for (const FACERetrievalHit& H : Found)
+    {
+        if (Count == K || H.Score <= 0.f) break;
+        if (Filter.Passes(H.Doc)) OutHits[Count++] = H;
+    }
+    return Count;
+}
+
+SIZE_T FACEHnswIndex::GetAllocatedSize() const
+{
+    if (bAttached)
+    {
+        return LevelsView.Num() + (LinkStartView.Num() + LinksView.Num()) * sizeof(int32);
+    }
+    return Levels.GetAllocatedSize() + LinkStart.GetAllocatedSize() + Links.GetAllocatedSize();
+}
+
+void FACEHnswIndex::Write(TArray<uint8>& Out) const
+{
+    using namespace ACERetrievalBlob;
+
+    FHnswSectionHeader H;
+    H.NumNodes = NumNodes();
+    H.M = M;
+    H.EntryPoint = EntryPoint;
+    H.MaxLevel = MaxLevel;
+    H.NumLinks = LinksView.Num();
+    Pad16(Out);
+    WritePod(Out, H);
+    WriteArray(Out, LevelsView);
+    WriteArray(Out, LinkStartView);
+    WriteArray(Out, LinksView);
+}
+
+bool FACEHnswIndex::Attach(const uint8*& Cursor, const uint8* End)
+{
+    using namespace ACERetrievalBlob;
+    Reset();
+
+    FHnswSectionHeader H;
+    const uint8* C = reinterpret_cast<const uint8*>(::Align(reinterpret_cast<UPTRINT>(Cursor), 16));
+    if (C > End || !ReadPod(C, End, H) || H.NumNodes < 0) return false;
+    if (H.NumNodes == 0)
+    {
+        Cursor = C;
+        return true;
+    }
+
+    M = H.M;
+    EntryPoint = H.EntryPoint;
+    MaxLevel = H.MaxLevel;
+    const bool bRead = M >= 2 && M <= 64 && EntryPoint >= 0 && EntryPoint < H.NumNodes && MaxLevel >= 0 && MaxLevel < MaxHnswLayers
+        && ReadArray(C, End, H.NumNodes, LevelsView)
+        && ReadArray(C, End, H.NumNodes + 1, LinkStartView)
+        && ReadArray(C, End, H.NumLinks, LinksView);
+
+    // Every block and link is checked once here so searches can index without bounds checks.
+    // Searches start at the entry point's top layer, so it must have one at MaxLevel.
+    bool bValid = bRead && LinkStartView[0] == 0 && LinkStartView[H.NumNodes] == H.NumLinks && LevelsView[EntryPoint] == MaxLevel;
+    for (int32 Node = 0; bValid && Node < H.NumNodes; ++Node)
+    {
+        const int32 Level = LevelsView[Node];
+        bValid = Level >= 0 && Level <= MaxLevel && LinkStartView[Node + 1] - LinkStartView[Node] == LayerOffset(Level + 1);
+        for (int32 Layer = 0; bValid && Layer <= Level; ++Layer)
+        {
+            const int32* Block = GetLayer(Node, Layer);
+            bValid = Block[0] >= 0 && Block[0] <= LayerCap(Layer);
+            for (int32 i = 1; bValid && i <= Block[0]; ++i)
+            {
+                bValid = Block[i] >= 0 && Block[i] < H.NumNodes && LevelsView[Block[i]] >= Layer;
+            }
+        }
+    }
+    if (!bValid)
+    {
+        Reset();
+        return false;
+    }
+
+    bAttached = true;
+    Cursor = C;
+    return true;
+}
+
+FACEHnswParams ACEHnsw::GetBuildParams()
+{
+    FACEHnswParams Params;
+    Params.M = CVarACE_HnswM.GetValueOnAnyThread();
+    Params.EfConstruction = CVarACE_HnswEfConstruction.GetValueOnAnyThread();
+    return Params;
+}
+
+int32 ACEHnsw::GetEfSearch()
+{
+    return FMath::Max(1, CVarACE_HnswEfSearch.GetValueOnAnyThread());
+}
+
+bool ACEHnsw::ShouldBuild(int32 NumDocs)
+{
+    const int32 MinDocs = CVarACE_HnswMinDocs.GetValueOnAnyThread();
+    return MinDocs > 0 && NumDocs >= MinDocs;
+}
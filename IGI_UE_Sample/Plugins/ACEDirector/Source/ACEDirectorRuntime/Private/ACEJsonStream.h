@@ -0,0 +1,80 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+
+// Helpers for walking registry JSON token by token with TJsonReader instead of building a DOM.
+// Each takes the notation that was just read for the value it consumes.
+namespace ACEJsonStream
+{
+    inline bool SkipValue(TJsonReader<TCHAR>& Reader, EJsonNotation Notation)
+    {
+        if (Notation == EJsonNotation::ObjectStart) return Reader.SkipObject();
+        if (Notation == EJsonNotation::ArrayStart) return Reader.SkipArray();
+        return Notation != EJsonNotation::Error;
+    }
+
+    // Appends the string items of an array; other items are skipped.
+    inline bool ReadStringArray(TJsonReader<TCHAR>& Reader, TArray<FString>& Out)
+    {
+        EJsonNotation Notation;
+        while (Reader.ReadNext(Notation))
+        {
+            if (Notation == EJsonNotation::ArrayEnd) return true;
+            if (Notation == EJsonNotation::String) Out.Add(Reader.GetValueAsString());
+            else if (!SkipValue(Reader, Notation)) return false;
+        }
+        return false;
+    }
+
+    // Re-serializes one value (without its key) so a nested object or array can be kept as text.
+    inline bool CaptureValue(TJsonReader<TCHAR>& Reader, EJsonNotation Notation, FString& Out)
+    {
+        Out.Reset();
+        auto Writer = TJsonWriterFactory<>::Create(&Out);
+
+        static const FString NoIdentifier;
+        int32 Depth = 0;
+        bool bFirst = true;
+        do
+        {
+            const FString& Id = bFirst ? NoIdentifier : Reader.GetIdentifier();
+            bFirst = false;
+
+            switch (Notation)
+            {
+            case EJsonNotation::ObjectStart:
+                if (Id.IsEmpty()) Writer->WriteObjectStart(); else Writer->WriteObjectStart(Id);
+                ++Depth;
+                break;
+            case EJsonNotation::ArrayStart:
+                if (Id.IsEmpty()) Writer->WriteArrayStart(); else Writer->WriteArrayStart(Id);
+                ++Depth;
+                break;
+            case EJsonNotation::ObjectEnd: Writer->WriteObjectEnd(); --Depth; break;
+            case EJsonNotation::ArrayEnd:  Writer->WriteArrayEnd();  --Depth; break;
+            case EJsonNotation::String:
+                if (Id.IsEmpty()) Writer->WriteValue(Reader.GetValueAsString()); else Writer->WriteValue(Id, Reader.GetValueAsString());
+                break;
+            case EJsonNotation::Number:
+                if (Id.IsEmpty()) Writer->WriteValue(Reader.GetValueAsNumber()); else Writer->WriteValue(Id, Reader.GetValueAsNumber());
+                break;
+            case EJsonNotation::Boolean:
+                if (Id.IsEmpty()) Writer->WriteValue(Reader.GetValueAsBoolean()); else Writer->WriteValue(Id, Reader.GetValueAsBoolean());
+                break;
+            case EJsonNotation::Null:
+                if (Id.IsEmpty()) Writer->WriteNull(); else Writer->WriteNull(Id);
+                break;
+            default:
+                return false;
+            }
+
+            if (Depth == 0)
+            {
+                return Writer->Close();
+            }
+        } while (Reader.ReadNext(Notation));
+
+        return false;
+    }
+}
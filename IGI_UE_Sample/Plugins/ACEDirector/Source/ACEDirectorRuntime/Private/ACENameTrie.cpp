@@ -0,0 +1,352 @@
+#include "ACENameTrie.h"
+
+namespace
+{
+    // Reads text the way keys are stored: lowercase, leading whitespace dropped and every
+    // whitespace run seen as a single space.
+    struct FNameTrieCursor
+    {
+        FStringView Text;
+        int32 Pos = 0;
+
+        explicit FNameTrieCursor(FStringView InText)
+            : Text(InText)
+        {
+            while (Pos < Text.Len() && FChar::IsWhitespace(Text[Pos])) ++Pos;
+        }
+
+        bool AtEnd() const { return Pos >= Text.Len(); }
+        bool AtBoundary() const { return AtEnd() || FChar::IsWhitespace(Text[Pos]); }
+        TCHAR Peek() const { return FChar::IsWhitespace(Text[Pos]) ? TEXT(' ') : FChar::ToLower(Text[Pos]); }
+
+        void Advance()
+        {
+            if (!FChar::IsWhitespace(Text[Pos]))
+            {
+                ++Pos;
+                return;
+            }
+            while (Pos < Text.Len() && FChar::IsWhitespace(Text[Pos])) ++Pos;
+        }
+    };
+
+    struct FNameTrieSectionHeader
+    {
+        int32 NumDocs = 0;
+        int32 NumNodes = 0;
+        int32 NumLabels = 0;
+        int32 NumChildren = 0;
+        int32 NumNodeDocs = 0;
+        int32 Reserved[3] = {};
+    };
+}
+
+FACENameTrie& FACENameTrie::operator=(const FACENameTrie& Other)
+{
+    NumIndexedDocs = Other.NumIndexedDocs;
+    Pending = Other.Pending;
+    Labels = Other.Labels;
+    LabelStart = Other.LabelStart;
+    ChildStart = Other.ChildStart;
+    Children = Other.Children;
+    DocStart = Other.DocStart;
+    NodeDocs = Other.NodeDocs;
+    bAttached = Other.bAttached;
+    if (bAttached)
+    {
+        LabelsView = Other.LabelsView;
+        LabelStartView = Other.LabelStartView;
+        ChildStartView = Other.ChildStartView;
+        ChildrenView = Other.ChildrenView;
+        DocStartView = Other.DocStartView;
+        NodeDocsView = Other.NodeDocsView;
+    }
+    else
+    {
+        SyncViews();
+    }
+    return *this;
+}
+
+void FACENameTrie::SyncViews()
+{
+    LabelsView = Labels;
+    LabelStartView = LabelStart;
+    ChildStartView = ChildStart;
+    ChildrenView = Children;
+    DocStartView = DocStart;
+    NodeDocsView = NodeDocs;
+}
+
+void FACENameTrie::BeginBuild()
+{
+    NumIndexedDocs = 0;
+    Pending.Reset();
+    Pending.AddDefaulted();
+    Labels.Reset();
+    LabelStart.Reset();
+    ChildStart.Reset();
+    Children.Reset();
+    DocStart.Reset();
+    NodeDocs.Reset();
+    bAttached = false;
+    SyncViews();
+}
+
+void FACENameTrie::AddKey(FStringView Text, int32 Doc)
+{
+    Text = Text.TrimEnd();
+    int32 Node = 0;
+    bool bAny = false;
+    for (FNameTrieCursor Cursor(Text); !Cursor.AtEnd(); Cursor.Advance())
+    {
+        const TCHAR C = Cursor.Peek();
+        int32 Next = INDEX_NONE;
+        for (const TPair<TCHAR, int32>& Child : Pending[Node].Children)
+        {
+            if (Child.Key == C)
+            {
+                Next = Child.Value;
+                break;
+            }
+        }
+        if (Next == INDEX_NONE)
+        {
+            Next = Pending.Num();
+            Pending.AddDefaulted();
+            Pending[Node].Children.Add({ C, Next });
+        }
+        Node = Next;
+        bAny = true;
+    }
+    if (bAny) Pending[Node].Docs.AddUnique(Doc);
+}
+
+void FACENameTrie::AddDocument(FStringView Name, TConstArrayView<FString> Aliases)
+{
+    const int32 Doc = NumIndexedDocs++;
+    AddKey(Name, Doc);
+    for (const FString& Alias : Aliases)
+    {
+        AddKey(Alias, Doc);
+    }
+}
+
+void FACENameTrie::FinishBuild()
+{
+    // Breadth-first, so every node's children get consecutive ids and labels/docs are laid out in
+    // node order. A chain of single-child nodes without documents collapses into one label.
+    TArray<int32> PendingOf;
+    PendingOf.Add(0);
+    LabelStart.Add(0);
+    LabelStart.Add(0);
+    for (int32 Node = 0; Node < PendingOf.Num(); ++Node)
+    {
+        FPendingNode& P = Pending[PendingOf[Node]];
+        ChildStart.Add(Children.Num());
+        DocStart.Add(NodeDocs.Num());
+        NodeDocs.Append(P.Docs);
+
+        P.Children.Sort([](const TPair<TCHAR, int32>& A, const TPair<TCHAR, int32>& B) { return A.Key < B.Key; });
+        for (const TPair<TCHAR, int32>& Child : P.Children)
+        {
+            Labels.Add(Child.Key);
+            int32 Last = Child.Value;
+            while (Pending[Last].Docs.Num() == 0 && Pending[Last].Children.Num() == 1)
+            {
+                Labels.Add(Pending[Last].Children[0].Key);
+                Last = Pending[Last].Children[0].Value;
+            }
+            LabelStart.Add(Labels.Num());
+            Children.Add(PendingOf.Add(Last));
+        }
+    }
+    ChildStart.Add(Children.Num());
+    DocStart.Add(NodeDocs.Num());
+
+    Pending.Empty();
+    Labels.Shrink();
+    LabelStart.Shrink();
+    ChildStart.Shrink();
+    Children.Shrink();
+    DocStart.Shrink();
+    NodeDocs.Shrink();
+    SyncViews();
+}
+
+int32 FACENameTrie::MatchPrefixes(FStringView Text, TArrayView<FACENameMatch> OutMatches) const
+{
+    if (NumNodes() == 0 || OutMatches.Num() == 0) return 0;
+
+    int32 Count = 0;
+    int32 Node = 0;
+    FNameTrieCursor Cursor(Text);
+    for (;;)
+    {
+        if (DocStartView[Node + 1] > DocStartView[Node] && Cursor.AtBoundary())
+        {
+            OutMatches[Count++] = { Node, Cursor.Pos };
+            if (Count == OutMatches.Num()) break;
+        }
+        if (Cursor.AtEnd()) break;
+
+        const TCHAR C = Cursor.Peek();
+        int32 Next = INDEX_NONE;
+        for (int32 i = ChildStartView[Node]; i < ChildStartView[Node + 1]; ++i)
+        {
+            const TCHAR First = LabelsView[LabelStartView[ChildrenView[i]]];
+            if (First == C) Next = ChildrenView[i];
+            if (First >= C) break;
+        }
+        if (Next == INDEX_NONE) break;
+
+        bool bMatched = true;
+        for (int32 l = LabelStartView[Next]; l < LabelStartView[Next + 1] && bMatched; ++l)
+        {
+            bMatched = !Cursor.AtEnd() && Cursor.Peek() == LabelsView[l];
+            if (bMatched) Cursor.Advance();
+        }
+        if (!bMatched) break;
+        Node = Next;
+    }
+    return Count;
+}
+
+int32 FACENameTrie::Complete(FStringView Prefix, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter, double Deadline) const
+{
+    if (NumNodes() == 0 || OutHits.Num() == 0) return 0;
+
+    // Walk the prefix down; it may end inside a label.
+    int32 Node = 0;
+    int32 Depth = 0;    // key characters to the end of Node's label
+    int32 Typed = 0;
+    for (FNameTrieCursor Cursor(Prefix); !Cursor.AtEnd();)
+    {
+        const TCHAR C = Cursor.Peek();
+        int32 Next = INDEX_NONE;
+        for (int32 i = ChildStartView[Node]; i < ChildStartView[Node + 1]; ++i)
+        {
+            const TCHAR First = LabelsView[LabelStartView[ChildrenView[i]]];
+            if (First == C) Next = ChildrenView[i];
+            if (First >= C) break;
+        }
+        if (Next == INDEX_NONE) return 0;
+
+        for (int32 l = LabelStartView[Next]; l < LabelStartView[Next + 1] && !Cursor.AtEnd(); ++l, ++Typed)
+        {
+            if (Cursor.Peek() != LabelsView[l]) return 0;
+            Cursor.Advance();
+        }
+        Depth += LabelStartView[Next + 1] - LabelStartView[Next];
+        Node = Next;
+    }
+    if (Typed == 0) return 0;
+
+    // Expand the subtree shortest key first (labels vary in length, so plain breadth-first would not).
+    TArray<TPair<int32, int32>, TInlineAllocator<64>> Frontier;    // (node, key length)
+    const auto Shorter = [](const TPair<int32, int32>& A, const TPair<int32, int32>& B) { return A.Value < B.Value; };
+    Frontier.HeapPush({ Node, Depth }, Shorter);
+    int32 Count = 0;
+    for (int32 Visited = 1; Frontier.Num() > 0 && Count < OutHits.Num(); ++Visited)
+    {
+        if ((Visited & 63) == 0 && FPlatformTime::Seconds() > Deadline) break;
+
+        TPair<int32, int32> Next;
+        Frontier.HeapPop(Next, Shorter, EAllowShrinking::No);
+        const int32 At = Next.Key;
+        const int32 KeyLen = Next.Value;
+        for (const int32 Doc : GetDocs(At))
+        {
+            if (!Filter.Passes(Doc)) continue;
+            bool bSeen = false;
+            for (int32 h = 0; h < Count && !bSeen; ++h) bSeen = OutHits[h].Doc == Doc;
+            if (bSeen) continue;
+            OutHits[Count++] = { Doc, float(Typed) / float(FMath::Max(KeyLen, Typed)) };
+            if (Count == OutHits.Num()) break;
+        }
+        for (int32 i = ChildStartView[At]; i < ChildStartView[At + 1]; ++i)
+        {
+            const int32 Child = ChildrenView[i];
+            Frontier.HeapPush({ Child, KeyLen + LabelStartView[Child + 1] - LabelStartView[Child] }, Shorter);
+        }
+    }
+    return Count;
+}
+
+SIZE_T FACENameTrie::GetAllocatedSize() const
+{
+    if (bAttached)
+    {
+        return LabelsView.Num() * sizeof(TCHAR)
+            + (LabelStartView.Num() + ChildStartView.Num() + ChildrenView.Num() + DocStartView.Num() + NodeDocsView.Num()) * sizeof(int32);
+    }
+    return Pending.GetAllocatedSize() + Labels.GetAllocatedSize() + LabelStart.GetAllocatedSize() + ChildStart.GetAllocatedSize()
+        + Children.GetAllocatedSize() + DocStart.GetAllocatedSize() + NodeDocs.GetAllocatedSize();
+}
+
+void FACENameTrie::Write(TArray<uint8>& Out) const
+{
+    using namespace ACERetrievalBlob;
+
+    FNameTrieSectionHeader H;
+    H.NumDocs = NumIndexedDocs;
+    H.NumNodes = NumNodes();
+    H.NumLabels = LabelsView.Num();
+    H.NumChildren = ChildrenView.Num();
+    H.NumNodeDocs = NodeDocsView.Num();
+    Pad16(Out);
+    WritePod(Out, H);
+    WriteArray(Out, LabelsView);
+    WriteArray(Out, LabelStartView);
+    WriteArray(Out, ChildStartView);
+    WriteArray(Out, ChildrenView);
+    WriteArray(Out, DocStartView);
+    WriteArray(Out, NodeDocsView);
+}
+
+bool FACENameTrie::Attach(const uint8*& Cursor, const uint8* End)
+{
+    using namespace ACERetrievalBlob;
+    BeginBuild();
+    Pending.Empty();
+
+    FNameTrieSectionHeader H;
+    const uint8* C = reinterpret_cast<const uint8*>(::Align(reinterpret_cast<UPTRINT>(Cursor), 16));
+    if (C > End || !ReadPod(C, End, H) || H.NumDocs < 0 || H.NumNodes < 0) return false;
+    if (H.NumNodes == 0)
+    {
+        NumIndexedDocs = H.NumDocs;
+        bAttached = true;
+        Cursor = C;
+        return true;
+    }
+
+    const bool bRead = ReadArray(C, End, H.NumLabels, LabelsView)
+        && ReadArray(C, End, H.NumNodes + 1, LabelStartView)
+        && ReadArray(C, End, H.NumNodes + 1, ChildStartView)
+        && ReadArray(C, End, H.NumChildren, ChildrenView)
+        && ReadArray(C, End, H.NumNodes + 1, DocStartView)
+        && ReadArray(C, End, H.NumNodeDocs, NodeDocsView);
+
+    // Offsets and ids are checked once so matching can index without bounds checks.
+    bool bValid = bRead && LabelStartView[0] == 0 && LabelStartView[1] == 0 && LabelStartView[H.NumNodes] == H.NumLabels
+        && ChildStartView[0] == 0 && ChildStartView[H.NumNodes] == H.NumChildren
+        && DocStartView[0] == 0 && DocStartView[H.NumNodes] == H.NumNodeDocs;
+    for (int32 n = 0; bValid && n < H.NumNodes; ++n)
+    {
+        bValid = ChildStartView[n] <= ChildStartView[n + 1] && DocStartView[n] <= DocStartView[n + 1]
+            && (n == 0 || LabelStartView[n] < LabelStartView[n + 1]);
+    }
+    for (int32 i = 0; bValid && i < H.NumChildren; ++i) bValid = ChildrenView[i] > 0 && ChildrenView[i] < H.NumNodes;
+    for (int32 i = 0; bValid && i < H.NumNodeDocs; ++i) bValid = NodeDocsView[i] >= 0 && NodeDocsView[i] < H.NumDocs;
+    if (!bValid)
+    {
+        BeginBuild();
+        return false;
+    }
+
+    NumIndexedDocs = H.NumDocs;
+    bAttached = true;
+    Cursor = C;
+    return true;
+}
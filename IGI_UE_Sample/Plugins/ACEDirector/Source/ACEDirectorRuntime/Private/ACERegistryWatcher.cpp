@@ -0,0 +1,57 @@
+#include "ACERegistryWatcher.h"
+#include "Misc/Paths.h"
+
+#if WITH_EDITOR
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#endif
+
+void FACERegistryWatcher::Start(const FString& FilePath, TFunction<void()> InOnChanged)
+{
+#if WITH_EDITOR
+    Stop();
+
+    WatchedFile = FPaths::ConvertRelativePathToFull(FilePath);
+    WatchedDir = FPaths::GetPath(WatchedFile);
+    OnChanged = MoveTemp(InOnChanged);
+
+    FDirectoryWatcherModule& Module = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+    if (IDirectoryWatcher* Watcher = Module.Get())
+    {
+        Watcher->RegisterDirectoryChangedCallback_Handle(WatchedDir,
+            IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FACERegistryWatcher::HandleDirectoryChanged),
+            Handle, /*Flags=*/0);
+    }
+#endif
+}
+
+void FACERegistryWatcher::Stop()
+{
+#if WITH_EDITOR
+    if (!Handle.IsValid()) return;
+
+    if (FDirectoryWatcherModule* Module = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+    {
+        if (IDirectoryWatcher* Watcher = Module->Get())
+        {
+            Watcher->UnregisterDirectoryChangedCallback_Handle(WatchedDir, Handle);
+        }
+    }
+    Handle.Reset();
+#endif
+}
+
+#if WITH_EDITOR
+void FACERegistryWatcher::HandleDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+    for (const FFileChangeData& Change : Changes)
+    {
+        if (Change.Action != FFileChangeData::FCA_Removed && FPaths::IsSamePath(Change.Filename, WatchedFile))
+        {
+            // Editors often save in several steps; one notification batch triggers one reload.
+            if (OnChanged) OnChanged();
+            return;
+        }
+    }
+}
+#endif
@@ -0,0 +1,178 @@
+#include "ACERetrievalCache.h"
+#include "ACEDenseIndex.h"
+#include "ACEFuzzyIndex.h"
+#include "ACEHnswIndex.h"
+#include "ACEStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Retrieval cache hits"), STAT_ACE_RetrievalCacheHits, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Retrieval cache misses"), STAT_ACE_RetrievalCacheMisses, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Retrieval cache invalidations"), STAT_ACE_RetrievalCacheInvalidations, STATGROUP_ACE);
+
+static TAutoConsoleVariable<int32> CVarACE_RetrievalCacheSize(
+    TEXT("ace.RetrievalCacheSize"),
+    256,
+    TEXT("Retrieval results cached per registry (LRU). 0 disables the cache."),
+    ECVF_Default);
+
+namespace
+{
+    // FNV-1a, 64-bit.
+    struct FCacheKeyHash
+    {
+        uint64 Value = 14695981039346656037ull;
+
+        void Add(uint64 Word)
+        {
+            for (int32 Byte = 0; Byte < 8; ++Byte, Word >>= 8)
+            {
+                Value ^= Word & 0xff;
+                Value *= 1099511628211ull;
+            }
+        }
+    };
+}
+
+FACERetrievalCache::FACERetrievalCache()
+{
+    FScopeLock ScopeLock(&Lock);
+    Sync(Generation);
+}
+
+uint64 FACERetrievalCache::MakeKey(FStringView Query, int32 K, const FACEDocFilter& Filter)
+{
+    FCacheKeyHash Key;
+    Key.Add((uint64)(uint32)K);
+    Key.Add((uint64)ACERetrieval::GetMode());
+    Key.Add(FMath::AsUInt(ACERetrieval::GetDenseWeight()));
+    Key.Add((uint64)(uint32)ACEHnsw::GetEfSearch());
+    Key.Add(FMath::AsUInt(ACEFuzzy::GetWeight()));
+    Key.Add((uint64)(uint32)ACEFuzzy::GetMaxEdits());
+    Key.Add((uint64)Filter.Blocked.Num());
+    for (const uint64 Word : Filter.Blocked)
+    {
+        Key.Add(Word);
+    }
+    FACERetrievalIndex::ForEachToken(Query, [&Key](FStringView Token)
+        {
+            Key.Add(TEXT(' '));
+            for (TCHAR C : Token) Key.Add((uint64)FChar::ToLower(C));
+        });
+    return Key.Value;
+}
+
+void FACERetrievalCache::Clear()
+{
+    SlotOf.Reset();
+    NumUsed = 0;
+    Head = Tail = INDEX_NONE;
+}
+
+void FACERetrievalCache::Unlink(int32 Slot)
+{
+    FSlot& S = Slots[Slot];
+    if (S.Prev != INDEX_NONE) Slots[S.Prev].Next = S.Next; else Head = S.Next;
+    if (S.Next != INDEX_NONE) Slots[S.Next].Prev = S.Prev; else Tail = S.Prev;
+    S.Prev = S.Next = INDEX_NONE;
+}
+
+void FACERetrievalCache::LinkFront(int32 Slot)
+{
+    FSlot& S = Slots[Slot];
+    S.Prev = INDEX_NONE;
+    S.Next = Head;
+    if (Head != INDEX_NONE) Slots[Head].Prev = Slot; else Tail = Slot;
+    Head = Slot;
+}
+
+bool FACERetrievalCache::Sync(uint32 InGeneration)
+{
+    const int32 Capacity = CVarACE_RetrievalCacheSize.GetValueOnAnyThread();
+    if (Capacity <= 0)
+    {
+        if (Slots.Num() > 0)
+        {
+            Clear();
+            Slots.Empty();
+            SlotOf.Empty();
+        }
+        return false;
+    }
+    if (Slots.Num() != Capacity)
+    {
+        // The only allocations the cache makes.
+        Clear();
+        Slots.Empty(Capacity);
+        Slots.SetNum(Capacity);
+        SlotOf.Empty(Capacity);
+    }
+    if (InGeneration != Generation)
+    {
+        // Results from an older snapshot are never stored over a newer one.
+        if ((int32)(InGeneration - Generation) < 0) return false;
+        if (NumUsed > 0) INC_DWORD_STAT(STAT_ACE_RetrievalCacheInvalidations);
+        Clear();
+        Generation = InGeneration;
+    }
+    return true;
+}
+
+int32 FACERetrievalCache::Find(uint64 Key, uint32 InGeneration, TArrayView<FACERetrievalHit> OutHits)
+{
+    if (OutHits.Num() > MaxHits) return INDEX_NONE;
+
+    FScopeLock ScopeLock(&Lock);
+    const int32* Slot = Sync(InGeneration) ? SlotOf.Find(Key) : nullptr;
+    if (!Slot || Slots[*Slot].NumHits > OutHits.Num())
+    {
+        INC_DWORD_STAT(STAT_ACE_RetrievalCacheMisses);
+        return INDEX_NONE;
+    }
+
+    INC_DWORD_STAT(STAT_ACE_RetrievalCacheHits);
+    Unlink(*Slot);
+    LinkFront(*Slot);
+    const FSlot& Cached = Slots[*Slot];
+    FMemory::Memcpy(OutHits.GetData(), Cached.Hits, Cached.NumHits * sizeof(FACERetrievalHit));
+    return Cached.NumHits;
+}
+
+void FACERetrievalCache::Add(uint64 Key, uint32 InGeneration, TConstArrayView<FACERetrievalHit> Hits)
+{
+    if (Hits.Num() > MaxHits) return;
+
+    FScopeLock ScopeLock(&Lock);
+    if (!Sync(InGeneration)) return;
+
+    int32 Slot = INDEX_NONE;
+    if (const int32* Existing = SlotOf.Find(Key))
+    {
+        Slot = *Existing;
+        Unlink(Slot);
+    }
+    else if (NumUsed < Slots.Num())
+    {
+        Slot = NumUsed++;
+        SlotOf.Add(Key, Slot);
+    }
+    else
+    {
+        Slot = Tail;
+        Unlink(Slot);
+        SlotOf.Remove(Slots[Slot].Key);
+        SlotOf.Add(Key, Slot);
+    }
+
+    FSlot& S = Slots[Slot];
+    S.Key = Key;
+    S.NumHits = Hits.Num();
+    FMemory::Memcpy(S.Hits, Hits.GetData(), Hits.Num() * sizeof(FACERetrievalHit));
+    LinkFront(Slot);
+}
+
+void FACERetrievalCache::Reset()
+{
+    FScopeLock ScopeLock(&Lock);
+    Clear();
+}
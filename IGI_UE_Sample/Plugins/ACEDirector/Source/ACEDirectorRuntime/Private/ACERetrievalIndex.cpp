@@ -0,0 +1,612 @@
+#include "ACERetrievalIndex.h"
+
+DEFINE_LOG_CATEGORY(LogACERegistry);
+
+namespace
+{
+    // Heap order keeps the weakest hit on top so it can be evicted in O(log K).
+    static bool WeakerHit(const FACERetrievalHit& A, const FACERetrievalHit& B)
+    {
+        return A.Score < B.Score || (A.Score == B.Score && A.Doc > B.Doc);
+    }
+
+    // Reused across queries on the same thread so steady-state retrieval never touches the allocator.
+    struct FQueryScratch
+    {
+        TArray<int32> QTerm;
+        TArray<float> QCount;
+        TArray<uint32> SeenStamp;
+        uint32 Stamp = 0;
+        TArray<FACERetrievalHit> Heap;
+
+        void BeginQuery(int32 NumDocs)
+        {
+            QTerm.Reset();
+            QCount.Reset();
+            Heap.Reset();
+            if (SeenStamp.Num() < NumDocs)
+            {
+                SeenStamp.SetNumZeroed(NumDocs);
+            }
+            if (++Stamp == 0)
+            {
+                FMemory::Memzero(SeenStamp.GetData(), SeenStamp.Num() * sizeof(uint32));
+                Stamp = 1;
+            }
+        }
+    };
+
+    static thread_local FQueryScratch GScratch;
+
+    // Sparse dot product of the (sorted) query vector with one sorted document row.
+    static float MergeJoin(const int32* QT, const float* QW, int32 NumQ, const int32* DT, const float* DW, int32 NumD)
+    {
+        float Dot = 0.f;
+        int32 i = 0, j = 0;
+        while (i < NumQ && j < NumD)
+        {
+            if (QT[i] < DT[j]) ++i;
+            else if (QT[i] > DT[j]) ++j;
+            else { Dot += QW[i] * DW[j]; ++i; ++j; }
+        }
+        return Dot;
+    }
+
+    static void SortRow(TArray<TPair<int32, float>>& Row)
+    {
+        Row.Sort([](const TPair<int32, float>& A, const TPair<int32, float>& B) { return A.Key < B.Key; });
+    }
+}
+
+// ---------------------- FACETermDictionary ----------------------
+
+FACETermDictionary& FACETermDictionary::operator=(const FACETermDictionary& Other)
+{
+    Chars = Other.Chars;
+    TermStart = Other.TermStart;
+    TermHash = Other.TermHash;
+    Slots = Other.Slots;
+    bAttached = Other.bAttached;
+    if (bAttached)
+    {
+        CharsView = Other.CharsView;
+        TermStartView = Other.TermStartView;
+        TermHashView = Other.TermHashView;
+        SlotsView = Other.SlotsView;
+    }
+    else
+    {
+        SyncViews();
+    }
+    return *this;
+}
+
+void FACETermDictionary::SyncViews()
+{
+    CharsView = Chars;
+    TermStartView = TermStart;
+    TermHashView = TermHash;
+    SlotsView = Slots;
+}
+
+void FACETermDictionary::Reset()
+{
+    Chars.Reset();
+    TermStart.Reset();
+    TermStart.Add(0);
+    TermHash.Reset();
+    Slots.Reset();
+    bAttached = false;
+    SyncViews();
+}
+
+uint32 FACETermDictionary::HashToken(FStringView Token)
+{
+    // FNV-1a over lowercased characters.
+    uint32 H = 2166136261u;
+    for (TCHAR C : Token)
+    {
+        H ^= (uint32)FChar::ToLower(C);
+        H *= 16777619u;
+    }
+    return H;
+}
+
+bool FACETermDictionary::Equals(int32 Id, FStringView Token) const
+{
+    const int32 Start = TermStartView[Id];
+    if (TermStartView[Id + 1] - Start != Token.Len()) return false;
+    for (int32 i = 0; i < Token.Len(); ++i)
+    {
+        if (CharsView[Start + i] != FChar::ToLower(Token[i])) return false;
+    }
+    return true;
+}
+
+int32 FACETermDictionary::Find(FStringView Token) const
+{
+    if (SlotsView.Num() == 0 || Token.IsEmpty()) return INDEX_NONE;
+
+    const uint32 H = HashToken(Token);
+    const uint32 Mask = (uint32)SlotsView.Num() - 1;
+    for (uint32 s = H & Mask;; s = (s + 1) & Mask)
+    {
+        const int32 Id = SlotsView[s];
+        if (Id == INDEX_NONE) return INDEX_NONE;
+        if (TermHashView[Id] == H && Equals(Id, Token)) return Id;
+    }
+}
+
+void FACETermDictionary::Grow()
+{
+    const int32 NewSize = FMath::Max(64, Slots.Num() * 2);
+    Slots.Init(INDEX_NONE, NewSize);
+    const uint32 Mask = (uint32)NewSize - 1;
+    for (int32 Id = 0; Id < TermHash.Num(); ++Id)
+    {
+        uint32 s = TermHash[Id] & Mask;
+        while (Slots[s] != INDEX_NONE) s = (s + 1) & Mask;
+        Slots[s] = Id;
+    }
+}
+
+int32 FACETermDictionary::FindOrAdd(FStringView Token)
+{
+    check(!bAttached);
+    const int32 Existing = Find(Token);
+    if (Existing != INDEX_NONE || Token.IsEmpty()) return Existing;
+
+    // Keep the load factor at or below one half.
+    if ((TermHash.Num() + 1) * 2 > Slots.Num())
+    {
+        Grow();
+    }
+
+    const int32 Id = TermHash.Num();
+    const uint32 H = HashToken(Token);
+    TermHash.Add(H);
+    for (TCHAR C : Token) Chars.Add(FChar::ToLower(C));
+    TermStart.Add(Chars.Num());
+
+    const uint32 Mask = (uint32)Slots.Num() - 1;
+    uint32 s = H & Mask;
+    while (Slots[s] != INDEX_NONE) s = (s + 1) & Mask;
+    Slots[s] = Id;
+    SyncViews();
+    return Id;
+}
+
+SIZE_T FACETermDictionary::GetAllocatedSize() const
+{
+    if (bAttached)
+    {
+        return CharsView.Num() * sizeof(TCHAR) + TermStartView.Num() * sizeof(int32) + TermHashView.Num() * sizeof(uint32) + SlotsView.Num() * sizeof(int32);
+    }
+    return Chars.GetAllocatedSize() + TermStart.GetAllocatedSize() + TermHash.GetAllocatedSize() + Slots.GetAllocatedSize();
+}
+
+void FACETermDictionary::Write(TArray<uint8>& Out) const
+{
+    using namespace ACERetrievalBlob;
+    WritePod(Out, (int32)CharsView.Num());
+    WritePod(Out, (int32)TermHashView.Num());
+    WritePod(Out, (int32)SlotsView.Num());
+    WriteArray(Out, CharsView);
+    WriteArray(Out, TermStartView);
+    WriteArray(Out, TermHashView);
+    WriteArray(Out, SlotsView);
+}
+
+bool FACETermDictionary::Attach(const uint8*& Cursor, const uint8* End)
+{
+    using namespace ACERetrievalBlob;
+    int32 NumChars = 0, NumTerms = 0, NumSlots = 0;
+    if (!ReadPod(Cursor, End, NumChars) || !ReadPod(Cursor, End, NumTerms) || !ReadPod(Cursor, End, NumSlots)) return false;
+    // Find probes until it reaches an empty slot, so the table must have at least one.
+    if (NumChars < 0 || NumTerms < 0 || (NumSlots == 0 ? NumTerms != 0 : !FMath::IsPowerOfTwo(NumSlots) || NumSlots <= NumTerms)) return false;
+
+    Reset();
+    if (!ReadArray(Cursor, End, NumChars, CharsView)
+        || !ReadArray(Cursor, End, NumTerms + 1, TermStartView)
+        || !ReadArray(Cursor, End, NumTerms, TermHashView)
+        || !ReadArray(Cursor, End, NumSlots, SlotsView))
+    {
+        Reset();
+        return false;
+    }
+
+    // Term starts and slot ids are checked once so lookups can index without bounds checks.
+    bool bValid = TermStartView[0] == 0 && TermStartView[NumTerms] == NumChars;
+    for (int32 t = 0; bValid && t < NumTerms; ++t) bValid = TermStartView[t] <= TermStartView[t + 1];
+    for (int32 s = 0; bValid && s < NumSlots; ++s) bValid = SlotsView[s] == INDEX_NONE || (SlotsView[s] >= 0 && SlotsView[s] < NumTerms);
+    if (!bValid)
+    {
+        Reset();
+        return false;
+    }
+    bAttached = true;
+    return true;
+}
+
+// ---------------------- FACERetrievalIndex ----------------------
+
+FACERetrievalIndex& FACERetrievalIndex::operator=(const FACERetrievalIndex& Other)
+{
+    K1 = Other.K1;
+    B = Other.B;
+    Dict = Other.Dict;
+    Weights = Other.Weights;
+    PendingDocTf = Other.PendingDocTf;
+    PendingDocBonus = Other.PendingDocBonus;
+    Idf = Other.Idf;
+    PostingStart = Other.PostingStart;
+    PostingDoc = Other.PostingDoc;
+    DocStart = Other.DocStart;
+    DocTerm = Other.DocTerm;
+    DocWeight = Other.DocWeight;
+    BonusStart = Other.BonusStart;
+    BonusTerm = Other.BonusTerm;
+    BonusValue = Other.BonusValue;
+    bAttached = Other.bAttached;
+    if (bAttached)
+    {
+        IdfView = Other.IdfView;
+        PostingStartView = Other.PostingStartView;
+        PostingDocView = Other.PostingDocView;
+        DocStartView = Other.DocStartView;
+        DocTermView = Other.DocTermView;
+        DocWeightView = Other.DocWeightView;
+        BonusStartView = Other.BonusStartView;
+        BonusTermView = Other.BonusTermView;
+        BonusValueView = Other.BonusValueView;
+    }
+    else
+    {
+        SyncViews();
+    }
+    return *this;
+}
+
+void FACERetrievalIndex::SyncViews()
+{
+    IdfView = Idf;
+    PostingStartView = PostingStart;
+    PostingDocView = PostingDoc;
+    DocStartView = DocStart;
+    DocTermView = DocTerm;
+    DocWeightView = DocWeight;
+    BonusStartView = BonusStart;
+    BonusTermView = BonusTerm;
+    BonusValueView = BonusValue;
+}
+
+void FACERetrievalIndex::BeginBuild(const FACELexicalWeights& InWeights)
+{
+    Weights = InWeights;
+    Dict.Reset();
+    PendingDocTf.Reset();
+    PendingDocBonus.Reset();
+    Idf.Reset();
+    PostingStart.Reset();
+    PostingDoc.Reset();
+    DocStart.Reset();
+    DocTerm.Reset();
+    DocWeight.Reset();
+    BonusStart.Reset();
+    BonusTerm.Reset();
+    BonusValue.Reset();
+    bAttached = false;
+    SyncViews();
+}
+
+void FACERetrievalIndex::AddDocument(FStringView Text, FStringView Name, TConstArrayView<FString> Aliases, TConstArrayView<FString> Tags)
+{
+    TArray<TPair<int32, float>>& Tf = PendingDocTf.AddDefaulted_GetRef();
+    ForEachToken(Text, [&](FStringView Tok)
+        {
+            const int32 Id = Dict.FindOrAdd(Tok);
+            if (auto* P = Tf.FindByPredicate([Id](const TPair<int32, float>& X) { return X.Key == Id; })) P->Value += 1.f;
+            else Tf.Add({ Id, 1.f });
+        });
+    SortRow(Tf);
+
+    // Lexical bonuses are resolved against the vocabulary once, so queries only need a lookup.
+    TArray<TPair<int32, float>>& Bonus = PendingDocBonus.AddDefaulted_GetRef();
+    auto AddBonus = [&Bonus](int32 Id, float W)
+        {
+            if (Id == INDEX_NONE || W == 0.f) return;
+            if (auto* P = Bonus.FindByPredicate([Id](const TPair<int32, float>& X) { return X.Key == Id; })) P->Value += W;
+            else Bonus.Add({ Id, W });
+        };
+
+    AddBonus(Dict.Find(Name), Weights.Name);
+
+    // A query token "is contained" in an alias when it is a vocabulary term appearing anywhere in
+    // one of the alias' alphanumeric runs; each alias contributes at most once per term.
+    TArray<int32, TInlineAllocator<64>> AliasTerms;
+    for (const FString& A : Aliases)
+    {
+        AliasTerms.Reset();
+        ForEachToken(A, [&](FStringView Run)
+            {
+                for (int32 Start = 0; Start < Run.Len(); ++Start)
+                {
+                    for (int32 Len = 1; Start + Len <= Run.Len(); ++Len)
+                    {
+                        const int32 Id = Dict.Find(Run.Mid(Start, Len));
+                        if (Id != INDEX_NONE) AliasTerms.AddUnique(Id);
+                    }
+                }
+            });
+        for (int32 Id : AliasTerms) AddBonus(Id, Weights.Alias);
+    }
+
+    for (const FString& T : Tags)
+    {
+        AddBonus(Dict.Find(T), Weights.Tag);
+    }
+    SortRow(Bonus);
+}
+
+void FACERetrievalIndex::FinishBuild()
+{
+    const int32 N = PendingDocTf.Num();
+    const int32 T = Dict.Num();
+
+    // Document frequencies and lengths.
+    TArray<int32> Df;
+    Df.SetNumZeroed(T);
+    TArray<int32> DocPostingCount;
+    DocPostingCount.SetNumZeroed(T);
+
+    double TotalLen = 0.0;
+    for (int32 d = 0; d < N; ++d)
+    {
+        for (const auto& P : PendingDocTf[d]) { Df[P.Key]++; TotalLen += P.Value; }
+    }
+    const float AvgLen = N > 0 ? FMath::Max(1.f, (float)(TotalLen / N)) : 1.f;
+
+    Idf.SetNumUninitialized(T);
+    for (int32 t = 0; t < T; ++t)
+    {
+        // BM25 idf in the log(1 + ...) form, which is non-negative by construction, so very common
+        // terms never subtract.
+        Idf[t] = FMath::Loge(1.f + ((float)N - (float)Df[t] + 0.5f) / ((float)Df[t] + 0.5f));
+    }
+
+    // Document rows (weights) and bonus rows, CSR.
+    DocStart.SetNumUninitialized(N + 1);
+    BonusStart.SetNumUninitialized(N + 1);
+    for (int32 d = 0; d < N; ++d)
+    {
+        DocStart[d] = DocTerm.Num();
+        float Len = 0.f;
+        for (const auto& P : PendingDocTf[d]) Len += P.Value;
+        const float Norm = K1 * (1.f - B + B * Len / AvgLen);
+        for (const auto& P : PendingDocTf[d])
+        {
+            DocTerm.Add(P.Key);
+            DocWeight.Add(Idf[P.Key] * (K1 + 1.f) * P.Value / (P.Value + Norm));
+        }
+
+        BonusStart[d] = BonusTerm.Num();
+        for (const auto& P : PendingDocBonus[d])
+        {
+            BonusTerm.Add(P.Key);
+            BonusValue.Add(P.Value);
+        }
+    }
+    DocStart[N] = DocTerm.Num();
+    BonusStart[N] = BonusTerm.Num();
+
+    // Postings: a document is reachable from every term in its row or its bonus row.
+    auto ForEachReachable = [&](int32 d, auto&& Fn)
+        {
+            int32 i = DocStart[d], j = BonusStart[d];
+            while (i < DocStart[d + 1] || j < BonusStart[d + 1])
+            {
+                const int32 A = i < DocStart[d + 1] ? DocTerm[i] : MAX_int32;
+                const int32 Bt = j < BonusStart[d + 1] ? BonusTerm[j] : MAX_int32;
+                const int32 Term = FMath::Min(A, Bt);
+                if (A == Term) ++i;
+                if (Bt == Term) ++j;
+                Fn(Term);
+            }
+        };
+
+    for (int32 d = 0; d < N; ++d) ForEachReachable(d, [&](int32 Term) { DocPostingCount[Term]++; });
+
+    PostingStart.SetNumUninitialized(T + 1);
+    int32 Running = 0;
+    for (int32 t = 0; t < T; ++t) { PostingStart[t] = Running; Running += DocPostingCount[t]; }
+    PostingStart[T] = Running;
+
+    PostingDoc.SetNumUninitialized(Running);
+    TArray<int32> Fill(PostingStart.GetData(), T);
+    for (int32 d = 0; d < N; ++d) ForEachReachable(d, [&](int32 Term) { PostingDoc[Fill[Term]++] = d; });
+
+    PendingDocTf.Empty();
+    PendingDocBonus.Empty();
+    SyncViews();
+}
+
+int32 FACERetrievalIndex::Query(FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter) const
+{
+    const int32 K = OutHits.Num();
+    const int32 N = NumDocs();
+    if (K == 0 || N == 0) return 0;
+
+    FQueryScratch& S = GScratch;
+    S.BeginQuery(N);
+
+    ForEachToken(Query, [&](FStringView Tok)
+        {
+            const int32 Id = Dict.Find(Tok);
+            if (Id == INDEX_NONE) return;
+            const int32 At = S.QTerm.Find(Id);
+            if (At != INDEX_NONE) { S.QCount[At] += 1.f; return; }
+            S.QTerm.Add(Id);
+            S.QCount.Add(1.f);
+        });
+    const int32 NumQ = S.QTerm.Num();
+    if (NumQ == 0) return 0;
+
+    // Sort the query vector by term id for the merge-join (insertion sort; queries are short).
+    for (int32 i = 1; i < NumQ; ++i)
+    {
+        for (int32 j = i; j > 0 && S.QTerm[j - 1] > S.QTerm[j]; --j)
+        {
+            Swap(S.QTerm[j - 1], S.QTerm[j]);
+            Swap(S.QCount[j - 1], S.QCount[j]);
+        }
+    }
+
+    // Upper bound of the BM25 sum (tf -> inf), used to map relevance into [0,1].
+    float MaxScore = 0.f;
+    for (int32 i = 0; i < NumQ; ++i) MaxScore += S.QCount[i] * IdfView[S.QTerm[i]] * (K1 + 1.f);
+    const float InvMax = MaxScore > 0.f ? 1.f / MaxScore : 0.f;
+
+    const int32* QT = S.QTerm.GetData();
+    const float* QW = S.QCount.GetData();
+
+    for (int32 q = 0; q < NumQ; ++q)
+    {
+        const int32 Term = QT[q];
+        for (int32 p = PostingStartView[Term]; p < PostingStartView[Term + 1]; ++p)
+        {
+            const int32 d = PostingDocView[p];
+            if (S.SeenStamp[d] == S.Stamp) continue;
+            S.SeenStamp[d] = S.Stamp;
+            if (!Filter.Passes(d)) continue;
+
+            const float Rel = MergeJoin(QT, QW, NumQ,
+                DocTermView.GetData() + DocStartView[d], DocWeightView.GetData() + DocStartView[d], DocStartView[d + 1] - DocStartView[d]) * InvMax;
+            const float Lex = FMath::Min(Weights.Clamp, MergeJoin(QT, QW, NumQ,
+                BonusTermView.GetData() + BonusStartView[d], BonusValueView.GetData() + BonusStartView[d], BonusStartView[d + 1] - BonusStartView[d]));
+
+            const FACERetrievalHit Hit{ d, 0.8f * Rel + 0.2f * Lex };
+            if (Hit.Score <= 0.f) continue;
+
+            if (S.Heap.Num() < K)
+            {
+                S.Heap.HeapPush(Hit, WeakerHit);
+            }
+            else if (WeakerHit(S.Heap.HeapTop(), Hit))
+            {
+                S.Heap.HeapPopDiscard(WeakerHit, EAllowShrinking::No);
+                S.Heap.HeapPush(Hit, WeakerHit);
+            }
+        }
+    }
+
+    S.Heap.Sort([](const FACERetrievalHit& A, const FACERetrievalHit& Bh) { return WeakerHit(Bh, A); });
+    const int32 Count = S.Heap.Num();
+    for (int32 i = 0; i < Count; ++i) OutHits[i] = S.Heap[i];
+    return Count;
+}
+
+SIZE_T FACERetrievalIndex::GetAllocatedSize() const
+{
+    if (bAttached)
+    {
+        return Dict.GetAllocatedSize() + (IdfView.Num() + DocWeightView.Num() + BonusValueView.Num()) * sizeof(float)
+            + (PostingStartView.Num() + PostingDocView.Num() + DocStartView.Num() + DocTermView.Num()
+                + BonusStartView.Num() + BonusTermView.Num()) * sizeof(int32);
+    }
+    return Dict.GetAllocatedSize() + Idf.GetAllocatedSize()
+        + PostingStart.GetAllocatedSize() + PostingDoc.GetAllocatedSize()
+        + DocStart.GetAllocatedSize() + DocTerm.GetAllocatedSize() + DocWeight.GetAllocatedSize()
+        + BonusStart.GetAllocatedSize() + BonusTerm.GetAllocatedSize() + BonusValue.GetAllocatedSize();
+}
+
+namespace
+{
+    // Scalar part of the index section; arrays follow in the order written below.
+    struct FIndexSectionHeader
+    {
+        int32 NumDocs = 0;
+        int32 NumPostings = 0;
+        int32 NumDocEntries = 0;
+        int32 NumBonusEntries = 0;
+        float K1 = 0.f;
+        float B = 0.f;
+        FACELexicalWeights Weights;
+    };
+}
+
+void FACERetrievalIndex::Write(TArray<uint8>& Out) const
+{
+    using namespace ACERetrievalBlob;
+    Dict.Write(Out);
+
+    FIndexSectionHeader H;
+    H.NumDocs = NumDocs();
+    H.NumPostings = PostingDocView.Num();
+    H.NumDocEntries = DocTermView.Num();
+    H.NumBonusEntries = BonusTermView.Num();
+    H.K1 = K1;
+    H.B = B;
+    H.Weights = Weights;
+    Pad16(Out);
+    WritePod(Out, H);
+
+    WriteArray(Out, IdfView);
+    WriteArray(Out, PostingStartView);
+    WriteArray(Out, PostingDocView);
+    WriteArray(Out, DocStartView);
+    WriteArray(Out, DocTermView);
+    WriteArray(Out, DocWeightView);
+    WriteArray(Out, BonusStartView);
+    WriteArray(Out, BonusTermView);
+    WriteArray(Out, BonusValueView);
+}
+
+bool FACERetrievalIndex::Attach(const uint8*& Cursor, const uint8* End)
+{
+    using namespace ACERetrievalBlob;
+    BeginBuild(FACELexicalWeights());
+
+    const uint8* C = Cursor;
+    if (!Dict.Attach(C, End)) return false;
+
+    FIndexSectionHeader H;
+    C = reinterpret_cast<const uint8*>(::Align(reinterpret_cast<UPTRINT>(C), 16));
+    if (C > End || !ReadPod(C, End, H)) return false;
+
+    const int32 T = Dict.Num();
+    const bool bOk = ReadArray(C, End, T, IdfView)
+        && ReadArray(C, End, T + 1, PostingStartView)
+        && ReadArray(C, End, H.NumPostings, PostingDocView)
+        && ReadArray(C, End, H.NumDocs + 1, DocStartView)
+        && ReadArray(C, End, H.NumDocEntries, DocTermView)
+        && ReadArray(C, End, H.NumDocEntries, DocWeightView)
+        && ReadArray(C, End, H.NumDocs + 1, BonusStartView)
+        && ReadArray(C, End, H.NumBonusEntries, BonusTermView)
+        && ReadArray(C, End, H.NumBonusEntries, BonusValueView);
+
+    // Offsets and ids are checked once so queries can index without bounds checks.
+    bool bValid = bOk && H.NumDocs >= 0
+        && PostingStartView[0] == 0 && PostingStartView[T] == H.NumPostings
+        && DocStartView[0] == 0 && DocStartView[H.NumDocs] == H.NumDocEntries
+        && BonusStartView[0] == 0 && BonusStartView[H.NumDocs] == H.NumBonusEntries;
+    for (int32 t = 0; bValid && t < T; ++t) bValid = PostingStartView[t] <= PostingStartView[t + 1];
+    for (int32 d = 0; bValid && d < H.NumDocs; ++d)
+    {
+        bValid = DocStartView[d] <= DocStartView[d + 1] && BonusStartView[d] <= BonusStartView[d + 1];
+    }
+    for (int32 p = 0; bValid && p < H.NumPostings; ++p) bValid = PostingDocView[p] >= 0 && PostingDocView[p] < H.NumDocs;
+    for (int32 e = 0; bValid && e < H.NumDocEntries; ++e) bValid = DocTermView[e] >= 0 && DocTermView[e] < T;
+    for (int32 e = 0; bValid && e < H.NumBonusEntries; ++e) bValid = BonusTermView[e] >= 0 && BonusTermView[e] < T;
+    if (!bValid)
+    {
+        BeginBuild(FACELexicalWeights());
+        return false;
+    }
+
+    K1 = H.K1;
+    B = H.B;
+    Weights = H.Weights;
+    bAttached = true;
+    Cursor = C;
+    return true;
+}
@@ -0,0 +1,176 @@
+#include "ACETagIndex.h"
+
+namespace
+{
+    struct FTagSectionHeader
+    {
+        int32 NumDocs = 0;
+        int32 WordsPerDoc = 0;
+        int32 NumRequirements = 0;
+        int32 Reserved = 0;
+    };
+
+    void SetTagBit(TArray<uint64, TInlineAllocator<4>>& Words, int32 Bit)
+    {
+        Words[Bit >> 6] |= 1ull << (Bit & 63);
+    }
+}
+
+FACETagIndex& FACETagIndex::operator=(const FACETagIndex& Other)
+{
+    Dict = Other.Dict;
+    NumIndexedDocs = Other.NumIndexedDocs;
+    WordsPerDoc = Other.WordsPerDoc;
+    NumRequirements = Other.NumRequirements;
+    PendingDocTags = Other.PendingDocTags;
+    DocBits = Other.DocBits;
+    bAttached = Other.bAttached;
+    if (bAttached)
+    {
+        DocBitsView = Other.DocBitsView;
+    }
+    else
+    {
+        SyncViews();
+    }
+    return *this;
+}
+
+void FACETagIndex::SyncViews()
+{
+    DocBitsView = DocBits;
+}
+
+void FACETagIndex::BeginBuild()
+{
+    Dict.Reset();
+    NumIndexedDocs = 0;
+    WordsPerDoc = 0;
+    NumRequirements = 0;
+    PendingDocTags.Reset();
+    DocBits.Reset();
+    bAttached = false;
+    SyncViews();
+}
+
+void FACETagIndex::AddDocument(TConstArrayView<FString> Tags)
+{
+    TArray<int32>& Ids = PendingDocTags.AddDefaulted_GetRef();
+    for (const FString& Tag : Tags)
+    {
+        const FStringView Trimmed = FStringView(Tag).TrimStartAndEnd();
+        if (Trimmed.IsEmpty()) continue;
+
+        const int32 Before = Dict.Num();
+        const int32 Id = Dict.FindOrAdd(Trimmed);
+        if (Id == Before && Trimmed.StartsWith(RequirePrefix, ESearchCase::IgnoreCase)) ++NumRequirements;
+        Ids.AddUnique(Id);
+    }
+    ++NumIndexedDocs;
+}
+
+void FACETagIndex::FinishBuild()
+{
+    WordsPerDoc = Dict.Num() > 0 ? (Dict.Num() + 63) / 64 : 0;
+    DocBits.SetNumZeroed(NumIndexedDocs * WordsPerDoc);
+    for (int32 Doc = 0; Doc < NumIndexedDocs; ++Doc)
+    {
+        uint64* Bits = DocBits.GetData() + (SIZE_T)Doc * WordsPerDoc;
+        for (const int32 Id : PendingDocTags[Doc]) Bits[Id >> 6] |= 1ull << (Id & 63);
+    }
+    PendingDocTags.Empty();
+    SyncViews();
+}
+
+FACEDocFilter FACETagIndex::Compile(const FACERetrievalFilter& Filter) const
+{
+    FACEDocFilter Out;
+    if (WordsPerDoc == 0 || Filter.IsEmpty()) return Out;
+
+    Out.Blocked.SetNumZeroed(WordsPerDoc);
+    bool bAny = false;
+    for (const FString& Tag : Filter.ExcludeTags)
+    {
+        const int32 Id = Dict.Find(FStringView(Tag).TrimStartAndEnd());
+        if (Id == INDEX_NONE) continue;
+        SetTagBit(Out.Blocked, Id);
+        bAny = true;
+    }
+
+    if (Filter.bHasContext && NumRequirements > 0)
+    {
+        const int32 PrefixLen = FCString::Strlen(RequirePrefix);
+        for (int32 Id = 0; Id < Dict.Num(); ++Id)
+        {
+            const FStringView Term = Dict.GetTerm(Id);
+            if (!Term.StartsWith(RequirePrefix)) continue;
+
+            const FStringView Required = Term.RightChop(PrefixLen).TrimStart();
+            const bool bMet = Filter.ContextTags.ContainsByPredicate([Required](const FString& Context)
+                {
+                    return Required.Equals(Context, ESearchCase::IgnoreCase);
+                });
+            if (bMet) continue;
+            SetTagBit(Out.Blocked, Id);
+            bAny = true;
+        }
+    }
+
+    if (!bAny)
+    {
+        Out.Blocked.Reset();
+        return Out;
+    }
+    Out.DocBits = DocBitsView;
+    return Out;
+}
+
+SIZE_T FACETagIndex::GetAllocatedSize() const
+{
+    if (bAttached)
+    {
+        return Dict.GetAllocatedSize() + DocBitsView.Num() * sizeof(uint64);
+    }
+    return Dict.GetAllocatedSize() + DocBits.GetAllocatedSize() + PendingDocTags.GetAllocatedSize();
+}
+
+void FACETagIndex::Write(TArray<uint8>& Out) const
+{
+    using namespace ACERetrievalBlob;
+
+    FTagSectionHeader H;
+    H.NumDocs = NumIndexedDocs;
+    H.WordsPerDoc = WordsPerDoc;
+    H.NumRequirements = NumRequirements;
+    Pad16(Out);
+    WritePod(Out, H);
+    Dict.Write(Out);
+    WriteArray(Out, DocBitsView);
+}
+
+bool FACETagIndex::Attach(const uint8*& Cursor, const uint8* End)
+{
+    using namespace ACERetrievalBlob;
+    BeginBuild();
+
+    FTagSectionHeader H;
+    const uint8* C = reinterpret_cast<const uint8*>(::Align(reinterpret_cast<UPTRINT>(Cursor), 16));
+    if (C > End || !ReadPod(C, End, H) || H.NumDocs < 0 || H.NumRequirements < 0) return false;
+
+    const bool bValid = Dict.Attach(C, End)
+        && H.WordsPerDoc == (Dict.Num() + 63) / 64
+        && H.NumRequirements <= Dict.Num()
+        && ReadArray(C, End, H.NumDocs * H.WordsPerDoc, DocBitsView);
+    if (!bValid)
+    {
+        BeginBuild();
+        return false;
+    }
+
+    NumIndexedDocs = H.NumDocs;
+    WordsPerDoc = H.WordsPerDoc;
+    NumRequirements = H.NumRequirements;
+    bAttached = true;
+    Cursor = C;
+    return true;
+}
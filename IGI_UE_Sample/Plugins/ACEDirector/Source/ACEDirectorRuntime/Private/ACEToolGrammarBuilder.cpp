@@ -1,7 +1,34 @@
 #include "ACEToolGrammarBuilder.h"
+#include "ACEStats.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
 #include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Hash/xxhash.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include <atomic>
+
+DEFINE_LOG_CATEGORY_STATIC(LogACEGrammar, Log, All);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Grammar cache hits"), STAT_ACE_GrammarCacheHits, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Grammar cache misses"), STAT_ACE_GrammarCacheMisses, STATGROUP_ACE);
+
+static TAutoConsoleVariable<int32> CVarACE_GrammarCacheSize(
+    TEXT("ace.GrammarCache.Size"),
+    128,
+    TEXT("Per-query grammars and JSON Schemas remembered in memory, grammars also as files under Saved/ACE/Grammars when ")
+    TEXT("a caller asks for one. The least recently used one is evicted and its file deleted."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarACE_GrammarFactorCandidates(
+    TEXT("ace.Grammar.FactorCandidates"),
+    true,
+    TEXT("Factor intent and console command choices into a shared-prefix trie of rules instead of one flat alternation, ")
+    TEXT("so constrained decoding follows a single branch per shared prefix (r., stat ...)."),
+    ECVF_Default);
 
 namespace
 {
@@ -13,6 +40,8 @@ chars   ::= ( char )*
 char    ::= [^"\\\u0000-\u001F] | "\\" ( "\"" | "\\" | "/" | "b" | "f" | "n" | "r" | "t" )
 jnumber ::= "-"? int frac? exp?
 int     ::= "0" | [1-9][0-9]*
+jint    ::= "-"? int
+jbool   ::= "true" | "false"
 frac    ::= "." [0-9]+
 exp     ::= ("e" | "E") ("+" | "-")? [0-9]+
 jobject ::= "{" ws ( jmember ( ws "," ws jmember )* )? ws "}"
@@ -24,8 +53,7 @@ ws      ::= (" " | "\t" | "\r" | "\n")*
     static const TCHAR* ActBlockTpl = TEXT(R"(
 act_root ::= "{" ws "\"tool\"" ws ":" ws "\"world.act\"" ws "," ws "\"act\"" ws ":" ws act_payload ws "}"
 act_payload ::= "{" ws "\"commands\"" ws ":" ws "[" ws cmd ws "]" ws "}"
-cmd ::= "{" ws "\"intent\"" ws ":" ws intent ws "," ws "\"args\"" ws ":" ws args_obj (ws "," ws "\"priority\"" ws ":" ws jnumber)? ws "}"
-intent ::= {{INTENTS}}
+cmd ::= "{" ws "\"intent\"" ws ":" ws cmd_intent
 args_obj ::= "{" ws (arg_kv (ws "," ws arg_kv)*)? ws "}"
 arg_kv   ::= jstring ws ":" ws jstring
 )");
@@ -33,9 +61,197 @@ arg_kv   ::= jstring ws ":" ws jstring
     static const TCHAR* ConsoleBlockTpl = TEXT(R"(
 console_root ::= "{" ws "\"tool\"" ws ":" ws "\"console.execute\"" ws "," ws "\"console\"" ws ":" ws console_payload ws "}"
 console_payload ::= "{" ws "\"command\"" ws ":" ws command (ws "," ws "\"args\"" ws ":" ws jstring)? ws "}"
-command ::= {{COMMANDS}}
 )");
 
+    // What follows an intent's name: its args, then the rest of the command. One per intent with an
+    // args schema, so each only admits its own arguments; intents without one share cmd_tail.
+    static const TCHAR* CmdTailTpl = TEXT(R"(
+{{TAIL}} ::= ws "," ws "\"args\"" ws ":" ws {{ARGS}} (ws "," ws "\"priority\"" ws ":" ws jnumber)? ws "}"
+)");
+
+    // JSON Schema counterparts of act_root, cmd and console_root, for backends that constrain output
+    // with guided_json. Same shapes as the grammar: one command per plan, args required, priority
+    // optional, no keys beyond these.
+    static const TCHAR* ActSchemaTpl = TEXT(R"({"type":"object","properties":{"tool":{"enum":["world.act"]},"act":{"type":"object","properties":{"commands":{"type":"array","items":{{CMD}},"minItems":1,"maxItems":1}},"required":["commands"],"additionalProperties":false}},"required":["tool","act"],"additionalProperties":false})");
+
+    static const TCHAR* CmdSchemaTpl = TEXT(R"({"type":"object","properties":{"intent":{{INTENT}},"args":{{ARGS}},"priority":{"type":"number"}},"required":["intent","args"],"additionalProperties":false})");
+
+    static const TCHAR* FreeArgsSchema = TEXT(R"({"type":"object","additionalProperties":{"type":"string"}})");
+
+    static const TCHAR* ConsoleSchemaTpl = TEXT(R"({"type":"object","properties":{"tool":{"enum":["console.execute"]},"console":{"type":"object","properties":{"command":{{COMMAND}},"args":{"type":"string"}},"required":["command"],"additionalProperties":false}},"required":["tool","console"],"additionalProperties":false})");
+
+    // Bump when the templates change, so cached files from older builds are never reused.
+    static constexpr uint32 GrammarFormatVersion = 3;
+
+    // Per-query grammars by key, most recently used first. The text is what gets sent to the
+    // structured-output client; a file is only written for callers that ask for a path, and is
+    // named after the key so the client's per-path cache sees the same path for the same candidates.
+    struct FGrammarCacheEntry
+    {
+        uint64 Key = 0;
+        FString Grammar;
+        FString Path;
+        bool bWroteFile = false;    // this process created Path, so eviction may delete it
+    };
+
+    struct FGrammarFileCache
+    {
+        FCriticalSection Lock;
+        TArray<FGrammarCacheEntry> Entries;
+        uint64 Lookups = 0;
+        uint64 Hits = 0;
+        std::atomic<bool> bSwept{ false };
+    };
+
+    // Grammar files nobody has written for this long are left over from earlier runs. Younger ones
+    // may belong to another editor or game instance sharing the Saved directory.
+    static const FTimespan StaleGrammarFileAge = FTimespan::FromDays(1);
+
+    static FGrammarFileCache& GetGrammarFileCache()
+    {
+        static FGrammarFileCache Cache;
+        return Cache;
+    }
+
+    static FString GrammarCacheDir()
+    {
+        return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ACE"), TEXT("Grammars"));
+    }
+
+    // Under Cache.Lock. Moves Key to the front and returns it, if cached.
+    static FGrammarCacheEntry* TouchGrammar(FGrammarFileCache& Cache, uint64 Key)
+    {
+        for (int32 i = 0; i < Cache.Entries.Num(); ++i)
+        {
+            if (Cache.Entries[i].Key != Key) continue;
+            if (i > 0)
+            {
+                FGrammarCacheEntry Hit = MoveTemp(Cache.Entries[i]);
+                Cache.Entries.RemoveAt(i, 1, EAllowShrinking::No);
+                Cache.Entries.Insert(MoveTemp(Hit), 0);
+            }
+            return &Cache.Entries[0];
+        }
+        return nullptr;
+    }
+
+    // Under Cache.Lock. Adds Grammar as Key at the front, evicting the least recently used entries
+    // past ace.GrammarCache.Size. Files of evicted entries that this process wrote are added to
+    // OutEvictedFiles, for the caller to delete once it has released the lock.
+    static FGrammarCacheEntry& AddGrammar(FGrammarFileCache& Cache, uint64 Key, FString Grammar, TArray<FString>& OutEvictedFiles)
+    {
+        FGrammarCacheEntry Entry;
+        Entry.Key = Key;
+        Entry.Grammar = MoveTemp(Grammar);
+        Cache.Entries.Insert(MoveTemp(Entry), 0);
+
+        const int32 Capacity = FMath::Max(1, CVarACE_GrammarCacheSize.GetValueOnAnyThread());
+        while (Cache.Entries.Num() > Capacity)
+        {
+            FGrammarCacheEntry& Evicted = Cache.Entries.Last();
+            if (Evicted.bWroteFile)
+            {
+                OutEvictedFiles.Add(MoveTemp(Evicted.Path));
+            }
+            Cache.Entries.Pop(EAllowShrinking::No);
+        }
+        return Cache.Entries[0];
+    }
+
+    static void DeleteGrammarFiles(TConstArrayView<FString> Paths)
+    {
+        for (const FString& Path : Paths) IFileManager::Get().Delete(*Path, false, false, true);
+    }
+
+    // Once per process: deletes stale grammar files left by earlier runs (and the timestamped ones
+    // older builds wrote to Saved/ACE), which this process does not track. Not under Cache.Lock.
+    static void SweepGrammarFiles(FGrammarFileCache& Cache)
+    {
+        if (Cache.bSwept.exchange(true)) return;
+
+        IFileManager& FileManager = IFileManager::Get();
+        const FDateTime Cutoff = FDateTime::UtcNow() - StaleGrammarFileAge;
+        auto SweepDir = [&FileManager, &Cutoff](const FString& Dir, const TCHAR* Pattern)
+            {
+                TArray<FString> Names;
+                FileManager.FindFiles(Names, *FPaths::Combine(Dir, Pattern), true, false);
+                for (const FString& Name : Names)
+                {
+                    const FString Path = FPaths::Combine(Dir, Name);
+                    const FDateTime Modified = FileManager.GetTimeStamp(*Path);
+                    if (Modified != FDateTime::MinValue() && Modified < Cutoff) FileManager.Delete(*Path, false, false, true);
+                }
+            };
+        SweepDir(GrammarCacheDir(), TEXT("*.ebnf"));
+        SweepDir(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ACE")), TEXT("tool_chooser_*.ebnf"));
+        FileManager.MakeDirectory(*GrammarCacheDir(), true);
+    }
+
+    // Not under Cache.Lock. Writes Grammar to Key's file unless that is already there, then records
+    // the path on Key's entry (if it is still cached) so later lookups skip the disk.
+    static FString PublishGrammarFile(FGrammarFileCache& Cache, uint64 Key, const FString& Grammar)
+    {
+        SweepGrammarFiles(Cache);
+
+        const FString Path = FPaths::Combine(GrammarCacheDir(), FString::Printf(TEXT("tool_chooser_%016llx.ebnf"), Key));
+        // A file old enough for a concurrent sweep to delete is written again rather than reused.
+        const FDateTime Modified = IFileManager::Get().GetTimeStamp(*Path);
+        const bool bReuse = Modified != FDateTime::MinValue() && Modified >= FDateTime::UtcNow() - StaleGrammarFileAge;
+        const bool bWrote = !bReuse && FFileHelper::SaveStringToFile(Grammar, *Path);
+
+        FScopeLock Lock(&Cache.Lock);
+        for (FGrammarCacheEntry& Entry : Cache.Entries)
+        {
+            if (Entry.Key != Key || !Entry.Path.IsEmpty()) continue;
+            Entry.Path = Path;
+            Entry.bWroteFile = bWrote;
+            break;
+        }
+        return Path;
+    }
+
+    static void LogGrammarCacheRate(const FGrammarFileCache& Cache)
+    {
+        if (Cache.Lookups % 100 != 0) return;
+        UE_LOG(LogACEGrammar, Log, TEXT("Grammar cache: %llu of %llu lookups hit (%.0f%%), %d grammars"),
+            Cache.Hits, Cache.Lookups, 100.0 * double(Cache.Hits) / double(Cache.Lookups), Cache.Entries.Num());
+    }
+
+    static void HashStrings(FXxHash64Builder& Hasher, TConstArrayView<FStringView> Strings)
+    {
+        // Sorted, so the same candidates in another order share a key.
+        TArray<FStringView, TInlineAllocator<16>> Sorted(Strings.GetData(), Strings.Num());
+        Sorted.Sort([](FStringView A, FStringView B) { return A.Compare(B, ESearchCase::CaseSensitive) < 0; });
+        const int32 Count = Sorted.Num();
+        Hasher.Update(&Count, sizeof(Count));
+        for (const FStringView S : Sorted)
+        {
+            const int32 Len = S.Len();
+            Hasher.Update(&Len, sizeof(Len));
+            Hasher.Update(S.GetData(), Len * sizeof(TCHAR));
+        }
+    }
+
+    static void HashIntentSchemas(FXxHash64Builder& Hasher, TConstArrayView<FStringView> Intents, TConstArrayView<FStringView> Schemas)
+    {
+        // Each intent with its schema, sorted by intent like HashStrings.
+        TArray<int32, TInlineAllocator<16>> Order;
+        for (int32 i = 0; i < Intents.Num(); ++i) Order.Add(i);
+        Order.Sort([Intents](int32 A, int32 B) { return Intents[A].Compare(Intents[B], ESearchCase::CaseSensitive) < 0; });
+        const int32 Count = Order.Num();
+        Hasher.Update(&Count, sizeof(Count));
+        for (const int32 i : Order)
+        {
+            const FStringView Schema = Schemas.IsValidIndex(i) ? Schemas[i] : FStringView();
+            for (const FStringView S : { Intents[i], Schema })
+            {
+                const int32 Len = S.Len();
+                Hasher.Update(&Len, sizeof(Len));
+                Hasher.Update(S.GetData(), Len * sizeof(TCHAR));
+            }
+        }
+    }
+
     static inline void AppendWithNewline(FString& Out, const FString& Chunk)
     {
         if (!Out.IsEmpty() && !Out.EndsWith(TEXT("\n")))
@@ -44,12 +260,298 @@ command ::= {{COMMANDS}}
         }
         Out += Chunk;
     }
+
+    // Appends an EBNF literal matching Text exactly.
+    static void AppendEbnfLiteral(FString& Out, FStringView Text)
+    {
+        Out += TEXT("\"");
+        for (const TCHAR C : Text)
+        {
+            if (C == TEXT('"') || C == TEXT('\\')) Out += TEXT('\\');
+            Out += C;
+        }
+        Out += TEXT("\"");
+    }
+
+    static FString ToJsonString(FStringView Text)
+    {
+        FString Json(TEXT("\""));
+        UACEToolGrammarBuilder::AppendJsonEscaped(Json, Text);
+        Json += TEXT("\"");
+        return Json;
+    }
+
+    // Appends an EBNF literal matching Text as a JSON string, quotes included.
+    static void AppendJsonStringLiteral(FString& Out, FStringView Text)
+    {
+        AppendEbnfLiteral(Out, ToJsonString(Text));
+    }
+
+    // Rules for "one of Literals, then the matching Tail" (Tails may be empty: nothing follows).
+    // Factored, the sorted literals become a radix trie: each run of literals sharing a prefix is one
+    // alternative that matches the prefix once and continues in a rule for the remainders, so a
+    // decoder steps through one branch per prefix instead of testing every literal at every token.
+    // Unfactored, it is the flat alternation. Appends Name's rule and any sub-rules (Name_1, ...).
+    static void AppendLiteralChoiceRules(FString& Out, const FString& Name, TConstArrayView<FString> Literals, TConstArrayView<FString> Tails, bool bFactor)
+    {
+        TArray<int32, TInlineAllocator<64>> Order;
+        for (int32 i = 0; i < Literals.Num(); ++i) Order.Add(i);
+        if (!bFactor)
+        {
+            FString Rule = Name + TEXT(" ::= ");
+            for (int32 n = 0; n < Order.Num(); ++n)
+            {
+                if (n > 0) Rule += TEXT(" | ");
+                AppendEbnfLiteral(Rule, Literals[Order[n]]);
+                if (Tails.IsValidIndex(Order[n])) Rule += TEXT(" ") + Tails[Order[n]];
+            }
+            AppendWithNewline(Out, Rule);
+            return;
+        }
+
+        Order.Sort([Literals](int32 A, int32 B) { return Literals[A].Compare(Literals[B], ESearchCase::CaseSensitive) < 0; });
+        int32 NumRules = 0;
+        auto EmitNode = [&Out, &Name, Literals, Tails, &Order, &NumRules](auto& Self, const FString& RuleName, int32 Lo, int32 Hi, int32 Depth) -> void
+            {
+                struct FChild { FString Name; int32 Lo, Hi, Depth; };
+                TArray<FChild, TInlineAllocator<8>> Children;
+                FString Rule = RuleName + TEXT(" ::= ");
+                bool bFirst = true;
+                auto AddAlternative = [&Rule, &bFirst](const FString& Alternative)
+                    {
+                        if (!bFirst) Rule += TEXT(" | ");
+                        Rule += Alternative;
+                        bFirst = false;
+                    };
+
+                int32 i = Lo;
+                // A literal ending here (a prefix of the others) only continues with its tail.
+                while (i < Hi && Literals[Order[i]].Len() == Depth)
+                {
+                    AddAlternative(Tails.IsValidIndex(Order[i]) ? Tails[Order[i]] : FString(TEXT("\"\"")));
+                    ++i;
+                }
+                while (i < Hi)
+                {
+                    const FString& First = Literals[Order[i]];
+                    int32 End = i + 1;
+                    while (End < Hi && Literals[Order[End]][Depth] == First[Depth]) ++End;
+
+                    // Sorted, so the run's common prefix is that of its first and last literal.
+                    const FString& Last = Literals[Order[End - 1]];
+                    int32 Common = Depth;
+                    const int32 Max = FMath::Min(First.Len(), Last.Len());
+                    while (Common < Max && First[Common] == Last[Common]) ++Common;
+                    // Never split a surrogate pair across two literals.
+                    if (End - i > 1 && Common > Depth + 1 && (First[Common - 1] & 0xFC00) == 0xD800) --Common;
+
+                    FString Alternative;
+                    if (End - i == 1)
+                    {
+                        AppendEbnfLiteral(Alternative, FStringView(First).RightChop(Depth));
+                        if (Tails.IsValidIndex(Order[i])) Alternative += TEXT(" ") + Tails[Order[i]];
+                    }
+                    else
+                    {
+                        const FString Child = FString::Printf(TEXT("%s_%d"), *Name, ++NumRules);
+                        AppendEbnfLiteral(Alternative, FStringView(First).Mid(Depth, Common - Depth));
+                        Alternative += TEXT(" ") + Child;
+                        Children.Add({ Child, i, End, Common });
+                    }
+                    AddAlternative(Alternative);
+                    i = End;
+                }
+                AppendWithNewline(Out, Rule);
+                for (const FChild& Child : Children) Self(Self, Child.Name, Child.Lo, Child.Hi, Child.Depth);
+            };
+        EmitNode(EmitNode, Name, 0, Order.Num(), 0);
+    }
+
+    // FACECommand::args is a string map, so anything that is not a number or bool (arrays, objects,
+    // unknown types) stays a JSON string.
+    enum class EArgValueKind : uint8 { String, Number, Integer, Boolean };
+
+    struct FArgSpec
+    {
+        FString Key;
+        TArray<FString, TInlineAllocator<4>> Values;
+        EArgValueKind Kind = EArgValueKind::String;
+        bool bRequired = false;
+    };
+
+    // Reads an ArgsSchemaJson ({"<arg>": {"type", "values", "required", ...}, ...}) in key order,
+    // keeping only string `values`. False if the schema is missing or unreadable.
+    static bool ParseArgSpecs(FStringView SchemaJson, TArray<FArgSpec, TInlineAllocator<8>>& Out)
+    {
+        TSharedPtr<FJsonObject> Schema;
+        if (SchemaJson.IsEmpty()
+            || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::CreateFromView(SchemaJson), Schema)
+            || !Schema.IsValid())
+        {
+            return false;
+        }
+
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Arg : Schema->Values)
+        {
+            if (!Arg.Value.IsValid() || Arg.Value->Type != EJson::Object) continue;
+            const FJsonObject& Json = *Arg.Value->AsObject();
+
+            FArgSpec& Spec = Out.AddDefaulted_GetRef();
+            Spec.Key = Arg.Key;
+            const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+            if (Json.TryGetArrayField(TEXT("values"), Values))
+            {
+                for (const TSharedPtr<FJsonValue>& V : *Values)
+                {
+                    FString Text;
+                    if (V.IsValid() && V->TryGetString(Text)) Spec.Values.Add(MoveTemp(Text));
+                }
+            }
+
+            FString Type;
+            Json.TryGetStringField(TEXT("type"), Type);
+            if (Type == TEXT("number") || Type == TEXT("float") || Type == TEXT("double")) Spec.Kind = EArgValueKind::Number;
+            else if (Type == TEXT("int") || Type == TEXT("integer")) Spec.Kind = EArgValueKind::Integer;
+            else if (Type == TEXT("bool") || Type == TEXT("boolean")) Spec.Kind = EArgValueKind::Boolean;
+            Json.TryGetBoolField(TEXT("required"), Spec.bRequired);
+        }
+        return true;
+    }
+
+    // The value rule for one argument: its `values` as string literals if it has any, otherwise the
+    // rule for its type.
+    static FString ArgValueRule(const FArgSpec& Spec)
+    {
+        if (Spec.Values.Num() > 0)
+        {
+            FString Choices;
+            for (const FString& Text : Spec.Values)
+            {
+                if (!Choices.IsEmpty()) Choices += TEXT(" | ");
+                AppendJsonStringLiteral(Choices, Text);
+            }
+            return TEXT("(") + Choices + TEXT(")");
+        }
+
+        switch (Spec.Kind)
+        {
+        case EArgValueKind::Number:  return TEXT("jnumber");
+        case EArgValueKind::Integer: return TEXT("jint");
+        case EArgValueKind::Boolean: return TEXT("jbool");
+        default:                     return TEXT("jstring");
+        }
+    }
+
+    // Rules for one intent's args object, compiled from its ArgsSchemaJson. Keys are fixed to schema
+    // order; optional ones may be left out, required ones may not. Appends the rules to Out and
+    // returns the name of the object rule, or args_obj if the schema is missing or unreadable.
+    static FString AppendArgsRules(FString& Out, int32 Index, FStringView SchemaJson)
+    {
+        TArray<FArgSpec, TInlineAllocator<8>> Specs;
+        if (!ParseArgSpecs(SchemaJson, Specs))
+        {
+            return TEXT("args_obj");
+        }
+
+        TArray<FString, TInlineAllocator<8>> Members;
+        TArray<bool, TInlineAllocator<8>> Required;
+        for (const FArgSpec& Spec : Specs)
+        {
+            const FString Name = FString::Printf(TEXT("arg_%d_%d"), Index, Members.Num());
+            FString Rule = Name + TEXT(" ::= ");
+            AppendJsonStringLiteral(Rule, Spec.Key);
+            Rule += TEXT(" ws \":\" ws ") + ArgValueRule(Spec);
+            AppendWithNewline(Out, Rule);
+
+            Members.Add(Name);
+            Required.Add(Spec.bRequired);
+        }
+
+        // Tail(j): members j.. after at least one was written, so each takes a leading comma.
+        // Head(j): members j.. with nothing written yet; an optional member may be skipped, which
+        // hands the first position to the next.
+        const int32 Num = Members.Num();
+        TArray<FString, TInlineAllocator<8>> Tail;
+        Tail.SetNum(Num + 1);
+        for (int32 j = Num - 1; j >= 0; --j)
+        {
+            const FString Next = TEXT("ws \",\" ws ") + Members[j];
+            Tail[j] = (Required[j] ? Next : TEXT("(") + Next + TEXT(")?")) + (Tail[j + 1].IsEmpty() ? FString() : TEXT(" ") + Tail[j + 1]);
+        }
+        FString Head;
+        for (int32 j = Num - 1; j >= 0; --j)
+        {
+            const FString Take = Members[j] + (Tail[j + 1].IsEmpty() ? FString() : TEXT(" ") + Tail[j + 1]);
+            if (Required[j]) Head = Take;
+            else if (Head.IsEmpty()) Head = TEXT("(") + Take + TEXT(")?");
+            else Head = TEXT("(") + Take + TEXT(" | ") + Head + TEXT(")");
+        }
+
+        const FString Name = FString::Printf(TEXT("args_%d"), Index);
+        AppendWithNewline(Out, Name + TEXT(" ::= \"{\" ws ") + (Head.IsEmpty() ? FString() : Head + TEXT(" ws ")) + TEXT("\"}\""));
+        return Name;
+    }
+
+    // {"enum":[...]} of Names as JSON strings.
+    static FString JsonSchemaEnum(TConstArrayView<FStringView> Names)
+    {
+        FString Out(TEXT("{\"enum\":["));
+        for (int32 i = 0; i < Names.Num(); ++i)
+        {
+            if (i > 0) Out += TEXT(",");
+            Out += ToJsonString(Names[i]);
+        }
+        Out += TEXT("]}");
+        return Out;
+    }
+
+    // The args object schema for parsed ArgsSchemaJson specs: the JSON Schema form of AppendArgsRules.
+    static FString ArgsJsonSchema(TConstArrayView<FArgSpec> Specs)
+    {
+        FString Properties, Required;
+        for (const FArgSpec& Spec : Specs)
+        {
+            if (!Properties.IsEmpty()) Properties += TEXT(",");
+            Properties += ToJsonString(Spec.Key) + TEXT(":");
+            if (Spec.Values.Num() > 0)
+            {
+                TArray<FStringView, TInlineAllocator<8>> Values;
+                for (const FString& V : Spec.Values) Values.Add(V);
+                Properties += JsonSchemaEnum(Values);
+            }
+            else
+            {
+                switch (Spec.Kind)
+                {
+                case EArgValueKind::Number:  Properties += TEXT("{\"type\":\"number\"}"); break;
+                case EArgValueKind::Integer: Properties += TEXT("{\"type\":\"integer\"}"); break;
+                case EArgValueKind::Boolean: Properties += TEXT("{\"type\":\"boolean\"}"); break;
+                default:                     Properties += TEXT("{\"type\":\"string\"}"); break;
+                }
+            }
+
+            if (Spec.bRequired)
+            {
+                if (!Required.IsEmpty()) Required += TEXT(",");
+                Required += ToJsonString(Spec.Key);
+            }
+        }
+        // Draft-4 validators reject an empty "required" array, so it is only written when non-empty.
+        const FString RequiredMember = Required.IsEmpty() ? FString() : FString::Printf(TEXT(",\"required\":[%s]"), *Required);
+        return FString::Printf(TEXT("{\"type\":\"object\",\"properties\":{%s}%s,\"additionalProperties\":false}"), *Properties, *RequiredMember);
+    }
 }
 
 FString UACEToolGrammarBuilder::JsonEscape(const FString& In)
 {
     FString Out;
-    Out.Reserve(In.Len() + 8);
+    AppendJsonEscaped(Out, In);
+    return Out;
+}
+
+void UACEToolGrammarBuilder::AppendJsonEscaped(FString& Out, FStringView In)
+{
+    Out.Reserve(Out.Len() + In.Len() + 8);
 
     for (TCHAR c : In)
     {
@@ -67,40 +569,69 @@ FString UACEToolGrammarBuilder::JsonEscape(const FString& In)
             break;
         }
     }
-    return Out;
 }
 
 FString UACEToolGrammarBuilder::BuildPerQueryGrammar(
     const TArray<FString>& WorldIntents,
     const TArray<FString>& ConsoleNames)
 {
-    auto QuoteJoin = [](const TArray<FString>& In, const TCHAR* DefaultChoice) -> FString
-        {
-            if (In.Num() == 0)
-            {
-                return FString(DefaultChoice);
-            }
-
-            TArray<FString> Q;
-            Q.Reserve(In.Num());
-            for (const FString& s : In)
-            {
-                Q.Add(TEXT("\"\\\"") + JsonEscape(s) + TEXT("\\\"\""));
-            }
-            return FString::Join(Q, TEXT(" | "));
-        };
+    TArray<FStringView, TInlineAllocator<8>> IntentViews;
+    TArray<FStringView, TInlineAllocator<8>> ConsoleViews;
+    for (const FString& s : WorldIntents) IntentViews.Add(s);
+    for (const FString& s : ConsoleNames) ConsoleViews.Add(s);
+    return BuildPerQueryGrammar(TConstArrayView<FStringView>(IntentViews), TConstArrayView<FStringView>(ConsoleViews));
+}
 
+FString UACEToolGrammarBuilder::BuildPerQueryGrammar(
+    TConstArrayView<FStringView> WorldIntents,
+    TConstArrayView<FStringView> ConsoleNames,
+    TConstArrayView<FStringView> WorldArgSchemas)
+{
     const bool bHasIntent = WorldIntents.Num() > 0;
     const bool bHasConsole = ConsoleNames.Num() > 0;
+    const bool bFactor = CVarACE_GrammarFactorCandidates.GetValueOnAnyThread();
 
-    const FString IntentChoices = QuoteJoin(WorldIntents, TEXT("\"\\\"Say\\\"\""));
-    const FString CommandChoices = QuoteJoin(ConsoleNames, TEXT("\"\\\"stat fps\\\"\""));
+    // Intent names, each followed by the tail that takes its args. With no candidates the plan
+    // defaults to Say with free-form args.
+    FString TailRules;
+    TArray<FString, TInlineAllocator<16>> IntentLiterals;
+    TArray<FString, TInlineAllocator<16>> IntentTails;
+    bool bHasFreeTail = false;
+    auto AddTail = [&TailRules](const FString& Name, const FString& Args)
+        {
+            FString Rule(CmdTailTpl);
+            Rule.ReplaceInline(TEXT("{{TAIL}}"), *Name, ESearchCase::CaseSensitive);
+            Rule.ReplaceInline(TEXT("{{ARGS}}"), *Args, ESearchCase::CaseSensitive);
+            Rule.TrimStartAndEndInline();
+            AppendWithNewline(TailRules, Rule);
+        };
+    for (int32 i = 0; i < FMath::Max(1, WorldIntents.Num()); ++i)
+    {
+        IntentLiterals.Add(ToJsonString(bHasIntent ? WorldIntents[i] : FStringView(TEXT("Say"))));
+        const FString Args = bHasIntent && WorldArgSchemas.IsValidIndex(i) ? AppendArgsRules(TailRules, i, WorldArgSchemas[i]) : FString(TEXT("args_obj"));
+        if (Args == TEXT("args_obj"))
+        {
+            if (!bHasFreeTail) AddTail(TEXT("cmd_tail"), Args);
+            bHasFreeTail = true;
+            IntentTails.Add(TEXT("cmd_tail"));
+        }
+        else
+        {
+            IntentTails.Add(FString::Printf(TEXT("cmd_tail_%d"), i));
+            AddTail(IntentTails.Last(), Args);
+        }
+    }
 
     FString ActBlock(ActBlockTpl);
-    ActBlock.ReplaceInline(TEXT("{{INTENTS}}"), *IntentChoices, ESearchCase::CaseSensitive);
+    AppendLiteralChoiceRules(ActBlock, TEXT("cmd_intent"), IntentLiterals, IntentTails, bFactor);
+    AppendWithNewline(ActBlock, TailRules);
+
+    TArray<FString, TInlineAllocator<16>> CommandLiterals;
+    for (const FStringView Name : ConsoleNames) CommandLiterals.Add(ToJsonString(Name));
+    if (!bHasConsole) CommandLiterals.Add(ToJsonString(TEXT("stat fps")));
 
     FString ConsoleBlock(ConsoleBlockTpl);
-    ConsoleBlock.ReplaceInline(TEXT("{{COMMANDS}}"), *CommandChoices, ESearchCase::CaseSensitive);
+    AppendLiteralChoiceRules(ConsoleBlock, TEXT("command"), CommandLiterals, {}, bFactor);
 
     FString Grammar;
 
@@ -129,23 +660,185 @@ FString UACEToolGrammarBuilder::BuildPerQueryGrammar(
         return Grammar;
     }
 
-    // No candidates: default root to act_root (IntentChoices already defaults to Say)
+    // No candidates: default root to act_root (cmd_intent already defaults to Say)
     AppendWithNewline(Grammar, TEXT("root ::= act_root"));
     AppendWithNewline(Grammar, ActBlock);
     AppendWithNewline(Grammar, FString(GenericJsonEbnf));
     return Grammar;
 }
 
-FString UACEToolGrammarBuilder::WriteTempGrammarFile(const FString& Grammar)
+FString UACEToolGrammarBuilder::BuildPerQueryJsonSchema(
+    const TArray<FString>& WorldIntents,
+    const TArray<FString>& ConsoleNames)
+{
+    TArray<FStringView, TInlineAllocator<8>> IntentViews;
+    TArray<FStringView, TInlineAllocator<8>> ConsoleViews;
+    for (const FString& s : WorldIntents) IntentViews.Add(s);
+    for (const FString& s : ConsoleNames) ConsoleViews.Add(s);
+    return BuildPerQueryJsonSchema(TConstArrayView<FStringView>(IntentViews), TConstArrayView<FStringView>(ConsoleViews));
+}
+
+FString UACEToolGrammarBuilder::BuildPerQueryJsonSchema(
+    TConstArrayView<FStringView> WorldIntents,
+    TConstArrayView<FStringView> ConsoleNames,
+    TConstArrayView<FStringView> WorldArgSchemas)
+{
+    const bool bHasIntent = WorldIntents.Num() > 0;
+    const bool bHasConsole = ConsoleNames.Num() > 0;
+
+    // One command variant per intent with an args schema; the intents without one share a variant
+    // with free-form args, as they share cmd_tail in the grammar. Defaults to Say like the grammar.
+    TArray<FString, TInlineAllocator<16>> Variants;
+    TArray<FStringView, TInlineAllocator<16>> FreeIntents;
+    for (int32 i = 0; i < FMath::Max(1, WorldIntents.Num()); ++i)
+    {
+        const FStringView Intent = bHasIntent ? WorldIntents[i] : FStringView(TEXT("Say"));
+        TArray<FArgSpec, TInlineAllocator<8>> Specs;
+        if (!bHasIntent || !WorldArgSchemas.IsValidIndex(i) || !ParseArgSpecs(WorldArgSchemas[i], Specs))
+        {
+            FreeIntents.Add(Intent);
+            continue;
+        }
+        FString Cmd(CmdSchemaTpl);
+        Cmd.ReplaceInline(TEXT("{{INTENT}}"), *JsonSchemaEnum(MakeArrayView(&Intent, 1)), ESearchCase::CaseSensitive);
+        Cmd.ReplaceInline(TEXT("{{ARGS}}"), *ArgsJsonSchema(Specs), ESearchCase::CaseSensitive);
+        Variants.Add(MoveTemp(Cmd));
+    }
+    if (FreeIntents.Num() > 0)
+    {
+        FString Cmd(CmdSchemaTpl);
+        Cmd.ReplaceInline(TEXT("{{INTENT}}"), *JsonSchemaEnum(FreeIntents), ESearchCase::CaseSensitive);
+        Cmd.ReplaceInline(TEXT("{{ARGS}}"), FreeArgsSchema, ESearchCase::CaseSensitive);
+        Variants.Add(MoveTemp(Cmd));
+    }
+
+    FString ActSchema(ActSchemaTpl);
+    ActSchema.ReplaceInline(TEXT("{{CMD}}"), *(Variants.Num() == 1 ? Variants[0] : TEXT("{\"anyOf\":[") + FString::Join(Variants, TEXT(",")) + TEXT("]}")),
+        ESearchCase::CaseSensitive);
+    if (!bHasConsole)
+    {
+        return ActSchema;
+    }
+
+    FString ConsoleSchema(ConsoleSchemaTpl);
+    ConsoleSchema.ReplaceInline(TEXT("{{COMMAND}}"), *JsonSchemaEnum(ConsoleNames), ESearchCase::CaseSensitive);
+    if (!bHasIntent)
+    {
+        return ConsoleSchema;
+    }
+    return TEXT("{\"anyOf\":[") + ConsoleSchema + TEXT(",") + ActSchema + TEXT("]}");
+}
+
+// Looks up (or builds and adds) the grammar, or with bJsonSchema the JSON Schema, for a candidate set
+// and calls Visit on its entry under the cache lock. Returns the key, which also serves as the id.
+template <typename VisitorType>
+static uint64 WithCachedGrammar(
+    TConstArrayView<FStringView> WorldIntents,
+    TConstArrayView<FStringView> ConsoleNames,
+    TConstArrayView<FStringView> WorldArgSchemas,
+    bool bJsonSchema,
+    VisitorType&& Visit)
+{
+    FXxHash64Builder Hasher;
+    Hasher.Update(&GrammarFormatVersion, sizeof(GrammarFormatVersion));
+    Hasher.Update(&bJsonSchema, sizeof(bJsonSchema));
+    HashIntentSchemas(Hasher, WorldIntents, WorldArgSchemas);
+    HashStrings(Hasher, ConsoleNames);
+    const bool bFactor = CVarACE_GrammarFactorCandidates.GetValueOnAnyThread();
+    Hasher.Update(&bFactor, sizeof(bFactor));
+    const uint64 Key = Hasher.Finalize().Hash;
+
+    FGrammarFileCache& Cache = GetGrammarFileCache();
+    {
+        FScopeLock Lock(&Cache.Lock);
+        ++Cache.Lookups;
+        if (FGrammarCacheEntry* Entry = TouchGrammar(Cache, Key))
+        {
+            ++Cache.Hits;
+            INC_DWORD_STAT(STAT_ACE_GrammarCacheHits);
+            LogGrammarCacheRate(Cache);
+            Visit(Cache, *Entry);
+            return Key;
+        }
+    }
+
+    INC_DWORD_STAT(STAT_ACE_GrammarCacheMisses);
+    FString Grammar = bJsonSchema
+        ? UACEToolGrammarBuilder::BuildPerQueryJsonSchema(WorldIntents, ConsoleNames, WorldArgSchemas)
+        : UACEToolGrammarBuilder::BuildPerQueryGrammar(WorldIntents, ConsoleNames, WorldArgSchemas);
+
+    TArray<FString> Evicted;
+    {
+        FScopeLock Lock(&Cache.Lock);
+        LogGrammarCacheRate(Cache);
+        FGrammarCacheEntry* Entry = TouchGrammar(Cache, Key);
+        if (!Entry)
+        {
+            Entry = &AddGrammar(Cache, Key, MoveTemp(Grammar), Evicted);
+        }
+        Visit(Cache, *Entry);
+    }
+    DeleteGrammarFiles(Evicted);
+    return Key;
+}
+
+FString UACEToolGrammarBuilder::GetCachedGrammar(
+    TConstArrayView<FStringView> WorldIntents,
+    TConstArrayView<FStringView> ConsoleNames,
+    FString& OutGrammarId,
+    TConstArrayView<FStringView> WorldArgSchemas)
+{
+    FString Grammar;
+    const uint64 Key = WithCachedGrammar(WorldIntents, ConsoleNames, WorldArgSchemas, /*bJsonSchema=*/false,
+        [&Grammar](FGrammarFileCache&, FGrammarCacheEntry& Entry) { Grammar = Entry.Grammar; });
+    OutGrammarId = FString::Printf(TEXT("%016llx"), Key);
+    return Grammar;
+}
+
+FString UACEToolGrammarBuilder::GetCachedJsonSchema(
+    TConstArrayView<FStringView> WorldIntents,
+    TConstArrayView<FStringView> ConsoleNames,
+    TConstArrayView<FStringView> WorldArgSchemas)
 {
-    const FString Dir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ACE"));
-    IFileManager::Get().MakeDirectory(*Dir, true);
+    FString Schema;
+    WithCachedGrammar(WorldIntents, ConsoleNames, WorldArgSchemas, /*bJsonSchema=*/true,
+        [&Schema](FGrammarFileCache&, FGrammarCacheEntry& Entry) { Schema = Entry.Grammar; });
+    return Schema;
+}
 
-    const FString Path = FPaths::Combine(
-        Dir,
-        FString::Printf(TEXT("tool_chooser_%llu.ebnf"), FDateTime::UtcNow().GetTicks())
-    );
+FString UACEToolGrammarBuilder::GetCachedGrammarFile(
+    TConstArrayView<FStringView> WorldIntents,
+    TConstArrayView<FStringView> ConsoleNames,
+    TConstArrayView<FStringView> WorldArgSchemas)
+{
+    // Only the text is copied under the lock, and only until the file exists.
+    FString Path;
+    FString Grammar;
+    const uint64 Key = WithCachedGrammar(WorldIntents, ConsoleNames, WorldArgSchemas, /*bJsonSchema=*/false,
+        [&Path, &Grammar](FGrammarFileCache&, FGrammarCacheEntry& Entry)
+        {
+            if (Entry.Path.IsEmpty()) Grammar = Entry.Grammar;
+            else Path = Entry.Path;
+        });
+    return Path.IsEmpty() ? PublishGrammarFile(GetGrammarFileCache(), Key, Grammar) : Path;
+}
 
-    FFileHelper::SaveStringToFile(Grammar, *Path);
-    return Path;
+FString UACEToolGrammarBuilder::WriteTempGrammarFile(const FString& Grammar)
+{
+    // Named after the content, so repeated grammars share one file in the bounded cache.
+    const uint64 Key = FXxHash64::HashBuffer(*Grammar, Grammar.Len() * sizeof(TCHAR)).Hash;
+    FGrammarFileCache& Cache = GetGrammarFileCache();
+    TArray<FString> Evicted;
+    FString Path;
+    {
+        FScopeLock Lock(&Cache.Lock);
+        FGrammarCacheEntry* Entry = TouchGrammar(Cache, Key);
+        if (!Entry)
+        {
+            Entry = &AddGrammar(Cache, Key, Grammar, Evicted);
+        }
+        Path = Entry->Path;
+    }
+    DeleteGrammarFiles(Evicted);
+    return Path.IsEmpty() ? PublishGrammarFile(Cache, Key, Grammar) : Path;
 }
@@ -1,7 +1,11 @@
 // SPDX-License-Identifier: MIT
 #include "ACEWorldActionRegistry.h"
+#include "ACECompiledRegistry.h"
+#include "ACEJsonStream.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/FileManager.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
 #include "Dom/JsonObject.h"
@@ -15,15 +19,6 @@ static FString JsonStringify(const TSharedPtr<FJsonValue>& V)
     return Out;
 }
 
-static FString JsonStringifyObject(const TSharedPtr<FJsonObject>& O)
-{
-    if (!O.IsValid()) return TEXT("");
-    FString Out;
-    auto Writer = TJsonWriterFactory<>::Create(&Out);
-    FJsonSerializer::Serialize(O.ToSharedRef(), Writer);
-    return Out;
-}
-
 static FString FlattenExamplesSummary(const TArray<TSharedPtr<FJsonValue>>& Examples)
 {
     FString S;
@@ -128,167 +123,440 @@ static FString FlattenConstraintsSummary(const TArray<TSharedPtr<FJsonValue>>& C
     return FString::Join(Lines, TEXT("; "));
 }
 
+struct UACEWorldActionRegistry::FActionSets
+{
+    FCriticalSection Lock;
+    TMap<FString, int32> Active;    // full path -> number of adds, guarded by Lock
+
+    // A parsed set file and the size and timestamp it had when it was read.
+    struct FParsedSet
+    {
+        int64 FileSize = -1;
+        FDateTime Timestamp;
+        TArray<FWorldActionEntry> Entries;
+    };
+
+    // Parsed set files, reused across rebuilds until the file changes. Only the loader task touches Parsed.
+    TMap<FString, FParsedSet> Parsed;
+};
+
 FString UACEWorldActionRegistry::JsonPath()
 {
     return FPaths::Combine(FPaths::ProjectDir(), TEXT("ACE/data/world_actions.json"));
 }
 
+static FString WorldActionSetFullPath(const FString& Path)
+{
+    FString Full = FPaths::IsRelative(Path) ? FPaths::Combine(FPaths::ProjectDir(), Path) : Path;
+    FPaths::NormalizeFilename(Full);
+    FPaths::CollapseRelativeDirectories(Full);
+    return Full;
+}
+
 void UACEWorldActionRegistry::Initialize(FSubsystemCollectionBase& Collection)
 {
-    LoadJSON();
+    ActionSets = MakeShared<FActionSets, ESPMode::ThreadSafe>();
+    State = MakeShared<FRegistryState, ESPMode::ThreadSafe>([Sets = ActionSets]()
+        {
+            return LoadWithActionSets(*Sets);
+        });
+    State->RequestLoad();
+
+    Watcher.Start(JsonPath(), [WeakState = TWeakPtr<FRegistryState, ESPMode::ThreadSafe>(State)]()
+        {
+            if (auto Pinned = WeakState.Pin())
+            {
+                UE_LOG(LogACERegistry, Log, TEXT("%s changed; rebuilding world action registry."), *JsonPath());
+                Pinned->RequestLoad();
+            }
+        });
+}
+
+void UACEWorldActionRegistry::Deinitialize()
+{
+    Watcher.Stop();
+    ActionSetWatchers.Reset();
+    State.Reset();
+    ActionSets.Reset();
 }
 
-bool UACEWorldActionRegistry::LoadJSON()
+void UACEWorldActionRegistry::AddActionSet(const FString& Path)
 {
-    const FString Path = JsonPath();
-    FString Raw;
-    if (!FPaths::FileExists(Path) || !FFileHelper::LoadFileToString(Raw, *Path))
-        return false;
+    check(IsInGameThread());
+    if (!State.IsValid() || Path.IsEmpty())
+        return;
 
-    TSharedPtr<FJsonValue> RootVal;
-    auto Reader = TJsonReaderFactory<>::Create(Raw);
-    if (!FJsonSerializer::Deserialize(Reader, RootVal) || !RootVal.IsValid() || RootVal->Type != EJson::Array)
-        return false;
+    const FString Full = WorldActionSetFullPath(Path);
+    {
+        FScopeLock Lock(&ActionSets->Lock);
+        if (ActionSets->Active.FindOrAdd(Full)++ > 0)
+            return;
+    }
+    UE_LOG(LogACERegistry, Log, TEXT("Adding world action set %s."), *Full);
+    TUniquePtr<FACERegistryWatcher>& SetWatcher = ActionSetWatchers.Add(Full, MakeUnique<FACERegistryWatcher>());
+    SetWatcher->Start(Full, [WeakState = TWeakPtr<FRegistryState, ESPMode::ThreadSafe>(State), Full]()
+        {
+            if (auto Pinned = WeakState.Pin())
+            {
+                UE_LOG(LogACERegistry, Log, TEXT("%s changed; rebuilding world action registry."), *Full);
+                Pinned->RequestLoad();
+            }
+        });
+    State->RequestLoad();
+}
 
-    const auto& Arr = RootVal->AsArray();
-    Entries.Reset();
+void UACEWorldActionRegistry::RemoveActionSet(const FString& Path)
+{
+    check(IsInGameThread());
+    if (!State.IsValid() || Path.IsEmpty())
+        return;
 
-    for (const auto& V : Arr)
+    const FString Full = WorldActionSetFullPath(Path);
     {
-        if (!V.IsValid() || V->Type != EJson::Object) continue;
-        const auto O = V->AsObject();
+        FScopeLock Lock(&ActionSets->Lock);
+        int32* Count = ActionSets->Active.Find(Full);
+        if (!Count || --*Count > 0)
+            return;
+        ActionSets->Active.Remove(Full);
+    }
+    ActionSetWatchers.Remove(Full);
+    UE_LOG(LogACERegistry, Log, TEXT("Removing world action set %s."), *Full);
+    State->RequestLoad();
+}
 
-        FWorldActionEntry E;
-        O->TryGetStringField(TEXT("intent"), E.Intent);
-        O->TryGetStringField(TEXT("doc"), E.Doc);
+TSharedPtr<const UACEWorldActionRegistry::FRegistryData, ESPMode::ThreadSafe> UACEWorldActionRegistry::LoadWithActionSets(FActionSets& Sets)
+{
+    TSharedPtr<const FRegistryData, ESPMode::ThreadSafe> Global = Load();
 
-        // aliases/tags
-        const TArray<TSharedPtr<FJsonValue>>* Ali = nullptr;
-        if (O->TryGetArrayField(TEXT("aliases"), Ali))
-            for (auto& x : *Ali) if (x.IsValid()) E.Aliases.Add(x->AsString());
+    TArray<FString> ActivePaths;
+    {
+        FScopeLock Lock(&Sets.Lock);
+        Sets.Active.GetKeys(ActivePaths);
+    }
+    for (auto It = Sets.Parsed.CreateIterator(); It; ++It)
+    {
+        if (!ActivePaths.Contains(It.Key()))
+            It.RemoveCurrent();
+    }
+    if (ActivePaths.Num() == 0)
+        return Global;
 
-        const TArray<TSharedPtr<FJsonValue>>* Tg = nullptr;
-        if (O->TryGetArrayField(TEXT("tags"), Tg))
-            for (auto& x : *Tg) if (x.IsValid()) E.Tags.Add(x->AsString());
+    // A global file that exists but did not load is most likely mid-save; keep the previous snapshot.
+    if (!Global && FPaths::FileExists(JsonPath()))
+        return nullptr;
 
+    const double Start = FPlatformTime::Seconds();
+    ActivePaths.Sort();
+    for (const FString& Path : ActivePaths)
+    {
+        const FFileStatData Stat = IFileManager::Get().GetStatData(*Path);
+        const int64 FileSize = Stat.bIsValid ? Stat.FileSize : -1;
+        FActionSets::FParsedSet* Cached = Sets.Parsed.Find(Path);
+        if (Cached && Cached->FileSize == FileSize && Cached->Timestamp == Stat.ModificationTime)
+            continue;
+
+        FActionSets::FParsedSet& Set = Sets.Parsed.Add(Path);
+        Set.FileSize = FileSize;
+        Set.Timestamp = Stat.ModificationTime;
+        FString Raw;
+        if (!FFileHelper::LoadFileToString(Raw, *Path) || !ParseJSON(Raw, Set.Entries))
         {
-            const TSharedPtr<FJsonObject>* ArgsObjPtr = nullptr;
-            if (O->TryGetObjectField(TEXT("args"), ArgsObjPtr) && ArgsObjPtr && ArgsObjPtr->IsValid())
-            {
-                const TSharedPtr<FJsonObject>& ArgsObj = *ArgsObjPtr;
-
-                E.ArgsSchemaJson = JsonStringifyObject(ArgsObj);
-                E.ArgsSummary = FlattenArgsSummary(ArgsObj);
-            }
+            UE_LOG(LogACERegistry, Warning, TEXT("World action set %s could not be read; it adds no actions."), *Path);
+            Set.Entries.Reset();
         }
+    }
+    const double ParseDone = FPlatformTime::Seconds();
 
+    TSharedPtr<FRegistryData, ESPMode::ThreadSafe> Merged = MakeShared<FRegistryData, ESPMode::ThreadSafe>();
+    TMap<FString, int32> SetIntents;
+    for (const FString& Path : ActivePaths)
+    {
+        for (const FWorldActionEntry& E : Sets.Parsed[Path].Entries)
         {
-            const TArray<TSharedPtr<FJsonValue>>* Constraints = nullptr;
-            if (O->TryGetArrayField(TEXT("constraints"), Constraints) && Constraints)
-            {
-                E.ConstraintsSummary = FlattenConstraintsSummary(*Constraints);
-            }
+            if (int32* Existing = SetIntents.Find(E.Intent))
+                Merged->Entries[*Existing] = E;
+            else
+                SetIntents.Add(E.Intent, Merged->Entries.Add(E));
         }
-
+    }
+    const int32 NumSetActions = Merged->Entries.Num();
+    if (Global.IsValid())
+    {
+        for (int32 i = 0; i < Global->Entries.Num(); ++i)
         {
-            const TArray<TSharedPtr<FJsonValue>>* Examples = nullptr;
-            if (O->TryGetArrayField(TEXT("examples"), Examples) && Examples)
-            {
-                TSharedPtr<FJsonValue> ExamplesVal = MakeShared<FJsonValueArray>(*Examples);
-                E.ExamplesJson = JsonStringify(ExamplesVal);
-                E.ExamplesSummary = FlattenExamplesSummary(*Examples);
-            }
+            if (!SetIntents.Contains(Global->Entries[i].Intent))
+                Merged->Entries.Add(Global->CopyEntry(i));
         }
-
-        if (!E.Intent.IsEmpty())
-            Entries.Add(MoveTemp(E));
     }
+    if (Merged->Entries.Num() == 0)
+        return Global;
 
-    return Entries.Num() > 0;
+    Merged->Index.Build(Merged->Entries);
+    Merged->CompactText(TEXT("World action"));
+
+    UE_LOG(LogACERegistry, Log, TEXT("World action registry: %d actions (%d from %d action sets); parse %.1f ms, merge and index %.1f ms"),
+        Merged->Entries.Num(), NumSetActions, ActivePaths.Num(),
+        (ParseDone - Start) * 1000.0, (FPlatformTime::Seconds() - ParseDone) * 1000.0);
+    return Merged;
 }
 
-TArray<FString> UACEWorldActionRegistry::Tokenize(const FString& S)
+TSharedPtr<const UACEWorldActionRegistry::FRegistryData, ESPMode::ThreadSafe> UACEWorldActionRegistry::Load()
 {
-    FString L = S.ToLower();
-    for (TCHAR& c : L) if (!FChar::IsAlnum(c)) c = ' ';
-    TArray<FString> Out; L.ParseIntoArrayWS(Out);
-    return Out;
+    // Shared process-wide with every other GameInstance loading the same content.
+    const double Start = FPlatformTime::Seconds();
+    bool bShared = false;
+    const TCHAR* Source = TEXT("compiled blob");
+    TSharedPtr<const FRegistryData, ESPMode::ThreadSafe> Loaded;
+    if (TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe> Compiled = FACECompiledRegistry::Open(FACECompiledRegistry::DefaultPath()))
+    {
+        Loaded = FRegistryStore::FindOrBuild(FACECompiledRegistry::DefaultPath(), Compiled->GetContentHash(), [&Compiled]()
+            {
+                TSharedPtr<FRegistryData, ESPMode::ThreadSafe> Data = MakeShared<FRegistryData, ESPMode::ThreadSafe>();
+                return LoadCompiled(*Data, Compiled) ? Data : nullptr;
+            }, &bShared);
+    }
+    if (!Loaded)
+    {
+        const FString Path = JsonPath();
+        TArray<uint8> Bytes;
+        if (!FPaths::FileExists(Path) || !FFileHelper::LoadFileToArray(Bytes, *Path))
+            return nullptr;
+
+        Source = TEXT("JSON");
+        Loaded = FRegistryStore::FindOrBuild(Path, FRegistryStore::HashContent(Bytes.GetData(), Bytes.Num()), [&Bytes]()
+            {
+                TSharedPtr<FRegistryData, ESPMode::ThreadSafe> Data = MakeShared<FRegistryData, ESPMode::ThreadSafe>();
+                return LoadJSON(*Data, Bytes) ? Data : nullptr;
+            }, &bShared);
+        if (!Loaded)
+            return nullptr;
+    }
+
+    UE_LOG(LogACERegistry, Log, TEXT("World action registry: %d actions from %s%s in %.1f ms"),
+        Loaded->Entries.Num(), Source, bShared ? TEXT(" (shared with another GameInstance)") : TEXT(""), (FPlatformTime::Seconds() - Start) * 1000.0);
+    return Loaded;
 }
 
-float UACEWorldActionRegistry::CosineLike(const TArray<FString>& Q, const TArray<FString>& D)
+bool UACEWorldActionRegistry::LoadCompiled(FRegistryData& Out, const TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe>& Compiled)
 {
-    if (Q.Num() == 0 || D.Num() == 0) return 0.f;
-    TMap<FString, int32> fq, fd;
-    for (auto& t : Q) fq.FindOrAdd(t)++;
-    for (auto& t : D) fd.FindOrAdd(t)++;
-    float dot = 0, n1 = 0, n2 = 0;
-    for (auto& kv : fq) { n1 += kv.Value * kv.Value; dot += kv.Value * (float)fd.FindRef(kv.Key); }
-    for (auto& kv : fd) { n2 += kv.Value * kv.Value; }
-    if (n1 == 0 || n2 == 0) return 0.f;
-    return dot / (FMath::Sqrt(n1) * FMath::Sqrt(n2));
+    Out.Compiled = Compiled;
+    if (Out.Compiled.IsValid() && Out.Compiled->LoadWorld(Out.Entries, Out.Index))
+    {
+        Out.CompactText(TEXT("World action"));
+        return true;
+    }
+
+    Out.Compiled.Reset();
+    Out.Entries.Reset();
+    return false;
 }
 
-float UACEWorldActionRegistry::LexicalBonus(const TArray<FString>& Q, const FWorldActionEntry& E)
+bool UACEWorldActionRegistry::LoadJSON(FRegistryData& Out, const TArray<uint8>& Bytes)
 {
-    float bonus = 0.f;
-    const FString In = E.Intent.ToLower();
-    for (const FString& q : Q) if (q == In) bonus += 0.6f;
+    FString Raw;
+    FFileHelper::BufferToString(Raw, Bytes.GetData(), Bytes.Num());
 
-    for (const FString& a : E.Aliases)
+    if (!ParseJSON(Raw, Out.Entries))
+        return false;
+
+    Out.Index.Build(Out.Entries);
+    Out.CompactText(TEXT("World action"));
+    return Out.Entries.Num() > 0;
+}
+
+static bool ReadWorldActionEntry(TJsonReader<TCHAR>& Reader, FWorldActionEntry& E)
+{
+    EJsonNotation Notation;
+    while (Reader.ReadNext(Notation))
     {
-        const FString al = a.ToLower();
-        for (const FString& q : Q) if (al.Contains(q)) bonus += 0.15f;
+        if (Notation == EJsonNotation::ObjectEnd)
+            return true;
+
+        const FString& Key = Reader.GetIdentifier();
+
+        if (Notation == EJsonNotation::String)
+        {
+            if (Key == TEXT("intent")) E.Intent = Reader.GetValueAsString();
+            else if (Key == TEXT("doc")) E.Doc = Reader.GetValueAsString();
+        }
+        else if (Notation == EJsonNotation::ArrayStart && (Key == TEXT("aliases") || Key == TEXT("tags")))
+        {
+            TArray<FString>& Target = Key == TEXT("aliases") ? E.Aliases : E.Tags;
+            if (!ACEJsonStream::ReadStringArray(Reader, Target))
+                return false;
+        }
+        else if (Notation == EJsonNotation::ObjectStart && Key == TEXT("args"))
+        {
+            // Keep the schema text verbatim; only this small subtree is parsed into a DOM for the summary.
+            if (!ACEJsonStream::CaptureValue(Reader, Notation, E.ArgsSchemaJson))
+                return false;
+
+            TSharedPtr<FJsonObject> ArgsObj;
+            if (FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(E.ArgsSchemaJson), ArgsObj))
+                E.ArgsSummary = FlattenArgsSummary(ArgsObj);
+        }
+        else if (Notation == EJsonNotation::ArrayStart && Key == TEXT("constraints"))
+        {
+            FString ConstraintsJson;
+            if (!ACEJsonStream::CaptureValue(Reader, Notation, ConstraintsJson))
+                return false;
+
+            TArray<TSharedPtr<FJsonValue>> Constraints;
+            if (FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(ConstraintsJson), Constraints))
+                E.ConstraintsSummary = FlattenConstraintsSummary(Constraints);
+        }
+        else if (Notation == EJsonNotation::ArrayStart && Key == TEXT("examples"))
+        {
+            if (!ACEJsonStream::CaptureValue(Reader, Notation, E.ExamplesJson))
+                return false;
+
+            TArray<TSharedPtr<FJsonValue>> Examples;
+            if (FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(E.ExamplesJson), Examples))
+                E.ExamplesSummary = FlattenExamplesSummary(Examples);
+        }
+        else if (!ACEJsonStream::SkipValue(Reader, Notation))
+        {
+            return false;
+        }
     }
-    for (const FString& t : E.Tags)
+    return false;
+}
+
+bool UACEWorldActionRegistry::ParseJSON(const FString& Raw, TArray<FWorldActionEntry>& OutEntries)
+{
+    TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::CreateFromView(Raw);
+    EJsonNotation Notation;
+    if (!Reader->ReadNext(Notation) || Notation != EJsonNotation::ArrayStart)
+        return false;
+
+    OutEntries.Reset();
+
+    while (Reader->ReadNext(Notation))
     {
-        const FString tl = t.ToLower();
-        for (const FString& q : Q) if (tl == q) bonus += 0.1f;
+        if (Notation == EJsonNotation::ArrayEnd)
+            return true;
+
+        if (Notation != EJsonNotation::ObjectStart)
+        {
+            if (!ACEJsonStream::SkipValue(*Reader, Notation))
+                return false;
+            continue;
+        }
+
+        FWorldActionEntry E;
+        if (!ReadWorldActionEntry(*Reader, E))
+            return false;
+
+        if (!E.Intent.IsEmpty())
+            OutEntries.Add(MoveTemp(E));
     }
-    return FMath::Clamp(bonus, 0.f, 1.5f);
+    return false;
+}
+
+static FWorldActionCandidate MakeWorldCandidate(const TACERegistryData<FWorldActionEntry>& Data, int32 Doc, float Score)
+{
+    using FTraits = TACERetrievalTraits<FWorldActionEntry>;
+    const FACEColdText Text = Data.GetText(Doc);
+
+    FWorldActionCandidate C;
+    C.Intent = Data.Entries[Doc].Intent;
+    C.Doc = FString(Text.Get(FTraits::ColdDoc));
+    C.Score = Score;
+
+    C.ArgsSchemaJson = FString(Text.Get(FTraits::ColdArgsSchemaJson));
+    C.ExamplesJson = FString(Text.Get(FTraits::ColdExamplesJson));
+    return C;
 }
 
 void UACEWorldActionRegistry::RetrieveTopK(const FString& Query, int32 K, TArray<FWorldActionCandidate>& Out) const
 {
-    TArray<FString> QTok = Tokenize(Query);
+    RetrieveTopKFiltered(Query, K, FACERetrievalFilter(), Out);
+}
 
-    struct S { int32 Idx; float Score; };
-    TArray<S> Scored;
-    Scored.Reserve(Entries.Num());
+void UACEWorldActionRegistry::RetrieveTopKFiltered(const FString& Query, int32 K, const FACERetrievalFilter& Filter, TArray<FWorldActionCandidate>& Out) const
+{
+    Out.Reset();
+    FWorldActionHits Hits;
+    RetrieveHits(Query, K, Filter, Hits);
 
-    for (int32 i = 0; i < Entries.Num(); ++i)
+    Out.Reserve(Hits.Num());
+    for (const FACERetrievalHit& H : Hits.GetHits())
     {
-        const auto& E = Entries[i];
-
-        FString Docline =
-            E.Intent + TEXT(" ")
-            + FString::Join(E.Aliases, TEXT(" ")) + TEXT(" ")
-            + E.Doc + TEXT(" ")
-            + FString::Join(E.Tags, TEXT(" ")) + TEXT(" ")
-            + E.ArgsSummary + TEXT(" ")
-            + E.ConstraintsSummary + TEXT(" ")
-            + E.ExamplesSummary;
-
-        const float cos = CosineLike(QTok, Tokenize(Docline));
-        const float lex = LexicalBonus(QTok, E);
-        const float s = 0.8f * cos + 0.2f * lex;
-        if (s > 0.f) Scored.Add({ i, s });
+        Out.Add(MakeWorldCandidate(*Hits.Data, H.Doc, H.Score));
     }
+}
+
+void UACEWorldActionRegistry::RetrieveHits(const FString& Query, int32 K, const FACERetrievalFilter& Filter, FWorldActionHits& Out) const
+{
+    Out.Reset();
+    if (!State.IsValid())
+        return;
+
+    FRegistryState::FReadScope Snapshot(State->Snapshot);
+    if (!Snapshot)
+        return;
 
-    Scored.Sort([](const S& A, const S& B) { return A.Score > B.Score; });
+    Out.Hits.SetNumUninitialized(FMath::Max(0, K));
+    Out.Hits.SetNum(State->QueryCached(Snapshot, Query, Out.Hits, Filter), EAllowShrinking::No);
+    if (Out.Hits.Num() > 0)
+        Out.Data = Snapshot.Pin();
+}
+
+void UACEWorldActionRegistry::RetrieveTopKBatch(TConstArrayView<FString> Queries, int32 K, TArray<TArray<FWorldActionCandidate>>& Out, const FACERetrievalFilter& Filter) const
+{
+    Out.SetNum(Queries.Num());
+    for (TArray<FWorldActionCandidate>& Row : Out)
+        Row.Reset();
+    if (!State.IsValid())
+        return;
+
+    FRegistryState::FReadScope Snapshot(State->Snapshot);
+    if (!Snapshot)
+        return;
+
+    TArray<FACERetrievalHit> Hits;
+    TArray<int32> Counts;
+    State->QueryBatch(Snapshot, Queries, K, Hits, Counts, Filter);
+    K = FMath::Max(0, K);
+
+    // Candidates copy strings out of the snapshot; build the rows in parallel too.
+    ParallelFor(Queries.Num(), [&Snapshot, &Hits, &Counts, &Out, K](int32 q)
+        {
+            Out[q].Reserve(Counts[q]);
+            for (int32 i = 0; i < Counts[q]; ++i)
+            {
+                const FACERetrievalHit& H = Hits[q * K + i];
+                Out[q].Add(MakeWorldCandidate(*Snapshot, H.Doc, H.Score));
+            }
+        });
+}
+
+FWorldActionHits::FDataPtr UACEWorldActionRegistry::PinSnapshot() const
+{
+    if (!State.IsValid())
+        return nullptr;
 
+    FRegistryState::FReadScope Snapshot(State->Snapshot);
+    return Snapshot.Pin();
+}
+
+void UACEWorldActionRegistry::Suggest(const FWorldActionHits::FDataPtr& Snapshot, FStringView Prefix, const FACERetrievalFilter& Filter, int32 K, double Deadline, FWorldActionHits& Out)
+{
     Out.Reset();
-    for (int32 i = 0; i < Scored.Num() && i < K; ++i)
-    {
-        const auto& E = Entries[Scored[i].Idx];
+    if (!Snapshot.IsValid())
+        return;
 
-        FWorldActionCandidate C;
-        C.Intent = E.Intent;
-        C.Doc = E.Doc;
-        C.Score = Scored[i].Score;
+    Out.Hits.SetNumUninitialized(FMath::Max(0, K));
+    Out.Hits.SetNum(Snapshot->Index.Suggest(Prefix, Out.Hits, Snapshot->Index.MakeFilter(Filter), Deadline), EAllowShrinking::No);
+    if (Out.Hits.Num() > 0)
+        Out.Data = Snapshot;
+}
 
-        C.ArgsSchemaJson = E.ArgsSchemaJson;
-        C.ExamplesJson = E.ExamplesJson;
+bool UACEWorldActionRegistry::UsesContextTags() const
+{
+    if (!State.IsValid())
+        return false;
 
-        Out.Add(MoveTemp(C));
-    }
+    FRegistryState::FReadScope Snapshot(State->Snapshot);
+    return Snapshot && Snapshot->Index.GetTagIndex().HasRequirements();
 }
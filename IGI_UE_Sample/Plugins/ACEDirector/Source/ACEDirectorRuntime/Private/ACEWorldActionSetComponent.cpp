@@ -0,0 +1,43 @@
+#include "ACEWorldActionSetComponent.h"
+#include "ACEWorldActionRegistry.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+static UACEWorldActionRegistry* FindWorldActionRegistry(const UActorComponent& Component)
+{
+    const UWorld* World = Component.GetWorld();
+    UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+    return GI ? GI->GetSubsystem<UACEWorldActionRegistry>() : nullptr;
+}
+
+UACEWorldActionSetComponent::UACEWorldActionSetComponent()
+{
+    PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UACEWorldActionSetComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (ActionsJson.FilePath.IsEmpty())
+        return;
+
+    if (UACEWorldActionRegistry* Registry = FindWorldActionRegistry(*this))
+    {
+        AddedPath = ActionsJson.FilePath;
+        Registry->AddActionSet(AddedPath);
+    }
+}
+
+void UACEWorldActionSetComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (!AddedPath.IsEmpty())
+    {
+        // The registry may already be gone when the whole GameInstance is shutting down.
+        if (UACEWorldActionRegistry* Registry = FindWorldActionRegistry(*this))
+            Registry->RemoveActionSet(AddedPath);
+        AddedPath.Reset();
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
@@ -3,6 +3,7 @@
 #include "Dom/JsonObject.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
 #include "Misc/DefaultValueHelper.h"
 #include "HAL/IConsoleManager.h"
 
@@ -13,9 +14,27 @@
 #include "IGIBlueprintLibrary.h"
 #include "ACEToolGrammarBuilder.h"
 #include "ACEConsoleTool.h"
+#include "WorldSnapshot.h"
+#include "ACEStats.h"
+
+#include <atomic>
 
 DEFINE_LOG_CATEGORY_STATIC(LogACEPlanner, Log, All);
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Directives routed"), STAT_ACE_DirectivesRouted, STATGROUP_ACE);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Exact-command bypasses"), STAT_ACE_ExactCommandBypasses, STATGROUP_ACE);
+
+static TAutoConsoleVariable<bool> CVarACE_ExactCommandBypass(
+    TEXT("ace.ExactCommandBypass"),
+    true,
+    TEXT("Directives that spell out a console command with fitting arguments (\"stat fps\", \"r.ScreenPercentage 50\") ")
+    TEXT("are executed directly instead of going through retrieval and the planner."),
+    ECVF_Default);
+
+// Process-wide, so the bypass rate is in the log in builds without stats too.
+static std::atomic<uint32> GACEDirectivesRouted{ 0 };
+static std::atomic<uint32> GACEExactCommandBypasses{ 0 };
+
 static TAutoConsoleVariable<float> CVarACE_MinConsoleCandidateScore(
     TEXT("ace.MinConsoleCandidateScore"),
     0.10f,
@@ -28,6 +47,14 @@ static TAutoConsoleVariable<float> CVarACE_MinWorldCandidateScore(
     TEXT("World action candidate must have Score >= this to be included in the per-query grammar."),
     ECVF_Default);
 
+static TAutoConsoleVariable<int32> CVarACE_PlannerConstraint(
+    TEXT("ace.Planner.Constraint"),
+    0,
+    TEXT("How the planner's output is constrained. 0: per-query EBNF grammar (guided_grammar, sent once per candidate set ")
+    TEXT("and then by id). 1: per-query JSON Schema (guided_json, sent inline). Use whichever the backend serves faster; ")
+    TEXT("-run=ACEGrammarBench with ACE/bench/grammar_bench.py measures both on the directive corpus."),
+    ECVF_Default);
+
 static FString JsonValueToCompactString(const TSharedPtr<FJsonValue>& V)
 {
     if (!V.IsValid() || V->IsNull()) return TEXT("");
@@ -51,33 +78,48 @@ static FString JsonValueToCompactString(const TSharedPtr<FJsonValue>& V)
 
 FString UCommandRouterComponent::BuildToolChooserUserJSON(
     const FString& UserText,
-    const TArray<FConsoleCandidate>& ConsoleCands,
-    const TArray<FWorldActionCandidate>& WorldCands) const
+    const FConsoleHits& ConsoleHits,
+    const FWorldActionHits& WorldHits) const
 {
+    // Appends straight from the registry entries. Docs, schemas and examples are inflated from the
+    // registries' compressed text only here, for the few hits that made the cut.
+    using FConsoleTraits = TACERetrievalTraits<FConsoleCommandEntry>;
+    using FWorldTraits = TACERetrievalTraits<FWorldActionEntry>;
+
     FString Out(TEXT("{\"user\":\""));
-    Out += UACEToolGrammarBuilder::JsonEscape(UserText);
+    UACEToolGrammarBuilder::AppendJsonEscaped(Out, UserText);
 
     Out += TEXT("\",\"console_candidates\":[");
-    for (int32 i = 0; i < ConsoleCands.Num(); ++i) {
-        const auto& C = ConsoleCands[i];
-        Out += TEXT("{\"name\":\"") + UACEToolGrammarBuilder::JsonEscape(C.Name) 
-             + TEXT("\",\"argNames\":\"") + UACEToolGrammarBuilder::JsonEscape(C.ArgNames) 
-             + TEXT("\",\"doc\":\"") + UACEToolGrammarBuilder::JsonEscape(C.Doc);
-        Out += FString::Printf(TEXT("\",\"score\":%.3f}"), C.Score);
-        if (i + 1 < ConsoleCands.Num()) Out += TEXT(",");
+    for (int32 i = 0; i < ConsoleHits.Num(); ++i) {
+        const FConsoleCommandEntry& C = ConsoleHits.GetEntry(i);
+        Out += TEXT("{\"name\":\"");
+        UACEToolGrammarBuilder::AppendJsonEscaped(Out, C.Name);
+        Out += TEXT("\",\"argNames\":\"");
+        UACEToolGrammarBuilder::AppendJsonEscaped(Out, C.ArgNames);
+        Out += TEXT("\",\"doc\":\"");
+        UACEToolGrammarBuilder::AppendJsonEscaped(Out, ConsoleHits.GetText(i).Get(FConsoleTraits::ColdDoc));
+        Out.Appendf(TEXT("\",\"score\":%.3f}"), ConsoleHits.GetScore(i));
+        if (i + 1 < ConsoleHits.Num()) Out += TEXT(",");
     }
     Out += TEXT("]");
 
     Out += TEXT(",\"world_candidates\":[");
-    for (int32 i = 0; i < WorldCands.Num(); ++i)
+    for (int32 i = 0; i < WorldHits.Num(); ++i)
     {
-        const auto& C = WorldCands[i];
-        Out += TEXT("{\"intent\":\"") + UACEToolGrammarBuilder::JsonEscape(C.Intent)
-            + TEXT("\",\"doc\":\"") + UACEToolGrammarBuilder::JsonEscape(C.Doc)
-            + TEXT("\",\"schema\":") + (C.ArgsSchemaJson.IsEmpty() ? TEXT("null") : C.ArgsSchemaJson)
-            + TEXT(",\"examples\":") + (C.ExamplesJson.IsEmpty() ? TEXT("null") : C.ExamplesJson)
-            + FString::Printf(TEXT(",\"score\":%.3f}"), C.Score);
-        if (i + 1 < WorldCands.Num()) Out += TEXT(",");
+        const FWorldActionEntry& C = WorldHits.GetEntry(i);
+        const FACEColdText Text = WorldHits.GetText(i);
+        const FStringView Schema = Text.Get(FWorldTraits::ColdArgsSchemaJson);
+        const FStringView Examples = Text.Get(FWorldTraits::ColdExamplesJson);
+        Out += TEXT("{\"intent\":\"");
+        UACEToolGrammarBuilder::AppendJsonEscaped(Out, C.Intent);
+        Out += TEXT("\",\"doc\":\"");
+        UACEToolGrammarBuilder::AppendJsonEscaped(Out, Text.Get(FWorldTraits::ColdDoc));
+        Out += TEXT("\",\"schema\":");
+        Out.Append(Schema.IsEmpty() ? FStringView(TEXT("null")) : Schema);
+        Out += TEXT(",\"examples\":");
+        Out.Append(Examples.IsEmpty() ? FStringView(TEXT("null")) : Examples);
+        Out.Appendf(TEXT(",\"score\":%.3f}"), WorldHits.GetScore(i));
+        if (i + 1 < WorldHits.Num()) Out += TEXT(",");
     }
     Out += TEXT("]}");
 
@@ -109,30 +151,105 @@ void UCommandRouterComponent::RouteFromText(const FString& UserDirective, AActor
         return;
     }
 
-    // Retrieve top-K sets
-    TArray<FConsoleCandidate> ConsoleCands;
-    if (UACEConsoleCommandRegistry* RC = GetWorld()->GetGameInstance()->GetSubsystem<UACEConsoleCommandRegistry>())
-        RC->RetrieveTopK(UserDirective, /*K=*/3, ConsoleCands);
+    // Registries load in the background; route with whichever ones are ready.
+    UACEConsoleCommandRegistry* RC = GI->GetSubsystem<UACEConsoleCommandRegistry>();
+    UACEWorldActionRegistry* RW = GI->GetSubsystem<UACEWorldActionRegistry>();
+    const bool bConsoleReady = RC && RC->IsReady();
+    const bool bWorldReady = RW && RW->IsReady();
+
+    if (!bConsoleReady && !bWorldReady)
+    {
+        UE_LOG(LogACEPlanner, Warning, TEXT("RouteFromText: registries are still loading; ignoring \"%s\"."), *UserDirective);
+        return;
+    }
+    if (!bConsoleReady || !bWorldReady)
+    {
+        UE_LOG(LogACEPlanner, Log, TEXT("RouteFromText: %s registry still loading; routing without it."),
+            bConsoleReady ? TEXT("world action") : TEXT("console"));
+    }
+
+    INC_DWORD_STAT(STAT_ACE_DirectivesRouted);
+    const uint32 Routed = ++GACEDirectivesRouted;
+
+    // A literal command needs neither retrieval nor the planner.
+    FString CommandLine;
+    const double MatchStart = FPlatformTime::Seconds();
+    if (bConsoleReady && CVarACE_ExactCommandBypass.GetValueOnGameThread() && RC->MatchExactCommand(UserDirective, CommandLine))
+    {
+        const double MatchSeconds = FPlatformTime::Seconds() - MatchStart;
+        INC_DWORD_STAT(STAT_ACE_ExactCommandBypasses);
+        const uint32 Bypassed = ++GACEExactCommandBypasses;
+        UE_LOG(LogACEPlanner, Log, TEXT("RouteFromText: \"%s\" -> \"%s\" without the planner (matched in %.1f us; %u of %u directives bypassed)"),
+            *UserDirective, *CommandLine, MatchSeconds * 1e6, Bypassed, Routed);
+
+        // Listeners see the same console.execute plan the planner would have produced.
+        FString Cmd, Args;
+        if (!CommandLine.Split(TEXT(" "), &Cmd, &Args)) Cmd = CommandLine;
+        TSharedRef<FJsonObject> Console = MakeShared<FJsonObject>();
+        Console->SetStringField(TEXT("command"), Cmd);
+        if (!Args.IsEmpty()) Console->SetStringField(TEXT("args"), Args);
+        TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+        Root->SetStringField(TEXT("tool"), TEXT("console.execute"));
+        Root->SetObjectField(TEXT("console"), Console);
+        FString Synthesized;
+        auto Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Synthesized);
+        FJsonSerializer::Serialize(Root, Writer);
+        Writer->Close();
+        OnPlannerText.Broadcast(Synthesized);
+
+        UACEConsoleTool::Execute(this, CommandLine);
+        return;
+    }
 
-    TArray<FWorldActionCandidate> WorldCands;
-    if (UACEWorldActionRegistry* RW = GetWorld()->GetGameInstance()->GetSubsystem<UACEWorldActionRegistry>())
-        RW->RetrieveTopK(UserDirective, /*K=*/3, WorldCands);
+    // Retrieve top-K sets. Actions that need something the instigator has nowhere near are
+    // filtered out before scoring, so they never reach the grammar.
+    FConsoleHits ConsoleHits;
+    if (bConsoleReady)
+        RC->RetrieveHits(UserDirective, /*K=*/3, FACERetrievalFilter(), ConsoleHits);
 
-    const float MinConsole = CVarACE_MinConsoleCandidateScore.GetValueOnGameThread();
-    const float MinWorld = CVarACE_MinWorldCandidateScore.GetValueOnGameThread();
+    FWorldActionHits WorldHits;
+    if (bWorldReady)
+    {
+        FACERetrievalFilter WorldFilter;
+        UWorldSnapshot* Snapshotter = GI->GetSubsystem<UWorldSnapshot>();
+        if (Instigator && Snapshotter && RW->UsesContextTags())
+            WorldFilter = UWorldSnapshot::MakeRetrievalFilter(Snapshotter->BuildSnapshot(Instigator));
+        RW->RetrieveHits(UserDirective, /*K=*/3, WorldFilter, WorldHits);
+    }
 
-    ConsoleCands.RemoveAll([&](const FConsoleCandidate& C) { return C.Score < MinConsole; });
-    WorldCands.RemoveAll([&](const FWorldActionCandidate& C) { return C.Score < MinWorld; });
+    ConsoleHits.RemoveBelow(CVarACE_MinConsoleCandidateScore.GetValueOnGameThread());
+    WorldHits.RemoveBelow(CVarACE_MinWorldCandidateScore.GetValueOnGameThread());
 
-    TArray<FString> IntentNames;  for (auto& c : WorldCands)   IntentNames.Add(c.Intent);
-    TArray<FString> ConsoleNames; for (auto& c : ConsoleCands) ConsoleNames.Add(c.Name);
+    // Names are views into the registry snapshots, which the hit lists keep alive; schemas are views
+    // into the inflated text held by WorldTexts.
+    TArray<FStringView, TInlineAllocator<8>> IntentNames;
+    TArray<FStringView, TInlineAllocator<8>> IntentSchemas;
+    TArray<FStringView, TInlineAllocator<8>> ConsoleNames;
+    TArray<FACEColdText, TInlineAllocator<8>> WorldTexts;
+    for (int32 i = 0; i < WorldHits.Num(); ++i)
+    {
+        IntentNames.Add(WorldHits.GetEntry(i).Intent);
+        IntentSchemas.Add(WorldTexts.Add_GetRef(WorldHits.GetText(i)).Get(TACERetrievalTraits<FWorldActionEntry>::ColdArgsSchemaJson));
+    }
+    for (int32 i = 0; i < ConsoleHits.Num(); ++i) ConsoleNames.Add(ConsoleHits.GetEntry(i).Name);
 
-    const FString Grammar = UACEToolGrammarBuilder::BuildPerQueryGrammar(IntentNames, ConsoleNames);
-    const FString GrammarPath = UACEToolGrammarBuilder::WriteTempGrammarFile(Grammar);
-    const FString Packed = BuildToolChooserUserJSON(UserDirective, ConsoleCands, WorldCands);
+    const FString Packed = BuildToolChooserUserJSON(UserDirective, ConsoleHits, WorldHits);
     UE_LOG(LogACEPlanner, Warning, TEXT("%s"), *Packed);
 
-    UIGIGPTEvaluateAsync* Node = UIGIGPTEvaluateAsync::GPTEvaluateStructuredWithGrammarAsync(Packed, GrammarPath);
+    // Either way each intent's args are constrained to its schema. A grammar is sent in memory under
+    // a stable id; the client caches it, so repeats cost only the id.
+    UIGIGPTEvaluateAsync* Node = nullptr;
+    if (CVarACE_PlannerConstraint.GetValueOnGameThread() == 1)
+    {
+        const FString Schema = UACEToolGrammarBuilder::GetCachedJsonSchema(IntentNames, ConsoleNames, IntentSchemas);
+        Node = UIGIGPTEvaluateAsync::GPTEvaluateStructuredWithJsonSchemaAsync(Packed, Schema);
+    }
+    else
+    {
+        FString GrammarId;
+        const FString Grammar = UACEToolGrammarBuilder::GetCachedGrammar(IntentNames, ConsoleNames, GrammarId, IntentSchemas);
+        Node = UIGIGPTEvaluateAsync::GPTEvaluateStructuredWithGrammarTextAsync(Packed, GrammarId, Grammar);
+    }
     if (!Node)
     {
         UE_LOG(LogACEPlanner, Warning, TEXT("GPTEvaluateAsync returned null"));
@@ -144,6 +261,14 @@ void UCommandRouterComponent::RouteFromText(const FString& UserDirective, AActor
     Node->Start();
 }
 
+void UCommandRouterComponent::RouteCommand(const FACECommand& Command, AActor* Instigator)
+{
+    FACECommandList Plan;
+    Plan.commands.Add(Command);
+    OnPlannerJSON.Broadcast(Plan);
+    ExecutePlan(Plan, Instigator);
+}
+
 void UCommandRouterComponent::RegisterAction(const FString& IntentName,
     const FACEActionHandler& Handler)
 {
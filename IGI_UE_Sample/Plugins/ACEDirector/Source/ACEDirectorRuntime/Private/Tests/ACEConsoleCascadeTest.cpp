@@ -0,0 +1,138 @@
+#include "ACEConsoleCascade.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    using FConsoleTier = TACERegistryState<FConsoleCommandEntry>;
+
+    FConsoleCommandEntry MakeConsoleEntry(const TCHAR* Name, const TCHAR* Doc, TArray<FString> Aliases = {})
+    {
+        FConsoleCommandEntry E;
+        E.Name = Name;
+        E.Doc = Doc;
+        E.Aliases = MoveTemp(Aliases);
+        return E;
+    }
+
+    TSharedRef<FConsoleTier, ESPMode::ThreadSafe> MakeConsoleTier(TArray<FConsoleCommandEntry> Entries)
+    {
+        TSharedRef<FConsoleTier, ESPMode::ThreadSafe> Tier = MakeShared<FConsoleTier, ESPMode::ThreadSafe>([]() { return FConsoleTier::FDataPtr(); });
+        TSharedPtr<TACERegistryData<FConsoleCommandEntry>, ESPMode::ThreadSafe> Data = MakeShared<TACERegistryData<FConsoleCommandEntry>, ESPMode::ThreadSafe>();
+        Data->Entries = MoveTemp(Entries);
+        Data->Index.Build(Data->Entries);
+        Tier->Snapshot.Publish(Data);
+        return Tier;
+    }
+
+    // Sets a float cvar for the test's lifetime.
+    class FScopedConsoleFloat
+    {
+    public:
+        FScopedConsoleFloat(const TCHAR* Name, float Value)
+            : Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+        {
+            if (!Variable) return;
+            Saved = Variable->GetFloat();
+            Variable->Set(Value, ECVF_SetByCode);
+        }
+        ~FScopedConsoleFloat()
+        {
+            if (Variable) Variable->Set(Saved, ECVF_SetByCode);
+        }
+
+    private:
+        IConsoleVariable* Variable;
+        float Saved = 0.f;
+    };
+
+    int32 FindConsoleHit(const FConsoleHits& Hits, const TCHAR* Name)
+    {
+        for (int32 i = 0; i < Hits.Num(); ++i)
+        {
+            if (Hits.GetEntry(i).Name == Name) return i;
+        }
+        return INDEX_NONE;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FACEConsoleCascadeTest, "ACE.Registry.ConsoleCascade",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FACEConsoleCascadeTest::RunTest(const FString& Parameters)
+{
+    TSharedRef<FConsoleTier, ESPMode::ThreadSafe> Curated = MakeConsoleTier({
+        MakeConsoleEntry(TEXT("stat fps"), TEXT("Shows frames per second."), { TEXT("fps") }),
+        MakeConsoleEntry(TEXT("stat unit"), TEXT("Shows frame, game, render and GPU times.")),
+        MakeConsoleEntry(TEXT("show collision"), TEXT("Toggles drawing of collision geometry in the game viewport, overlaid on the screen.")),
+    });
+    TSharedRef<FConsoleTier, ESPMode::ThreadSafe> Complete = MakeConsoleTier({
+        MakeConsoleEntry(TEXT("stat fps"), TEXT("Shows frames per second."), { TEXT("fps") }),
+        MakeConsoleEntry(TEXT("r.ScreenPercentage"), TEXT("Screen percentage: rendering resolution as a percentage of the screen."), { TEXT("screen percentage") }),
+        MakeConsoleEntry(TEXT("r.VSync"), TEXT("Synchronizes presentation with the display refresh.")),
+    });
+    const FACERetrievalFilter Policy;
+    constexpr int32 K = 4;
+
+    {
+        // Escalate on every query so the merge itself is what is checked.
+        const FScopedConsoleFloat MinTop(TEXT("ace.ConsoleCascade.MinTopScore"), 1e9f);
+        const FScopedConsoleFloat Bonus(TEXT("ace.ConsoleCascade.AgreementBonus"), 0.1f);
+
+        // A weak curated hit next to a strong complete one: the complete hit ranks first and both keep their raw scores.
+        const TCHAR* Query = TEXT("screen percentage");
+        FConsoleHits CuratedOnly, CompleteOnly, Merged;
+        QueryConsoleTier(*Curated, Query, K, Policy, CuratedOnly);
+        QueryConsoleTier(*Complete, Query, K, Policy, CompleteOnly);
+        if (!TestTrue(TEXT("curated tier has a weak hit"), CuratedOnly.Num() > 0)
+            || !TestTrue(TEXT("complete tier has a hit"), CompleteOnly.Num() > 0)
+            || !TestTrue(TEXT("complete top scores above curated top"), CompleteOnly.GetScore(0) > CuratedOnly.GetScore(0)))
+        {
+            return false;
+        }
+        QueryConsoleTier(*Curated, Query, K, Policy, Merged);
+        CascadeConsoleHits(Merged, &Complete.Get(), Query, K, Policy, Merged);
+        if (!TestTrue(TEXT("merged list has both tiers"), Merged.Num() >= 2)) return false;
+        TestEqual(TEXT("complete hit ranks first"), Merged.GetEntry(0).Name, FString(TEXT("r.ScreenPercentage")));
+        TestEqual(TEXT("complete hit keeps its raw score"), Merged.GetScore(0), CompleteOnly.GetScore(0));
+        const int32 Weak = FindConsoleHit(Merged, *CuratedOnly.GetEntry(0).Name);
+        if (TestTrue(TEXT("weak curated hit is kept"), Weak != INDEX_NONE))
+        {
+            TestEqual(TEXT("weak curated hit keeps its raw score"), Merged.GetScore(Weak), CuratedOnly.GetScore(0));
+        }
+        for (int32 i = 1; i < Merged.Num(); ++i)
+        {
+            TestTrue(TEXT("merged hits are best first"), Merged.GetScore(i - 1) >= Merged.GetScore(i));
+        }
+
+        // A command both tiers return gets the agreement bonus on top of its better score.
+        const TCHAR* Both = TEXT("stat fps");
+        QueryConsoleTier(*Curated, Both, K, Policy, CuratedOnly);
+        QueryConsoleTier(*Complete, Both, K, Policy, CompleteOnly);
+        QueryConsoleTier(*Curated, Both, K, Policy, Merged);
+        CascadeConsoleHits(Merged, &Complete.Get(), Both, K, Policy, Merged);
+        const int32 InCurated = FindConsoleHit(CuratedOnly, Both);
+        const int32 InComplete = FindConsoleHit(CompleteOnly, Both);
+        const int32 InMerged = FindConsoleHit(Merged, Both);
+        if (TestTrue(TEXT("both tiers and the merge find stat fps"), InCurated != INDEX_NONE && InComplete != INDEX_NONE && InMerged != INDEX_NONE))
+        {
+            TestEqual(TEXT("agreement adds the bonus once"), Merged.GetScore(InMerged),
+                FMath::Max(CuratedOnly.GetScore(InCurated), CompleteOnly.GetScore(InComplete)) + 0.1f, KINDA_SMALL_NUMBER);
+        }
+    }
+
+    {
+        // A confident curated tier is never merged.
+        const FScopedConsoleFloat MinTop(TEXT("ace.ConsoleCascade.MinTopScore"), 0.f);
+        const FScopedConsoleFloat MinMargin(TEXT("ace.ConsoleCascade.MinMargin"), 0.f);
+        FConsoleHits Hits;
+        QueryConsoleTier(*Curated, TEXT("stat fps"), K, Policy, Hits);
+        CascadeConsoleHits(Hits, &Complete.Get(), TEXT("stat fps"), K, Policy, Hits);
+        TestTrue(TEXT("confident curated hits are not merged"), Hits.Num() > 0 && Hits.SourceOf.Num() == 0);
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
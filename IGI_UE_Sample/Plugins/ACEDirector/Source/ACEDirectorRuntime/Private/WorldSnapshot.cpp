@@ -42,3 +42,13 @@ FWorldCognition UWorldSnapshot::BuildSnapshot(AActor* Instigator, float Radius)
     }
     return Out;
 }
+
+FACERetrievalFilter UWorldSnapshot::MakeRetrievalFilter(const FWorldCognition& Snapshot) {
+    FACERetrievalFilter Filter;
+    Filter.bHasContext = true;
+    for (const FWorldEntity& E : Snapshot.Nearby) {
+        for (const FString& T : E.Tags) { Filter.ContextTags.AddUnique(T); }
+        Filter.ContextTags.AddUnique(E.Class);
+    }
+    return Filter;
+}
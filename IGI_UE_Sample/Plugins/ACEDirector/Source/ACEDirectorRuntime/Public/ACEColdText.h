@@ -0,0 +1,68 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+namespace ACEColdText
+{
+    // ace.CompressRegistryText: whether loaders move prompt-only text into an FACEColdTextStore.
+    ACEDIRECTORRUNTIME_API bool IsEnabled();
+}
+
+// The text fields of one entry. Holds the inflated frame they point into, so the views stay valid
+// for as long as this does.
+struct FACEColdText
+{
+    TSharedPtr<const TArray<TCHAR>, ESPMode::ThreadSafe> Frame;
+    TArray<FStringView, TInlineAllocator<4>> Fields;
+
+    FStringView Get(int32 Field) const { return Fields.IsValidIndex(Field) ? Fields[Field] : FStringView(); }
+};
+
+// Entry text that retrieval never reads (docs, argument schemas, examples) and that is only needed
+// for the few winners packed into a prompt. All of it lives compressed in one buffer; entries are
+// grouped into frames so each compresses as a unit, and a frame is inflated on first use. The most
+// recently used frames stay inflated (ace.ColdTextCacheFrames).
+class ACEDIRECTORRUNTIME_API FACEColdTextStore
+{
+public:
+    static constexpr int32 EntriesPerFrame = 32;
+
+    FACEColdTextStore() = default;
+    FACEColdTextStore(const FACEColdTextStore&) = delete;
+    FACEColdTextStore& operator=(const FACEColdTextStore&) = delete;
+
+    void Build(int32 NumEntries, int32 NumFields, TFunctionRef<FStringView(int32 Entry, int32 Field)> GetField);
+
+    bool IsEmpty() const { return NumStoredEntries == 0; }
+    int32 Num() const { return NumStoredEntries; }
+
+    // Callable from any thread.
+    FACEColdText Get(int32 Entry) const;
+
+    // Bytes the text took as FStrings, and bytes held now (compressed data, tables, inflated frames).
+    int64 GetRawBytes() const { return RawBytes; }
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    struct FFrame
+    {
+        int32 Offset = 0;       // into Compressed
+        int32 Size = 0;         // bytes in Compressed
+        int32 NumChars = 0;     // inflated length
+        bool bCompressed = false;
+    };
+
+    using FFramePtr = TSharedPtr<const TArray<TCHAR>, ESPMode::ThreadSafe>;
+    FFramePtr Inflate(int32 FrameIndex) const;
+
+    int32 NumFields = 0;
+    int32 NumStoredEntries = 0;
+    int64 RawBytes = 0;
+
+    TArray<uint8> Compressed;
+    TArray<FFrame> Frames;
+    TArray<int32> FieldStart;   // (NumFields + 1) per entry: char offsets into its inflated frame
+
+    mutable FCriticalSection CacheLock;
+    mutable TArray<TPair<int32, FFramePtr>, TInlineAllocator<16>> Cache;   // most recent first
+};
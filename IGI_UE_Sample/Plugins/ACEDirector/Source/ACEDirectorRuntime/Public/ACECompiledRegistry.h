@@ -0,0 +1,95 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "ACEConsoleCommandRegistry.h"
+#include "ACEWorldActionRegistry.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Versioned binary image of both ACE registries (entries, token dictionary and retrieval index),
+// plus the complete console tier when console_registry_complete.json exists.
+// Produced by the ACECompileRegistry commandlet, which every cook also runs when it starts, and
+// staged inside the pak (DirectoriesToAlwaysStageAsUFS). At runtime it is memory-mapped and the
+// indices are queried in place, so startup skips the JSON parse and build. Mapping needs the pak
+// entry to be stored uncompressed; a compressed one is read into memory instead, which still skips
+// the parse and build.
+class ACEDIRECTORRUNTIME_API FACECompiledRegistry
+{
+public:
+    static constexpr uint32 FileMagic = 0x52454341; // "ACER"
+    static constexpr uint32 FileVersion = 8;
+
+    // <Project>/Content/ACE/Compiled/ACERegistry.acereg
+    static FString DefaultPath();
+
+    // Serializes both registries and their indices into a blob suitable for Open(). CompleteEntries
+    // (the complete console tier) may be empty, in which case its sections are left empty too.
+    static void Compile(TConstArrayView<FConsoleCommandEntry> ConsoleEntries, TConstArrayView<FWorldActionEntry> WorldEntries, TArray<uint8>& OutBlob,
+        TConstArrayView<FConsoleCommandEntry> CompleteEntries = {});
+
+    // Maps the blob at Path, or returns the already open instance for it. Returns null when the
+    // file is missing, incompatible, or (in editor builds) older than its source JSON.
+    static TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe> Open(const FString& Path);
+
+    // Copies the entries out and attaches the index to the mapped data. The index stays valid
+    // for as long as this object is alive.
+    bool LoadConsole(TArray<FConsoleCommandEntry>& OutEntries, TACERetrievalCore<FConsoleCommandEntry>& OutIndex) const;
+    bool LoadWorld(TArray<FWorldActionEntry>& OutEntries, TACERetrievalCore<FWorldActionEntry>& OutIndex) const;
+    // False when the blob was compiled without the complete tier.
+    bool LoadConsoleComplete(TArray<FConsoleCommandEntry>& OutEntries, TACERetrievalCore<FConsoleCommandEntry>& OutIndex) const;
+
+    bool IsMemoryMapped() const { return MappedRegion.IsValid(); }
+    int64 GetSize() const { return Size; }
+
+    // Hash of the blob's sections, computed by Compile and stored in the header so opening the
+    // blob does not page it all in; keys the shared registry store.
+    uint64 GetContentHash() const { return ContentHash; }
+
+    ~FACECompiledRegistry();
+
+private:
+    enum class ESection : uint32
+    {
+        ConsoleEntries,
+        ConsoleIndex,
+        WorldEntries,
+        WorldIndex,
+        CompleteEntries,
+        CompleteIndex,
+        Num
+    };
+
+    struct FSourceStamp
+    {
+        int64 FileSize = -1;
+        int64 TimestampTicks = 0;
+    };
+
+    struct FHeader
+    {
+        uint32 Magic = FileMagic;
+        uint32 Version = FileVersion;
+        uint32 CharSize = sizeof(TCHAR);
+        uint32 NumSections = (uint32)ESection::Num;
+        uint64 ContentHash = 0;
+        FSourceStamp ConsoleSource;
+        FSourceStamp WorldSource;
+        FSourceStamp CompleteSource;
+        int64 SectionOffset[(uint32)ESection::Num] = {};
+        int64 SectionSize[(uint32)ESection::Num] = {};
+    };
+
+    static FSourceStamp StampFile(const FString& Path);
+    bool Validate() const;
+    bool GetSection(ESection Section, const uint8*& OutBegin, const uint8*& OutEnd) const;
+    template<typename EntryType>
+    bool LoadSections(ESection EntriesSection, ESection IndexSection, TArray<EntryType>& OutEntries, TACERetrievalCore<EntryType>& OutIndex) const;
+
+    TUniquePtr<IMappedFileHandle> MappedHandle;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+    TArray<uint8> LoadedBytes; // fallback when the platform file cannot map (e.g. compressed pak entry)
+
+    const uint8* Data = nullptr;
+    int64 Size = 0;
+    uint64 ContentHash = 0;
+};
@@ -1,6 +1,11 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "ACERetrievalCore.h"
+#include "ACERegistryState.h"
+#include "ACERegistryStore.h"
+#include "ACERegistryWatcher.h"
 #include "ACEConsoleCommandRegistry.generated.h"
 
 USTRUCT(BlueprintType)
@@ -24,23 +29,109 @@ struct FConsoleCandidate {
     UPROPERTY(EditAnywhere, BlueprintReadWrite) float Score = 0.f;
 };
 
+template<>
+struct TACERetrievalTraits<FConsoleCommandEntry>
+{
+    enum : int32 { ColdDoc, NumColdFields };
+
+    static FACELexicalWeights LexicalWeights() { return { 1.0f, 0.15f, 0.1f, 2.0f }; }
+    template<typename T> static auto& GetColdField(T& E, int32) { return E.Doc; }
+    static const FString& GetName(const FConsoleCommandEntry& E) { return E.Name; }
+    static const TArray<FString>& GetAliases(const FConsoleCommandEntry& E) { return E.Aliases; }
+    static const TArray<FString>& GetTags(const FConsoleCommandEntry& E) { return E.Tags; }
+    static void AppendDocText(const FConsoleCommandEntry& E, FString& Out)
+    {
+        Out += E.Name; Out += TEXT(" ");
+        Out += FString::Join(E.Aliases, TEXT(" ")); Out += TEXT(" ");
+        Out += E.Doc; Out += TEXT(" ");
+        Out += FString::Join(E.Tags, TEXT(" ")); Out += TEXT(" ");
+        Out += E.ArgNames;
+    }
+};
+
+using FConsoleHits = TACEHitList<FConsoleCommandEntry>;
+
 UCLASS()
 class ACEDIRECTORRUNTIME_API UACEConsoleCommandRegistry : public UGameInstanceSubsystem {
     GENERATED_BODY()
 public:
+    // Starts loading on a background task; queries return nothing until IsReady().
+    // In the editor the JSON is watched and reloaded when it changes.
     virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
 
+    UFUNCTION(BlueprintPure, Category = "ACE|Console")
+    bool IsReady() const { return State.IsValid() && State->Snapshot.IsSet(); }
+
+    // Safe to call from any thread. Entries tagged "debug" are skipped unless ace.AllowDebugCommands.
     UFUNCTION(BlueprintCallable, Category = "ACE|Console")
     void RetrieveTopK(const FString& Query, int32 K, TArray<FConsoleCandidate>& Out) const;
 
+    // RetrieveTopK over only the entries Filter allows; they are skipped before scoring.
+    void RetrieveTopKFiltered(const FString& Query, int32 K, const FACERetrievalFilter& Filter, TArray<FConsoleCandidate>& Out) const;
+
+    // Native form of RetrieveTopKFiltered: hits point into the current snapshot instead of copying
+    // entries into candidates. Safe to call from any thread.
+    // With ace.ConsoleCascade every query goes to the curated registry first; when its best hit is
+    // weak or barely ahead of the next, console_registry_complete.json is searched too and the two
+    // hit lists are merged, so a hit may point into either registry.
+    void RetrieveHits(const FString& Query, int32 K, const FACERetrievalFilter& Filter, FConsoleHits& Out) const;
+
+    // RetrieveTopK for many queries against one snapshot, scored in parallel (and cascaded per
+    // query); Out gets one row per query, in order. Safe to call from any thread.
+    void RetrieveTopKBatch(TConstArrayView<FString> Queries, int32 K, TArray<TArray<FConsoleCandidate>>& Out,
+        const FACERetrievalFilter& Filter = FACERetrievalFilter()) const;
+
+    // Recognizes a directive that is literally a command: a name or alias followed by arguments
+    // that fit its ArgNames ("stat fps", "r.ScreenPercentage 50", "show fps"). On success
+    // OutCommandLine is ready for UACEConsoleTool::Execute. Fails when the directive could mean more
+    // than one command or the arguments do not fit, so the planner still sees anything unclear.
+    // Only curated commands qualify: never the complete registry, and with ace.ConsoleRegistrySource=1
+    // never a live console object the curated JSON does not list. Safe to call from any thread.
+    bool MatchExactCommand(const FString& Directive, FString& OutCommandLine) const;
+
+    // Type-ahead: commands whose name or alias starts with Prefix, shortest first, then near misses;
+    // from the curated registry and, once loaded, the complete one. PinSnapshots runs on the game
+    // thread; Suggest reads only what it pinned, so it can run on any thread, even after this
+    // subsystem is gone. Deadline is an FPlatformTime::Seconds() time after which no more
+    // candidates are gathered.
+    using FSnapshots = TArray<FConsoleHits::FDataPtr, TInlineAllocator<2>>;
+    FSnapshots PinSnapshots() const;
+    static void Suggest(TConstArrayView<FConsoleHits::FDataPtr> Snapshots, FStringView Prefix, int32 K, double Deadline, FConsoleHits& Out);
+
+    // Copy of the current snapshot's entries.
     UFUNCTION(BlueprintCallable, Category = "ACE|Console")
-    const TArray<FConsoleCommandEntry>& GetAll() const { return Entries; }
+    TArray<FConsoleCommandEntry> GetAll() const;
+
+    static FString JsonPath();
+    static FString CompleteJsonPath();
+    static bool ParseJSON(const FString& Raw, TArray<FConsoleCommandEntry>& OutEntries);
 
 private:
-    TArray<FConsoleCommandEntry> Entries;
+    using FRegistryData = TACERegistryData<FConsoleCommandEntry>;
+    using FRegistryState = TACERegistryState<FConsoleCommandEntry>;
+    using FRegistryStore = TACERegistryStore<FConsoleCommandEntry>;
+
+    TSharedPtr<FRegistryState, ESPMode::ThreadSafe> State;
+    FACERegistryWatcher Watcher;
+
+    // ace.ConsoleCascade: the exhaustive registry, searched only when the curated one is unsure.
+    TSharedPtr<FRegistryState, ESPMode::ThreadSafe> CompleteState;
+    FACERegistryWatcher CompleteWatcher;
+
+    // ace.ConsoleRegistrySource=1: console objects harvested from IConsoleManager on the game
+    // thread, merged with the curated JSON by the background loader.
+    struct FLiveSource;
+    TSharedPtr<FLiveSource, ESPMode::ThreadSafe> Live;
+    FDelegateHandle ModulesChangedHandle;
+    FTSTicker::FDelegateHandle HarvestTickHandle;
+
+    void ScheduleHarvest();
+    void Harvest();
 
-    static TArray<FString> Tokenize(const FString& S);
-    static float LexicalBonus(const TArray<FString>& Q, const FConsoleCommandEntry& E);
-    static float CosineLike(const TArray<FString>& Q, const TArray<FString>& D);
-    bool LoadJSON();
+    static TSharedPtr<const FRegistryData, ESPMode::ThreadSafe> Load();
+    static TSharedPtr<const FRegistryData, ESPMode::ThreadSafe> LoadComplete();
+    static TSharedPtr<const FRegistryData, ESPMode::ThreadSafe> LoadLive(FLiveSource& Source);
+    static bool LoadCompiled(FRegistryData& Out, const TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe>& Compiled, bool bCompleteTier = false);
+    static bool LoadJSON(FRegistryData& Out, const TArray<uint8>& Bytes);
 };
@@ -0,0 +1,84 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "ACERetrievalIndex.h"
+
+class FACEHnswIndex;
+
+enum class EACERetrievalMode : int32
+{
+    Sparse = 0,
+    Dense = 1,
+    Hybrid = 2,
+};
+
+// Dense retrieval that needs no model or service: every document is embedded as signed, hashed
+// character 3/4-gram counts, L2-normalized and quantized to int8. Vectors sit back to back in one
+// aligned buffer and are scored with SIMD int8 dot products, which tolerates paraphrases and
+// misspellings that exact-token BM25 misses.
+class ACEDIRECTORRUNTIME_API FACEDenseIndex
+{
+public:
+    static constexpr int32 Dim = 256;
+
+    FACEDenseIndex() = default;
+    FACEDenseIndex(const FACEDenseIndex& Other) { *this = Other; }
+    FACEDenseIndex& operator=(const FACEDenseIndex& Other);
+
+    void BeginBuild(int32 ExpectedDocs);
+    void AddDocument(FStringView Text);
+    void FinishBuild();
+
+    // Brute-force scan of the documents that pass Filter; writes the best OutHits.Num() with a
+    // positive cosine, best first.
+    int32 Query(FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter = FACEDocFilter()) const;
+    int32 QueryEmbedded(const int8* QueryVector, float QueryScale, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter = FACEDocFilter()) const;
+
+    // Embeds Text into Dim int8 components and returns the scale that maps them back to a unit
+    // vector, or 0 when Text has no tokens.
+    static float Embed(FStringView Text, int8* OutVector);
+
+    // Approximate cosine similarity between an embedded query and one document.
+    float Score(const int8* QueryVector, float QueryScale, int32 Doc) const
+    {
+        return (float)Dot(QueryVector, GetVector(Doc)) * QueryScale * ScalesView[Doc];
+    }
+
+    float ScoreDocs(int32 DocA, int32 DocB) const
+    {
+        return Score(GetVector(DocA), ScalesView[DocA], DocB);
+    }
+
+    // Sum of products of two Dim-long int8 vectors (AVX2 / SSE2 / NEON / scalar).
+    static int32 Dot(const int8* A, const int8* B);
+
+    const int8* GetVector(int32 Doc) const { return VectorsView.GetData() + (SIZE_T)Doc * Dim; }
+    int32 NumDocs() const { return ScalesView.Num(); }
+    SIZE_T GetAllocatedSize() const;
+
+    void Write(TArray<uint8>& Out) const;
+    bool Attach(const uint8*& Cursor, const uint8* End);
+
+private:
+    void SyncViews();
+
+    TArray<int8, TAlignedHeapAllocator<32>> Vectors;
+    TArray<float> Scales;
+
+    TConstArrayView<int8> VectorsView;
+    TConstArrayView<float> ScalesView;
+    bool bAttached = false;
+};
+
+namespace ACERetrieval
+{
+    // Current ace.RetrievalMode.
+    ACEDIRECTORRUNTIME_API EACERetrievalMode GetMode();
+
+    // Current ace.RetrievalDenseWeight, clamped to [0, 1].
+    ACEDIRECTORRUNTIME_API float GetDenseWeight();
+
+    // Answers a query from the sparse index, the dense index, or a blend of both, per ace.RetrievalMode.
+    // Dense lookups go through Graph when it was built over Dense, and scan Dense otherwise. Only
+    // documents that pass Filter are scored.
+    ACEDIRECTORRUNTIME_API int32 Query(const FACERetrievalIndex& Sparse, const FACEDenseIndex& Dense, const FACEHnswIndex& Graph, FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter = FACEDocFilter());
+}
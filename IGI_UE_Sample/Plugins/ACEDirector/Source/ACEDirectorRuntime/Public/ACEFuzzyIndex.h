@@ -0,0 +1,84 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "ACERetrievalIndex.h"
+
+// Typo- and ASR-tolerant lookup of entry names and aliases. Every name and alias is stored as a
+// key with separators removed ("stat fps" -> "statfps", "r.ScreenPercentage" ->
+// "rscreenpercentage") and indexed two ways:
+//  - padded character trigrams, filtered with the q-gram count bound for the allowed edits;
+//  - a Metaphone-style phonetic code that also folds voiced/unvoiced pairs ("fbs" and "fps" both
+//    encode as FPS), for transcripts that sound right but are spelled wrong.
+// Candidates from either side are verified with a bounded Levenshtein distance. Queries are tried
+// as every run of one to three consecutive tokens, so "slow mo" reaches "slomo".
+class ACEDIRECTORRUNTIME_API FACEFuzzyIndex
+{
+public:
+    FACEFuzzyIndex() = default;
+    FACEFuzzyIndex(const FACEFuzzyIndex& Other) { *this = Other; }
+    FACEFuzzyIndex& operator=(const FACEFuzzyIndex& Other);
+
+    void BeginBuild();
+    // Documents are numbered in the order they are added, matching the other indices.
+    void AddDocument(FStringView Name, TConstArrayView<FString> Aliases);
+    void FinishBuild();
+
+    // Best fuzzy similarity (1 - edits / length) of each document that passes Filter and whose keys
+    // match part of the query; writes the best OutHits.Num() documents, best first.
+    int32 Query(FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter = FACEDocFilter()) const;
+
+    // Adds ace.Fuzzy.Weight * similarity to the NumHits ranked hits, admitting fuzzy-only documents
+    // that pass Filter, and re-ranks. Returns the new count (at most Hits.Num()).
+    int32 Rescore(FStringView Query, TArrayView<FACERetrievalHit> Hits, int32 NumHits, const FACEDocFilter& Filter = FACEDocFilter()) const;
+
+    // Metaphone-style code of a lowercase key; exposed for tooling.
+    static int32 Encode(FStringView Key, TCHAR* OutCode, int32 MaxCode);
+
+    // Levenshtein distance of A and B, or MaxEdits + 1 once it is known to exceed MaxEdits.
+    static int32 BoundedEditDistance(FStringView A, FStringView B, int32 MaxEdits);
+
+    int32 NumDocs() const { return NumIndexedDocs; }
+    int32 NumKeys() const { return KeyDocView.Num(); }
+    SIZE_T GetAllocatedSize() const;
+
+    void Write(TArray<uint8>& Out) const;
+    bool Attach(const uint8*& Cursor, const uint8* End);
+
+private:
+    FStringView GetKey(int32 Key) const { return FStringView(KeyCharsView.GetData() + KeyStartView[Key], KeyStartView[Key + 1] - KeyStartView[Key]); }
+    void AddKey(FStringView Text, int32 Doc);
+    void SyncViews();
+
+    int32 NumIndexedDocs = 0;
+
+    TArray<TCHAR> KeyChars;   // normalized keys, back to back
+    TArray<int32> KeyStart = { 0 };
+    TArray<int32> KeyDoc;
+
+    // trigram hash (sorted, unique) -> keys containing it, CSR
+    TArray<uint32> GramHash;
+    TArray<int32> GramStart;
+    TArray<int32> GramKey;
+
+    // (phonetic code hash, key), sorted by hash
+    TArray<uint32> PhoneHash;
+    TArray<int32> PhoneKey;
+
+    TConstArrayView<TCHAR> KeyCharsView;
+    TConstArrayView<int32> KeyStartView;
+    TConstArrayView<int32> KeyDocView;
+    TConstArrayView<uint32> GramHashView;
+    TConstArrayView<int32> GramStartView;
+    TConstArrayView<int32> GramKeyView;
+    TConstArrayView<uint32> PhoneHashView;
+    TConstArrayView<int32> PhoneKeyView;
+    bool bAttached = false;
+};
+
+namespace ACEFuzzy
+{
+    // ace.Fuzzy.Weight.
+    ACEDIRECTORRUNTIME_API float GetWeight();
+
+    // ace.Fuzzy.MaxEdits, at least 0.
+    ACEDIRECTORRUNTIME_API int32 GetMaxEdits();
+}
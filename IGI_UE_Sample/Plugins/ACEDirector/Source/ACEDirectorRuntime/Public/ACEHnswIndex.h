@@ -0,0 +1,84 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "ACEDenseIndex.h"
+
+struct FACEHnswParams
+{
+    int32 M = 16;               // links per node on the upper layers; layer 0 keeps 2 * M
+    int32 EfConstruction = 100; // candidate list size while inserting
+};
+
+// Hierarchical navigable small-world graph over the vectors of an FACEDenseIndex, so dense queries
+// on large registries visit a few hundred documents instead of scanning all of them. The graph
+// stores document ids only; vectors are always read from the dense index it was built over.
+//
+// Links are flat: each node owns one block per layer it lives on, laid out as [Count, Link * Cap]
+// with Cap = 2 * M on layer 0 and M above it, so the graph serializes and attaches like the other
+// index sections.
+class ACEDIRECTORRUNTIME_API FACEHnswIndex
+{
+public:
+    FACEHnswIndex() = default;
+    FACEHnswIndex(const FACEHnswIndex& Other) { *this = Other; }
+    FACEHnswIndex& operator=(const FACEHnswIndex& Other);
+
+    void Build(const FACEDenseIndex& Vectors, const FACEHnswParams& Params);
+    void Reset();
+
+    // Approximate top-OutHits.Num() by cosine, best first, keeping only positive scores. Ef is the
+    // layer-0 candidate list size; larger trades latency for recall and is raised to at least K.
+    // Documents that fail Filter are still walked through but never returned, so a strict filter
+    // can leave fewer than K hits.
+    int32 Search(const FACEDenseIndex& Vectors, const int8* QueryVector, float QueryScale, int32 Ef, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter = FACEDocFilter()) const;
+
+    bool IsBuilt() const { return LevelsView.Num() > 0; }
+    int32 NumNodes() const { return LevelsView.Num(); }
+    int32 GetM() const { return M; }
+    SIZE_T GetAllocatedSize() const;
+
+    void Write(TArray<uint8>& Out) const;
+    bool Attach(const uint8*& Cursor, const uint8* End);
+
+private:
+    int32 LayerCap(int32 Layer) const { return Layer == 0 ? 2 * M : M; }
+    int32 LayerOffset(int32 Layer) const { return Layer == 0 ? 0 : (1 + 2 * M) + (Layer - 1) * (1 + M); }
+
+    const int32* GetLayer(int32 Node, int32 Layer) const { return LinksView.GetData() + LinkStartView[Node] + LayerOffset(Layer); }
+    int32* GetMutableLayer(int32 Node, int32 Layer) { return Links.GetData() + LinkStart[Node] + LayerOffset(Layer); }
+
+    template<typename SimilarityFn>
+    int32 GreedyClosest(int32 Entry, int32 Layer, SimilarityFn&& Similarity) const;
+
+    // Best-first search of one layer from Entry; leaves up to Ef results in OutResults, best first.
+    template<typename SimilarityFn>
+    void SearchLayer(int32 Entry, int32 Layer, int32 Ef, SimilarityFn&& Similarity, TArray<FACERetrievalHit>& OutResults) const;
+
+    void Insert(const FACEDenseIndex& Vectors, int32 Node, int32 EfConstruction);
+    void SelectNeighbors(const FACEDenseIndex& Vectors, TArray<FACERetrievalHit>& Candidates, int32 Cap) const;
+    void SyncViews();
+
+    int32 M = 0;
+    int32 EntryPoint = INDEX_NONE;
+    int32 MaxLevel = -1;
+
+    TArray<uint8> Levels;     // top layer of each node
+    TArray<int32> LinkStart;  // first slot of each node's link blocks
+    TArray<int32> Links;
+
+    TConstArrayView<uint8> LevelsView;
+    TConstArrayView<int32> LinkStartView;
+    TConstArrayView<int32> LinksView;
+    bool bAttached = false;
+};
+
+namespace ACEHnsw
+{
+    // Build parameters from ace.Hnsw.M / ace.Hnsw.EfConstruction.
+    ACEDIRECTORRUNTIME_API FACEHnswParams GetBuildParams();
+
+    // ace.Hnsw.EfSearch.
+    ACEDIRECTORRUNTIME_API int32 GetEfSearch();
+
+    // Registries with fewer documents than ace.Hnsw.MinDocs keep the brute-force scan.
+    ACEDIRECTORRUNTIME_API bool ShouldBuild(int32 NumDocs);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "ACERetrievalIndex.h"
+
+// A key of the trie found at the start of some text.
+struct FACENameMatch
+{
+    int32 Node = INDEX_NONE;
+    int32 End = 0;     // index in the text just past the key; the rest is arguments
+};
+
+// Path-compressed prefix trie over entry names and aliases, for recognizing directives that are
+// literally an entry ("stat fps", "r.ScreenPercentage 50") without scoring anything. Keys are
+// matched case-insensitively with whitespace runs treated as one space, and only end at a word
+// boundary, so "stat" is a prefix of "stat fps" but "sta" is not.
+class ACEDIRECTORRUNTIME_API FACENameTrie
+{
+public:
+    FACENameTrie() = default;
+    FACENameTrie(const FACENameTrie& Other) { *this = Other; }
+    FACENameTrie& operator=(const FACENameTrie& Other);
+
+    void BeginBuild();
+    // Documents are numbered in the order they are added, matching the other indices.
+    void AddDocument(FStringView Name, TConstArrayView<FString> Aliases);
+    void FinishBuild();
+
+    // Every key that starts Text, shortest first; at most OutMatches.Num(). Returns the count.
+    int32 MatchPrefixes(FStringView Text, TArrayView<FACENameMatch> OutMatches) const;
+
+    // Type-ahead: documents that pass Filter with a key starting with Prefix (which may stop
+    // mid-word), shortest keys first; at most OutHits.Num(). Scores are the typed share of the
+    // key, in (0, 1]. Stops early once FPlatformTime::Seconds() passes Deadline. Returns the count.
+    int32 Complete(FStringView Prefix, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter = FACEDocFilter(),
+        double Deadline = TNumericLimits<double>::Max()) const;
+
+    // Documents whose name or an alias ends at Node.
+    TConstArrayView<int32> GetDocs(int32 Node) const
+    {
+        return TConstArrayView<int32>(NodeDocsView.GetData() + DocStartView[Node], DocStartView[Node + 1] - DocStartView[Node]);
+    }
+
+    int32 NumDocs() const { return NumIndexedDocs; }
+    int32 NumNodes() const { return FMath::Max(0, LabelStartView.Num() - 1); }
+    SIZE_T GetAllocatedSize() const;
+
+    void Write(TArray<uint8>& Out) const;
+    bool Attach(const uint8*& Cursor, const uint8* End);
+
+private:
+    void AddKey(FStringView Text, int32 Doc);
+    void SyncViews();
+
+    int32 NumIndexedDocs = 0;
+
+    // Build-time, uncompressed: one node per character. Released by FinishBuild().
+    struct FPendingNode
+    {
+        TArray<TPair<TCHAR, int32>, TInlineAllocator<2>> Children;
+        TArray<int32, TInlineAllocator<1>> Docs;
+    };
+    TArray<FPendingNode> Pending;
+
+    // Node 0 is the root. Each node's label is the run of characters from its parent; children are
+    // sorted by the first character of their label.
+    TArray<TCHAR> Labels;
+    TArray<int32> LabelStart;
+    TArray<int32> ChildStart;
+    TArray<int32> Children;
+    TArray<int32> DocStart;
+    TArray<int32> NodeDocs;
+
+    TConstArrayView<TCHAR> LabelsView;
+    TConstArrayView<int32> LabelStartView;
+    TConstArrayView<int32> ChildStartView;
+    TConstArrayView<int32> ChildrenView;
+    TConstArrayView<int32> DocStartView;
+    TConstArrayView<int32> NodeDocsView;
+    bool bAttached = false;
+};
@@ -0,0 +1,180 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "ACERetrievalCore.h"
+#include "ACESnapshot.h"
+#include "ACERetrievalCache.h"
+#include <atomic>
+
+// Retrieval results for native callers: entry index + score into a registry snapshot, which the
+// list keeps alive. Entries are read in place, so nothing is copied per query.
+template<typename EntryType>
+class TACEHitList
+{
+public:
+    using FData = TACERegistryData<EntryType>;
+    using FDataPtr = TSharedPtr<const FData, ESPMode::ThreadSafe>;
+
+    int32 Num() const { return Hits.Num(); }
+    bool IsEmpty() const { return Hits.Num() == 0; }
+
+    // The registry hit i points into.
+    const FData& GetData(int32 i) const { return SourceOf.Num() > 0 ? *Sources[SourceOf[i]] : *Data; }
+
+    const EntryType& GetEntry(int32 i) const { return GetData(i).Entries[Hits[i].Doc]; }
+    float GetScore(int32 i) const { return Hits[i].Score; }
+
+    // Docs and other cold fields of hit i, inflated on demand.
+    FACEColdText GetText(int32 i) const { return GetData(i).GetText(Hits[i].Doc); }
+    TConstArrayView<FACERetrievalHit> GetHits() const { return Hits; }
+
+    // Keeps hits scoring at least MinScore, in order.
+    void RemoveBelow(float MinScore)
+    {
+        int32 Kept = 0;
+        for (int32 i = 0; i < Hits.Num(); ++i)
+        {
+            if (Hits[i].Score < MinScore) continue;
+            Hits[Kept] = Hits[i];
+            if (SourceOf.Num() > 0) SourceOf[Kept] = SourceOf[i];
+            ++Kept;
+        }
+        Hits.SetNum(Kept, EAllowShrinking::No);
+        if (SourceOf.Num() > 0) SourceOf.SetNum(Kept, EAllowShrinking::No);
+    }
+
+    void Reset()
+    {
+        Data.Reset();
+        Hits.Reset();
+        Sources.Reset();
+        SourceOf.Reset();
+    }
+
+    FDataPtr Data;
+    TArray<FACERetrievalHit, TInlineAllocator<8>> Hits;
+
+    // Only for lists merged from several registries (the console cascade): hit i then points into
+    // Sources[SourceOf[i]] and Data is unused.
+    TArray<FDataPtr, TInlineAllocator<2>> Sources;
+    TArray<uint8, TInlineAllocator<8>> SourceOf;
+};
+
+// State a registry subsystem shares with its background load tasks. Tasks hold a reference, so a
+// load that finishes after the subsystem is gone just publishes into an orphaned snapshot.
+template<typename EntryType>
+class TACERegistryState : public TSharedFromThis<TACERegistryState<EntryType>, ESPMode::ThreadSafe>
+{
+public:
+    using FData = TACERegistryData<EntryType>;
+    using FDataPtr = TSharedPtr<const FData, ESPMode::ThreadSafe>;
+    using FReadScope = typename TACESnapshot<FData>::FReadScope;
+
+    explicit TACERegistryState(TFunction<FDataPtr()> InLoad)
+        : Load(MoveTemp(InLoad))
+    {
+    }
+
+    TACESnapshot<FData> Snapshot;
+
+    // Recent results, keyed on the normalized query and invalidated by snapshot generation.
+    FACERetrievalCache Cache;
+
+    // Retrieval against the snapshot Scope has open, through Cache.
+    int32 QueryCached(const FReadScope& Scope, FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACERetrievalFilter& Filter = FACERetrievalFilter())
+    {
+        const FACEDocFilter DocFilter = Scope->Index.MakeFilter(Filter);
+        return QueryCached(Scope, FACERetrievalCache::MakeKey(Query, OutHits.Num(), DocFilter), Query, OutHits, DocFilter);
+    }
+
+    int32 QueryCached(const FReadScope& Scope, uint64 Key, FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& DocFilter)
+    {
+        int32 Count = Cache.Find(Key, Scope.GetGeneration(), OutHits);
+        if (Count == INDEX_NONE)
+        {
+            Count = Scope->Index.Query(Query, OutHits, DocFilter);
+            Cache.Add(Key, Scope.GetGeneration(), OutHits.Slice(0, Count));
+        }
+        return Count;
+    }
+
+    // Retrieval for many queries against one snapshot. Every query is normalized up front on the
+    // calling thread, so repeats within the batch are scored once, and the distinct ones are scored
+    // with ParallelFor. Query q gets OutHits[q * K, q * K + OutCounts[q]). Filter applies to all.
+    void QueryBatch(const FReadScope& Scope, TConstArrayView<FString> Queries, int32 K, TArray<FACERetrievalHit>& OutHits, TArray<int32>& OutCounts,
+        const FACERetrievalFilter& Filter = FACERetrievalFilter())
+    {
+        const int32 NumQueries = Queries.Num();
+        K = FMath::Max(0, K);
+        OutHits.SetNumUninitialized(NumQueries * K);
+        OutCounts.SetNumZeroed(NumQueries);
+        if (NumQueries == 0 || K == 0) return;
+
+        const FACEDocFilter DocFilter = Scope->Index.MakeFilter(Filter);
+        TArray<uint64> Keys;
+        TArray<int32> Distinct;     // first query with each key
+        TArray<int32> DistinctOf;   // query -> index into Distinct
+        TMap<uint64, int32> Seen;
+        DistinctOf.SetNumUninitialized(NumQueries);
+        for (int32 q = 0; q < NumQueries; ++q)
+        {
+            const uint64 Key = FACERetrievalCache::MakeKey(Queries[q], K, DocFilter);
+            if (const int32* Found = Seen.Find(Key))
+            {
+                DistinctOf[q] = *Found;
+                continue;
+            }
+            DistinctOf[q] = Distinct.Add(q);
+            Seen.Add(Key, DistinctOf[q]);
+            Keys.Add(Key);
+        }
+
+        ParallelFor(Distinct.Num(), [this, &Scope, &Queries, &Keys, &Distinct, &DocFilter, &OutHits, &OutCounts, K](int32 d)
+            {
+                const int32 q = Distinct[d];
+                OutCounts[q] = QueryCached(Scope, Keys[d], Queries[q], MakeArrayView(OutHits.GetData() + q * K, K), DocFilter);
+            });
+
+        for (int32 q = 0; q < NumQueries; ++q)
+        {
+            const int32 Source = Distinct[DistinctOf[q]];
+            if (Source == q) continue;
+            OutCounts[q] = OutCounts[Source];
+            FMemory::Memcpy(OutHits.GetData() + q * K, OutHits.GetData() + Source * K, OutCounts[q] * sizeof(FACERetrievalHit));
+        }
+    }
+
+    // Runs the loader on a background task and publishes its result. Requests that arrive while a
+    // load is running are coalesced into a single follow-up load.
+    void RequestLoad()
+    {
+        bLoadPending.store(true);
+        if (bLoadInFlight.exchange(true)) return;
+
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [This = this->AsShared()]()
+            {
+                do
+                {
+                    This->bLoadPending.store(false);
+                    FDataPtr Loaded = This->Load();
+                    if (!Loaded && !This->Snapshot.IsSet())
+                    {
+                        // Nothing to load at all: publish an empty registry so readers stop waiting.
+                        Loaded = MakeShared<FData, ESPMode::ThreadSafe>();
+                    }
+                    if (Loaded)
+                    {
+                        // A failed reload (e.g. a half-written file) keeps the previous snapshot.
+                        This->Snapshot.Publish(MoveTemp(Loaded));
+                    }
+                    This->bLoadInFlight.store(false);
+                } while (This->bLoadPending.load() && !This->bLoadInFlight.exchange(true));
+            });
+    }
+
+private:
+    TFunction<FDataPtr()> Load;
+    std::atomic<bool> bLoadInFlight{ false };
+    std::atomic<bool> bLoadPending{ false };
+};
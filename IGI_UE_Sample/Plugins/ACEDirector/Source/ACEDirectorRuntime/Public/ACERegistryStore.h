@@ -0,0 +1,94 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Hash/xxhash.h"
+#include "Misc/ScopeLock.h"
+#include "ACERetrievalCore.h"
+
+// Process-wide registry data, shared by every GameInstance that loads the same file with the same
+// content (multi-client PIE, editor plus a standalone game in one process). Only weak references
+// are kept: the data goes away with the last snapshot that uses it, and an edited file hashes to
+// a new key, so hot reload never gets the old data back.
+template<typename EntryType>
+class TACERegistryStore
+{
+public:
+    using FData = TACERegistryData<EntryType>;
+    using FDataPtr = TSharedPtr<const FData, ESPMode::ThreadSafe>;
+
+    static uint64 HashContent(const void* Data, int64 Size)
+    {
+        return FXxHash64::HashBuffer(Data, (uint64)Size).Hash;
+    }
+
+    // The data already loaded from Path with ContentHash, or whatever Build() returns (remembered
+    // when non-null). Build() runs outside the store lock: callers asking for the same key while it
+    // runs wait for its result rather than parsing and indexing the same file a second time, and
+    // callers for any other key are not held up at all.
+    static FDataPtr FindOrBuild(const FString& Path, uint64 ContentHash, TFunctionRef<FDataPtr()> Build, bool* bOutShared = nullptr)
+    {
+        FStore& Store = Get();
+        const FString Key = FString::Printf(TEXT("%s#%016llx"), *Path, ContentHash);
+        if (bOutShared) *bOutShared = false;
+
+        TSharedPtr<TPromise<FDataPtr>> Promise;
+        TSharedFuture<FDataPtr> InFlight;
+        {
+            FScopeLock Lock(&Store.Lock);
+            if (FDataPtr Existing = Store.Loaded.FindRef(Key).Pin())
+            {
+                if (bOutShared) *bOutShared = true;
+                return Existing;
+            }
+
+            if (const TSharedFuture<FDataPtr>* Building = Store.Building.Find(Key))
+            {
+                InFlight = *Building;
+            }
+            else
+            {
+                for (auto It = Store.Loaded.CreateIterator(); It; ++It)
+                {
+                    if (!It->Value.IsValid()) It.RemoveCurrent();
+                }
+                Promise = MakeShared<TPromise<FDataPtr>>();
+                Store.Building.Add(Key, Promise->GetFuture().Share());
+            }
+        }
+
+        if (!Promise.IsValid())
+        {
+            if (FDataPtr Shared = InFlight.Get())
+            {
+                if (bOutShared) *bOutShared = true;
+                return Shared;
+            }
+            // That build failed; try again, which builds here unless someone else already is.
+            return FindOrBuild(Path, ContentHash, Build, bOutShared);
+        }
+
+        FDataPtr Built = Build();
+        {
+            FScopeLock Lock(&Store.Lock);
+            if (Built.IsValid()) Store.Loaded.Add(Key, Built);
+            Store.Building.Remove(Key);
+        }
+        Promise->SetValue(Built);
+        return Built;
+    }
+
+private:
+    struct FStore
+    {
+        FCriticalSection Lock;
+        TMap<FString, TWeakPtr<const FData, ESPMode::ThreadSafe>> Loaded;
+        // Keys whose Build() is running, with the result their waiters block on.
+        TMap<FString, TSharedFuture<FDataPtr>> Building;
+    };
+
+    static FStore& Get()
+    {
+        static FStore Store;
+        return Store;
+    }
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include "CoreMinimal.h"
+
+struct FFileChangeData;
+
+// Calls OnChanged on the game thread whenever the watched registry file is written, so designers
+// can edit ACE/data while PIE is running. Editor builds only; a no-op in cooked games.
+class ACEDIRECTORRUNTIME_API FACERegistryWatcher
+{
+public:
+    ~FACERegistryWatcher() { Stop(); }
+
+    void Start(const FString& FilePath, TFunction<void()> InOnChanged);
+    void Stop();
+
+private:
+#if WITH_EDITOR
+    void HandleDirectoryChanged(const TArray<FFileChangeData>& Changes);
+
+    FString WatchedDir;
+    FString WatchedFile;
+    FDelegateHandle Handle;
+    TFunction<void()> OnChanged;
+#endif
+};
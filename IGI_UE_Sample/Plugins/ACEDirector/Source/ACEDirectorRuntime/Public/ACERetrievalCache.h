@@ -0,0 +1,52 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "ACERetrievalIndex.h"
+
+// Size-bounded LRU of retrieval results in front of a registry index. Keys are a 64-bit hash of
+// the query's lowercase tokens (so "Stat  FPS!" and "stat fps" share an entry), K, the filter's
+// blocked tag bits and the cvars that change rankings: ace.RetrievalMode, ace.RetrievalDenseWeight,
+// ace.Hnsw.EfSearch, ace.Fuzzy.Weight and ace.Fuzzy.MaxEdits. A new ranking cvar must be added to
+// MakeKey too.
+// Slots keep their hits inline and are allocated only when ace.RetrievalCacheSize changes, so
+// lookups and inserts do not allocate; queries for more than MaxHits results bypass the cache.
+// Results are only valid for the snapshot generation they were computed from; the first lookup
+// against a newer generation drops everything. Safe to use from any thread.
+class ACEDIRECTORRUNTIME_API FACERetrievalCache
+{
+public:
+    static constexpr int32 MaxHits = 16;
+
+    FACERetrievalCache();
+
+    static uint64 MakeKey(FStringView Query, int32 K, const FACEDocFilter& Filter = FACEDocFilter());
+
+    // Copies the cached hits into OutHits and returns their count, or INDEX_NONE on a miss.
+    int32 Find(uint64 Key, uint32 Generation, TArrayView<FACERetrievalHit> OutHits);
+    void Add(uint64 Key, uint32 Generation, TConstArrayView<FACERetrievalHit> Hits);
+    void Reset();
+
+private:
+    struct FSlot
+    {
+        uint64 Key = 0;
+        int32 Prev = INDEX_NONE;
+        int32 Next = INDEX_NONE;
+        int32 NumHits = 0;
+        FACERetrievalHit Hits[MaxHits];
+    };
+
+    // Resizes to ace.RetrievalCacheSize and drops entries from other generations. Lock held.
+    bool Sync(uint32 InGeneration);
+    // Drops every entry but keeps the storage. Lock held.
+    void Clear();
+    void Unlink(int32 Slot);
+    void LinkFront(int32 Slot);
+
+    FCriticalSection Lock;
+    TArray<FSlot> Slots;
+    TMap<uint64, int32> SlotOf;
+    int32 NumUsed = 0;
+    int32 Head = INDEX_NONE;    // most recently used
+    int32 Tail = INDEX_NONE;    // evicted next
+    uint32 Generation = 0;
+};
@@ -0,0 +1,198 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "ACERetrievalIndex.h"
+#include "ACEDenseIndex.h"
+#include "ACEHnswIndex.h"
+#include "ACEFuzzyIndex.h"
+#include "ACETagIndex.h"
+#include "ACENameTrie.h"
+#include "ACEColdText.h"
+
+class FACECompiledRegistry;
+
+// Maps a registry entry type onto the index. Specialized next to each entry struct. "Cold" fields
+// are the ones only prompts read; GetColdField(E, i) returns field i for i < NumColdFields.
+template<typename EntryType>
+struct TACERetrievalTraits;
+
+// Sparse (BM25) and dense (hashed n-gram) indices over the same entries; ace.RetrievalMode picks
+// which one answers a query, or blends both. Large registries also get an HNSW graph over the
+// dense vectors (see ace.Hnsw.MinDocs). Whatever the mode, fuzzy name/alias matches are folded
+// into the result so misspelled or misheard entry names still surface. Entry tags are kept as
+// bitsets, so a filter skips whole classes of entries before any of them is scored, and names and
+// aliases go into a prefix trie for directives that spell out an entry exactly.
+template<typename EntryType>
+class TACERetrievalCore
+{
+public:
+    using FTraits = TACERetrievalTraits<EntryType>;
+
+    void Build(TConstArrayView<EntryType> Entries)
+    {
+        Index.BeginBuild(FTraits::LexicalWeights());
+        Dense.BeginBuild(Entries.Num());
+        Fuzzy.BeginBuild();
+        Tags.BeginBuild();
+        Names.BeginBuild();
+        FString Text;
+        for (const EntryType& E : Entries)
+        {
+            Text.Reset();
+            FTraits::AppendDocText(E, Text);
+            Index.AddDocument(Text, FTraits::GetName(E), FTraits::GetAliases(E), FTraits::GetTags(E));
+            Dense.AddDocument(Text);
+            Fuzzy.AddDocument(FTraits::GetName(E), FTraits::GetAliases(E));
+            Tags.AddDocument(FTraits::GetTags(E));
+            Names.AddDocument(FTraits::GetName(E), FTraits::GetAliases(E));
+        }
+        Index.FinishBuild();
+        Dense.FinishBuild();
+        Fuzzy.FinishBuild();
+        Tags.FinishBuild();
+        Names.FinishBuild();
+
+        Graph.Reset();
+        if (ACEHnsw::ShouldBuild(Dense.NumDocs()))
+        {
+            Graph.Build(Dense, ACEHnsw::GetBuildParams());
+        }
+    }
+
+    FACEDocFilter MakeFilter(const FACERetrievalFilter& Filter) const
+    {
+        return Tags.Compile(Filter);
+    }
+
+    int32 Query(FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter = FACEDocFilter()) const
+    {
+        const int32 Count = ACERetrieval::Query(Index, Dense, Graph, Query, OutHits, Filter);
+        return Fuzzy.Rescore(Query, OutHits, Count, Filter);
+    }
+
+    // Type-ahead for a partly typed name: completions of Prefix from the name trie, shortest first,
+    // then fuzzy near misses when there are too few; completions score in (0.5, 1], near misses
+    // below. Stops adding once FPlatformTime::Seconds() passes Deadline.
+    int32 Suggest(FStringView Prefix, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter, double Deadline) const
+    {
+        int32 Count = Names.Complete(Prefix, OutHits, Filter, Deadline);
+        for (int32 i = 0; i < Count; ++i) OutHits[i].Score = 0.5f + 0.5f * OutHits[i].Score;
+
+        // One or two characters match nearly everything fuzzily.
+        if (Count == OutHits.Num() || Prefix.TrimStartAndEnd().Len() < 3 || FPlatformTime::Seconds() > Deadline) return Count;
+        TArray<FACERetrievalHit, TInlineAllocator<16>> Near;
+        Near.SetNumUninitialized(OutHits.Num());
+        const int32 NumNear = Fuzzy.Query(Prefix, Near, Filter);
+        for (int32 n = 0; n < NumNear && Count < OutHits.Num(); ++n)
+        {
+            bool bSeen = false;
+            for (int32 h = 0; h < Count && !bSeen; ++h) bSeen = OutHits[h].Doc == Near[n].Doc;
+            if (!bSeen) OutHits[Count++] = { Near[n].Doc, 0.5f * Near[n].Score };
+        }
+        return Count;
+    }
+
+    void Write(TArray<uint8>& Out) const
+    {
+        Index.Write(Out);
+        Dense.Write(Out);
+        Graph.Write(Out);
+        Fuzzy.Write(Out);
+        Tags.Write(Out);
+        Names.Write(Out);
+    }
+
+    bool Attach(const uint8*& Cursor, const uint8* End)
+    {
+        return Index.Attach(Cursor, End) && Dense.Attach(Cursor, End) && Dense.NumDocs() == Index.NumDocs()
+            && Graph.Attach(Cursor, End) && (!Graph.IsBuilt() || Graph.NumNodes() == Dense.NumDocs())
+            && Fuzzy.Attach(Cursor, End) && Fuzzy.NumDocs() == Index.NumDocs()
+            && Tags.Attach(Cursor, End) && Tags.NumDocs() == Index.NumDocs()
+            && Names.Attach(Cursor, End) && Names.NumDocs() == Index.NumDocs();
+    }
+
+    const FACERetrievalIndex& GetIndex() const { return Index; }
+    const FACEDenseIndex& GetDenseIndex() const { return Dense; }
+    const FACEHnswIndex& GetGraph() const { return Graph; }
+    const FACEFuzzyIndex& GetFuzzyIndex() const { return Fuzzy; }
+    const FACETagIndex& GetTagIndex() const { return Tags; }
+    const FACENameTrie& GetNameTrie() const { return Names; }
+
+    SIZE_T GetAllocatedSize() const
+    {
+        return Index.GetAllocatedSize() + Dense.GetAllocatedSize() + Graph.GetAllocatedSize() + Fuzzy.GetAllocatedSize() + Tags.GetAllocatedSize()
+            + Names.GetAllocatedSize();
+    }
+
+private:
+    FACERetrievalIndex Index;
+    FACEDenseIndex Dense;
+    FACEHnswIndex Graph;
+    FACEFuzzyIndex Fuzzy;
+    FACETagIndex Tags;
+    FACENameTrie Names;
+};
+
+// One loaded registry: the entries and the index over them. Built off the game thread and never
+// modified after it is published.
+template<typename EntryType>
+struct TACERegistryData
+{
+    using FTraits = TACERetrievalTraits<EntryType>;
+
+    TArray<EntryType> Entries;
+    TACERetrievalCore<EntryType> Index;
+
+    // The cold fields of Entries, once CompactText() has moved them here.
+    FACEColdTextStore ColdText;
+
+    // Keeps a mapped compiled blob alive while Index points into it.
+    TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe> Compiled;
+
+    // Moves the cold fields out of Entries into ColdText (when ace.CompressRegistryText is on).
+    // Call once Index is built; the index reads them, prompts are served from ColdText after this.
+    void CompactText(const TCHAR* RegistryName)
+    {
+        if (!ACEColdText::IsEnabled() || Entries.Num() == 0) return;
+
+        ColdText.Build(Entries.Num(), FTraits::NumColdFields, [this](int32 Entry, int32 Field)
+            {
+                return FStringView(FTraits::GetColdField(Entries[Entry], Field));
+            });
+        for (EntryType& E : Entries)
+        {
+            for (int32 Field = 0; Field < FTraits::NumColdFields; ++Field)
+            {
+                FTraits::GetColdField(E, Field).Empty();
+            }
+        }
+        UE_LOG(LogACERegistry, Log, TEXT("%s registry: %.1f KB of docs/schemas/examples kept as %.1f KB compressed"),
+            RegistryName, ColdText.GetRawBytes() / 1024.0, ColdText.GetAllocatedSize() / 1024.0);
+    }
+
+    // Cold fields of Entries[Doc], wherever they live.
+    FACEColdText GetText(int32 Doc) const
+    {
+        if (!ColdText.IsEmpty()) return ColdText.Get(Doc);
+        FACEColdText Out;
+        for (int32 Field = 0; Field < FTraits::NumColdFields; ++Field)
+        {
+            Out.Fields.Add(FTraits::GetColdField(Entries[Doc], Field));
+        }
+        return Out;
+    }
+
+    // Entries[Doc] with its cold fields filled back in.
+    EntryType CopyEntry(int32 Doc) const
+    {
+        EntryType Out = Entries[Doc];
+        if (!ColdText.IsEmpty())
+        {
+            const FACEColdText Text = ColdText.Get(Doc);
+            for (int32 Field = 0; Field < FTraits::NumColdFields; ++Field)
+            {
+                FTraits::GetColdField(Out, Field) = FString(Text.Get(Field));
+            }
+        }
+        return Out;
+    }
+};
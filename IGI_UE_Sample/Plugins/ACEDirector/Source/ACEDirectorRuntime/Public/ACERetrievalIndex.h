@@ -0,0 +1,205 @@
+#pragma once
+#include "CoreMinimal.h"
+
+ACEDIRECTORRUNTIME_API DECLARE_LOG_CATEGORY_EXTERN(LogACERegistry, Log, All);
+
+struct FACERetrievalHit
+{
+    int32 Doc = INDEX_NONE;
+    float Score = 0.f;
+};
+
+// Which documents a query may return: a document passes when it carries none of the blocked tag
+// bits (see FACETagIndex::Compile). Everything passes when nothing is blocked.
+struct FACEDocFilter
+{
+    TConstArrayView<uint64> DocBits;                // Blocked.Num() words per document
+    TArray<uint64, TInlineAllocator<4>> Blocked;
+
+    bool IsActive() const { return Blocked.Num() > 0; }
+
+    bool Passes(int32 Doc) const
+    {
+        const int32 Words = Blocked.Num();
+        const uint64* Bits = DocBits.GetData() + (SIZE_T)Doc * Words;
+        for (int32 w = 0; w < Words; ++w)
+        {
+            if (Bits[w] & Blocked[w]) return false;
+        }
+        return true;
+    }
+};
+
+// Bonus added per query term that equals the entry name, is contained in an alias, or equals a tag.
+struct FACELexicalWeights
+{
+    float Name = 1.0f;
+    float Alias = 0.15f;
+    float Tag = 0.1f;
+    float Clamp = 2.0f;
+};
+
+// Interns lowercase alphanumeric tokens to dense ids. Lookups hash and compare the caller's
+// characters in place, so resolving a query never allocates.
+class ACEDIRECTORRUNTIME_API FACETermDictionary
+{
+public:
+    FACETermDictionary() { SyncViews(); }
+    FACETermDictionary(const FACETermDictionary& Other) { *this = Other; }
+    FACETermDictionary& operator=(const FACETermDictionary& Other);
+
+    void Reset();
+    int32 FindOrAdd(FStringView Token);
+    int32 Find(FStringView Token) const;
+    int32 Num() const { return TermHashView.Num(); }
+    FStringView GetTerm(int32 Id) const { return FStringView(CharsView.GetData() + TermStartView[Id], TermStartView[Id + 1] - TermStartView[Id]); }
+    SIZE_T GetAllocatedSize() const;
+
+    void Write(TArray<uint8>& Out) const;
+    bool Attach(const uint8*& Cursor, const uint8* End);
+
+private:
+    static uint32 HashToken(FStringView Token);
+    bool Equals(int32 Id, FStringView Token) const;
+    void Grow();
+    void SyncViews();
+
+    TArray<TCHAR> Chars;       // lowercase term text, back to back
+    TArray<int32> TermStart = { 0 };
+    TArray<uint32> TermHash;
+    TArray<int32> Slots;       // open addressing, INDEX_NONE = empty
+
+    // What lookups read: the arrays above, or a compiled registry blob.
+    TConstArrayView<TCHAR> CharsView;
+    TConstArrayView<int32> TermStartView;
+    TConstArrayView<uint32> TermHashView;
+    TConstArrayView<int32> SlotsView;
+    bool bAttached = false;
+};
+
+// Registry retrieval index shared by the console and world-action registries.
+// Documents are stored as sorted sparse vectors (structure of arrays) of precomputed BM25 term
+// weights plus a sparse lexical-bonus table; postings are only used to find the documents a query
+// touches, which are then scored with a merge-join against the query vector.
+class ACEDIRECTORRUNTIME_API FACERetrievalIndex
+{
+public:
+    FACERetrievalIndex() = default;
+    FACERetrievalIndex(const FACERetrievalIndex& Other) { *this = Other; }
+    FACERetrievalIndex& operator=(const FACERetrievalIndex& Other);
+
+    // Calls Fn(FStringView) for every alphanumeric run in S, as written. Matching is case-insensitive
+    // (tokens are lowercased when the term dictionary hashes and compares them).
+    template<typename FnType>
+    static void ForEachToken(FStringView S, FnType&& Fn)
+    {
+        int32 Start = INDEX_NONE;
+        for (int32 i = 0; i <= S.Len(); ++i)
+        {
+            const bool bAlnum = i < S.Len() && FChar::IsAlnum(S[i]);
+            if (bAlnum && Start == INDEX_NONE) Start = i;
+            else if (!bAlnum && Start != INDEX_NONE) { Fn(S.Mid(Start, i - Start)); Start = INDEX_NONE; }
+        }
+    }
+
+    void BeginBuild(const FACELexicalWeights& InWeights);
+    void AddDocument(FStringView Text, FStringView Name, TConstArrayView<FString> Aliases, TConstArrayView<FString> Tags);
+    void FinishBuild();
+
+    // Scores the documents touched by the query that pass Filter and writes the best OutHits.Num()
+    // with Score > 0, best first. Returns the number written. Uses per-thread scratch; no heap
+    // allocation once warm.
+    int32 Query(FStringView Query, TArrayView<FACERetrievalHit> OutHits, const FACEDocFilter& Filter = FACEDocFilter()) const;
+
+    // Appends the index to a compiled registry blob. Arrays are 16-byte aligned relative to Out.
+    void Write(TArray<uint8>& Out) const;
+
+    // Points the index at data produced by Write(). The memory must outlive the index and start
+    // 16-byte aligned. Advances Cursor past the index on success.
+    bool Attach(const uint8*& Cursor, const uint8* End);
+
+    int32 NumDocs() const { return FMath::Max(0, DocStartView.Num() - 1); }
+    int32 NumTerms() const { return Dict.Num(); }
+    SIZE_T GetAllocatedSize() const;
+
+    float K1 = 1.2f;
+    float B = 0.75f;
+
+private:
+    FACETermDictionary Dict;
+    FACELexicalWeights Weights;
+
+    // Build-time state, released by FinishBuild().
+    TArray<TArray<TPair<int32, float>>> PendingDocTf;
+    TArray<TArray<TPair<int32, float>>> PendingDocBonus;
+
+    TArray<float> Idf;
+
+    // term -> documents containing the term or carrying a bonus for it
+    TArray<int32> PostingStart;
+    TArray<int32> PostingDoc;
+
+    // document -> sorted (term, BM25 weight)
+    TArray<int32> DocStart;
+    TArray<int32> DocTerm;
+    TArray<float> DocWeight;
+
+    // document -> sorted (term, lexical bonus)
+    TArray<int32> BonusStart;
+    TArray<int32> BonusTerm;
+    TArray<float> BonusValue;
+
+    void SyncViews();
+
+    // Queries only read these; they alias the arrays above or an attached blob.
+    TConstArrayView<float> IdfView;
+    TConstArrayView<int32> PostingStartView;
+    TConstArrayView<int32> PostingDocView;
+    TConstArrayView<int32> DocStartView;
+    TConstArrayView<int32> DocTermView;
+    TConstArrayView<float> DocWeightView;
+    TConstArrayView<int32> BonusStartView;
+    TConstArrayView<int32> BonusTermView;
+    TConstArrayView<float> BonusValueView;
+    bool bAttached = false;
+};
+
+namespace ACERetrievalBlob
+{
+    inline void Pad16(TArray<uint8>& Out)
+    {
+        Out.AddZeroed(::Align(Out.Num(), 16) - Out.Num());
+    }
+
+    template<typename T>
+    void WritePod(TArray<uint8>& Out, const T& Value)
+    {
+        Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+    }
+
+    template<typename T>
+    void WriteArray(TArray<uint8>& Out, TConstArrayView<T> Values)
+    {
+        Pad16(Out);
+        Out.Append(reinterpret_cast<const uint8*>(Values.GetData()), Values.Num() * sizeof(T));
+    }
+
+    template<typename T>
+    bool ReadPod(const uint8*& Cursor, const uint8* End, T& OutValue)
+    {
+        if (End - Cursor < (int64)sizeof(T)) return false;
+        FMemory::Memcpy(&OutValue, Cursor, sizeof(T));
+        Cursor += sizeof(T);
+        return true;
+    }
+
+    template<typename T>
+    bool ReadArray(const uint8*& Cursor, const uint8* End, int32 Num, TConstArrayView<T>& OutView)
+    {
+        const uint8* Aligned = reinterpret_cast<const uint8*>(::Align(reinterpret_cast<UPTRINT>(Cursor), 16));
+        if (Num < 0 || Aligned > End || (End - Aligned) < (int64)Num * (int64)sizeof(T)) return false;
+        OutView = MakeArrayView(reinterpret_cast<const T*>(Aligned), Num);
+        Cursor = Aligned + (int64)Num * sizeof(T);
+        return true;
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+#include <atomic>
+
+// RCU-style publication of immutable data. Readers open an FReadScope and get a const pointer
+// without taking a lock; Publish() swaps in a new value and releases the previous one only after
+// every reader that could still see it has left its scope.
+template<typename T>
+class TACESnapshot
+{
+    struct FNode
+    {
+        TSharedPtr<const T, ESPMode::ThreadSafe> Value;
+        uint32 Generation = 0;
+    };
+
+public:
+    using FValuePtr = TSharedPtr<const T, ESPMode::ThreadSafe>;
+
+    class FReadScope
+    {
+    public:
+        explicit FReadScope(const TACESnapshot& InOwner)
+            : Owner(InOwner)
+        {
+            // Register in the current phase; retry if a writer flipped it in between so the
+            // writer is guaranteed to see us before it frees anything we might load.
+            for (;;)
+            {
+                Phase = Owner.Phase.load();
+                Owner.Readers[Phase].fetch_add(1);
+                if (Owner.Phase.load() == Phase) break;
+                Owner.Readers[Phase].fetch_sub(1);
+            }
+            Node = Owner.Current.load();
+        }
+
+        ~FReadScope()
+        {
+            Owner.Readers[Phase].fetch_sub(1, std::memory_order_release);
+        }
+
+        FReadScope(const FReadScope&) = delete;
+        FReadScope& operator=(const FReadScope&) = delete;
+
+        const T* Get() const { return Node ? Node->Value.Get() : nullptr; }
+        const T* operator->() const { return Get(); }
+        explicit operator bool() const { return Get() != nullptr; }
+
+        // Generation of the value this scope sees, for keying caches derived from it.
+        uint32 GetGeneration() const { return Node ? Node->Generation : 0; }
+
+        // Keeps the value alive beyond this scope (costs one atomic increment).
+        FValuePtr Pin() const { return Node ? Node->Value : FValuePtr(); }
+
+    private:
+        const TACESnapshot& Owner;
+        const FNode* Node = nullptr;
+        uint32 Phase = 0;
+    };
+
+    TACESnapshot() = default;
+    ~TACESnapshot() { delete Current.load(); }
+
+    TACESnapshot(const TACESnapshot&) = delete;
+    TACESnapshot& operator=(const TACESnapshot&) = delete;
+
+    bool IsSet() const { return Current.load(std::memory_order_acquire) != nullptr; }
+
+    // Incremented by every Publish(); lets callers detect that cached results are stale.
+    uint32 GetGeneration() const { return Generation.load(std::memory_order_acquire); }
+
+    // Callable from any thread. Blocks only for readers that entered before the swap.
+    void Publish(FValuePtr Value)
+    {
+        FScopeLock Lock(&WriteLock);
+        FNode* NewNode = Value.IsValid() ? new FNode{ MoveTemp(Value), Generation.load() + 1 } : nullptr;
+        FNode* OldNode = Current.exchange(NewNode);
+
+        const uint32 DrainPhase = Phase.load();
+        Phase.store(DrainPhase ^ 1);
+        while (Readers[DrainPhase].load() != 0)
+        {
+            FPlatformProcess::Yield();
+        }
+
+        Generation.fetch_add(1, std::memory_order_release);
+        delete OldNode;
+    }
+
+private:
+    std::atomic<FNode*> Current{ nullptr };
+    mutable std::atomic<uint32> Phase{ 0 };
+    mutable std::atomic<uint32> Readers[2] = {};
+    std::atomic<uint32> Generation{ 0 };
+    FCriticalSection WriteLock;
+};
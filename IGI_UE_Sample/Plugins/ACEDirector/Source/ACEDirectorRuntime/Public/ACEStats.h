@@ -0,0 +1,6 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// "stat ACE" in the console.
+DECLARE_STATS_GROUP(TEXT("ACE Director"), STATGROUP_ACE, STATCAT_Advanced);
@@ -0,0 +1,63 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "ACERetrievalIndex.h"
+
+// What a caller allows retrieval to return, in terms of entry tags (case-insensitive).
+struct FACERetrievalFilter
+{
+    // Entries carrying any of these tags are skipped, e.g. "debug" when debug commands are off.
+    TArray<FString> ExcludeTags;
+
+    // Tags present around the instigator (see UWorldSnapshot::MakeRetrievalFilter). An entry tagged
+    // "requires:<Tag>" is skipped unless <Tag> is listed here. Without a context every requirement
+    // is treated as met.
+    TArray<FString> ContextTags;
+    bool bHasContext = false;
+
+    bool IsEmpty() const { return ExcludeTags.Num() == 0 && !bHasContext; }
+};
+
+// Per-document tag bitsets. Every distinct tag of a registry gets one bit, so a filter becomes a
+// handful of AND-masks that the indices test before scoring a document.
+class ACEDIRECTORRUNTIME_API FACETagIndex
+{
+public:
+    static constexpr const TCHAR* RequirePrefix = TEXT("requires:");
+
+    FACETagIndex() = default;
+    FACETagIndex(const FACETagIndex& Other) { *this = Other; }
+    FACETagIndex& operator=(const FACETagIndex& Other);
+
+    void BeginBuild();
+    // Documents are numbered in the order they are added, matching the other indices.
+    void AddDocument(TConstArrayView<FString> Tags);
+    void FinishBuild();
+
+    // Resolves Filter against this registry's tags. Tags the registry never uses are ignored.
+    FACEDocFilter Compile(const FACERetrievalFilter& Filter) const;
+
+    // True when some entry carries a "requires:" tag, i.e. a context filter can skip anything.
+    bool HasRequirements() const { return NumRequirements > 0; }
+
+    int32 NumDocs() const { return NumIndexedDocs; }
+    int32 NumTags() const { return Dict.Num(); }
+    SIZE_T GetAllocatedSize() const;
+
+    void Write(TArray<uint8>& Out) const;
+    bool Attach(const uint8*& Cursor, const uint8* End);
+
+private:
+    void SyncViews();
+
+    FACETermDictionary Dict;   // lowercase tag -> bit
+    int32 NumIndexedDocs = 0;
+    int32 WordsPerDoc = 0;
+    int32 NumRequirements = 0;
+
+    // Build-time state, released by FinishBuild().
+    TArray<TArray<int32>> PendingDocTags;
+
+    TArray<uint64> DocBits;
+    TConstArrayView<uint64> DocBitsView;
+    bool bAttached = false;
+};
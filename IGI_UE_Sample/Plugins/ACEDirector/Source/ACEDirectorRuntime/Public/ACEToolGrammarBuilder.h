@@ -9,9 +9,47 @@ public:
     UFUNCTION(BlueprintCallable, Category = "ACE|Grammar")
     static FString JsonEscape(const FString& In);
 
+    // JsonEscape appending to Out, for building prompts without temporaries.
+    static void AppendJsonEscaped(FString& Out, FStringView In);
+
     UFUNCTION(BlueprintCallable, Category = "ACE|Grammar")
     static FString BuildPerQueryGrammar(const TArray<FString>& WorldIntents, const TArray<FString>& ConsoleNames);
 
+    // Native form, taking names that point into the registries. WorldArgSchemas, parallel to
+    // WorldIntents, holds each intent's ArgsSchemaJson: its argument keys, types, `values` enums and
+    // `required` flags are compiled into that intent's args rule. Intents without one (or with an
+    // unreadable one) accept any string-to-string args. Intent and command choices are factored into
+    // a shared-prefix trie of rules unless ace.Grammar.FactorCandidates is off.
+    static FString BuildPerQueryGrammar(TConstArrayView<FStringView> WorldIntents, TConstArrayView<FStringView> ConsoleNames,
+        TConstArrayView<FStringView> WorldArgSchemas = {});
+
+    // BuildPerQueryGrammar memoized on the candidate sets (their order does not matter). Returns the
+    // grammar text and sets OutGrammarId to a stable id for it: the same candidates always get the
+    // same id, so the structured-output client can cache the text and be sent only the id. At most
+    // ace.GrammarCache.Size grammars are kept. Touches no files.
+    static FString GetCachedGrammar(TConstArrayView<FStringView> WorldIntents, TConstArrayView<FStringView> ConsoleNames, FString& OutGrammarId,
+        TConstArrayView<FStringView> WorldArgSchemas = {});
+
+    // The same constraint as a JSON Schema, for structured-output backends that compile guided_json
+    // faster than EBNF: intents and commands as enums, each schema'd intent's args typed from its
+    // ArgsSchemaJson, everything else closed with additionalProperties false. Condensed, one line.
+    UFUNCTION(BlueprintCallable, Category = "ACE|Grammar")
+    static FString BuildPerQueryJsonSchema(const TArray<FString>& WorldIntents, const TArray<FString>& ConsoleNames);
+
+    static FString BuildPerQueryJsonSchema(TConstArrayView<FStringView> WorldIntents, TConstArrayView<FStringView> ConsoleNames,
+        TConstArrayView<FStringView> WorldArgSchemas = {});
+
+    // BuildPerQueryJsonSchema memoized in the same cache as GetCachedGrammar.
+    static FString GetCachedJsonSchema(TConstArrayView<FStringView> WorldIntents, TConstArrayView<FStringView> ConsoleNames,
+        TConstArrayView<FStringView> WorldArgSchemas = {});
+
+    // GetCachedGrammar written to disk, for callers that need a path: the same candidates always map
+    // to the same file under Saved/ACE/Grammars. The file is written outside the cache lock and deleted
+    // on eviction only if this process wrote it; files other runs left there are swept after a day.
+    static FString GetCachedGrammarFile(TConstArrayView<FStringView> WorldIntents, TConstArrayView<FStringView> ConsoleNames,
+        TConstArrayView<FStringView> WorldArgSchemas = {});
+
+    // Writes Grammar to a file named after its content, in the same bounded cache.
     UFUNCTION(BlueprintCallable, Category = "ACE|Grammar")
     static FString WriteTempGrammarFile(const FString& Grammar);
 };
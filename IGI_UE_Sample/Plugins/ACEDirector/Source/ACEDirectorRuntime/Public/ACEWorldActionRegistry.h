@@ -1,6 +1,10 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "ACERetrievalCore.h"
+#include "ACERegistryState.h"
+#include "ACERegistryStore.h"
+#include "ACERegistryWatcher.h"
 #include "ACEWorldActionRegistry.generated.h"
 
 USTRUCT(BlueprintType)
@@ -30,21 +34,102 @@ struct FWorldActionCandidate {
     UPROPERTY() FString ExamplesJson;
 };
 
+template<>
+struct TACERetrievalTraits<FWorldActionEntry>
+{
+    enum : int32 { ColdDoc, ColdArgsSchemaJson, ColdExamplesJson, NumColdFields };
+
+    static FACELexicalWeights LexicalWeights() { return { 0.6f, 0.15f, 0.1f, 1.5f }; }
+    template<typename T> static auto& GetColdField(T& E, int32 Field)
+    {
+        return Field == ColdArgsSchemaJson ? E.ArgsSchemaJson : Field == ColdExamplesJson ? E.ExamplesJson : E.Doc;
+    }
+    static const FString& GetName(const FWorldActionEntry& E) { return E.Intent; }
+    static const TArray<FString>& GetAliases(const FWorldActionEntry& E) { return E.Aliases; }
+    static const TArray<FString>& GetTags(const FWorldActionEntry& E) { return E.Tags; }
+    static void AppendDocText(const FWorldActionEntry& E, FString& Out)
+    {
+        Out += E.Intent; Out += TEXT(" ");
+        Out += FString::Join(E.Aliases, TEXT(" ")); Out += TEXT(" ");
+        Out += E.Doc; Out += TEXT(" ");
+        Out += FString::Join(E.Tags, TEXT(" ")); Out += TEXT(" ");
+        Out += E.ArgsSummary; Out += TEXT(" ");
+        Out += E.ConstraintsSummary; Out += TEXT(" ");
+        Out += E.ExamplesSummary;
+    }
+};
+
+using FWorldActionHits = TACEHitList<FWorldActionEntry>;
+
 UCLASS()
 class ACEDIRECTORRUNTIME_API UACEWorldActionRegistry : public UGameInstanceSubsystem {
     GENERATED_BODY()
 public:
+    // Starts loading on a background task; queries return nothing until IsReady().
+    // In the editor the JSON is watched and reloaded when it changes.
     virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    UFUNCTION(BlueprintPure, Category = "ACE|World")
+    bool IsReady() const { return State.IsValid() && State->Snapshot.IsSet(); }
 
+    // Safe to call from any thread.
     UFUNCTION(BlueprintCallable, Category = "ACE|World")
     void RetrieveTopK(const FString& Query, int32 K, TArray<FWorldActionCandidate>& Out) const;
 
-private:
-    TArray<FWorldActionEntry> Entries;
+    // RetrieveTopK over only the entries Filter allows; they are skipped before scoring.
+    void RetrieveTopKFiltered(const FString& Query, int32 K, const FACERetrievalFilter& Filter, TArray<FWorldActionCandidate>& Out) const;
+
+    // Native form of RetrieveTopKFiltered: hits point into the current snapshot, so the schema and
+    // examples JSON are never copied. Safe to call from any thread.
+    void RetrieveHits(const FString& Query, int32 K, const FACERetrievalFilter& Filter, FWorldActionHits& Out) const;
+
+    // RetrieveTopK for many queries against one snapshot, scored in parallel; Out gets one row per
+    // query, in order. Safe to call from any thread.
+    void RetrieveTopKBatch(TConstArrayView<FString> Queries, int32 K, TArray<TArray<FWorldActionCandidate>>& Out,
+        const FACERetrievalFilter& Filter = FACERetrievalFilter()) const;
+
+    // Type-ahead: intents whose name or alias starts with Prefix, shortest first, then near misses.
+    // PinSnapshot runs on the game thread; Suggest reads only the pinned snapshot, so it can run on
+    // any thread. Deadline is an FPlatformTime::Seconds() time after which no more candidates are
+    // gathered. Filter gates suggestions the same way it gates RetrieveHits.
+    FWorldActionHits::FDataPtr PinSnapshot() const;
+    static void Suggest(const FWorldActionHits::FDataPtr& Snapshot, FStringView Prefix, const FACERetrievalFilter& Filter, int32 K, double Deadline, FWorldActionHits& Out);
+
+    // Adds the actions in Path (world_actions.json format; relative paths are under the project
+    // directory) to retrieval until the matching RemoveActionSet, so actions that only make sense in
+    // one level or data layer do not sit in the index everywhere. Set actions replace global ones
+    // with the same intent. Adds are counted per path. The registry rebuilds on a background task and
+    // keeps serving the previous snapshot until then. Game thread only; see UACEWorldActionSetComponent.
+    UFUNCTION(BlueprintCallable, Category = "ACE|World")
+    void AddActionSet(const FString& Path);
+
+    UFUNCTION(BlueprintCallable, Category = "ACE|World")
+    void RemoveActionSet(const FString& Path);
+
+    // True when some action is tagged "requires:<Tag>", so a context filter (see
+    // UWorldSnapshot::MakeRetrievalFilter) can narrow retrieval.
+    bool UsesContextTags() const;
 
-    static TArray<FString> Tokenize(const FString& S);
-    static float CosineLike(const TArray<FString>& Q, const TArray<FString>& D);
-    static float LexicalBonus(const TArray<FString>& Q, const FWorldActionEntry& E);
-    bool LoadJSON();
     static FString JsonPath();
+    static bool ParseJSON(const FString& Raw, TArray<FWorldActionEntry>& OutEntries);
+
+private:
+    using FRegistryData = TACERegistryData<FWorldActionEntry>;
+    using FRegistryState = TACERegistryState<FWorldActionEntry>;
+    using FRegistryStore = TACERegistryStore<FWorldActionEntry>;
+
+    TSharedPtr<FRegistryState, ESPMode::ThreadSafe> State;
+    FACERegistryWatcher Watcher;
+
+    // Action sets added by streamed-in content, merged over the global registry by the loader.
+    struct FActionSets;
+    TSharedPtr<FActionSets, ESPMode::ThreadSafe> ActionSets;
+    // One per active set, so editing a set file during PIE rebuilds like world_actions.json does.
+    TMap<FString, TUniquePtr<FACERegistryWatcher>> ActionSetWatchers;
+
+    static TSharedPtr<const FRegistryData, ESPMode::ThreadSafe> Load();
+    static TSharedPtr<const FRegistryData, ESPMode::ThreadSafe> LoadWithActionSets(FActionSets& Sets);
+    static bool LoadCompiled(FRegistryData& Out, const TSharedPtr<const FACECompiledRegistry, ESPMode::ThreadSafe>& Compiled);
+    static bool LoadJSON(FRegistryData& Out, const TArray<uint8>& Bytes);
 };
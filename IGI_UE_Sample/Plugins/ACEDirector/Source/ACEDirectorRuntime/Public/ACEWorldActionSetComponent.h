@@ -0,0 +1,28 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/EngineTypes.h"
+#include "ACEWorldActionSetComponent.generated.h"
+
+// Adds a world action set to UACEWorldActionRegistry while its owner is in play. Place it on an
+// actor in a streaming level or data layer: the actions are added when that content streams in and
+// become visible, and removed again when it streams out.
+UCLASS(ClassGroup = (ACE), meta = (BlueprintSpawnableComponent))
+class ACEDIRECTORRUNTIME_API UACEWorldActionSetComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UACEWorldActionSetComponent();
+
+    // Actions in the world_actions.json format.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ACE", meta = (FilePathFilter = "json", RelativeToGameDir))
+    FFilePath ActionsJson;
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+    FString AddedPath;
+};
@@ -41,6 +41,11 @@ public:
     UFUNCTION(BlueprintCallable, Category = "ACE")
     void RouteFromText(const FString& UserDirective, AActor* Instigator);
 
+    // Runs an intent that is already decided (e.g. a type-ahead suggestion the user accepted)
+    // through the registered handlers, without retrieval or the planner.
+    UFUNCTION(BlueprintCallable, Category = "ACE|Router")
+    void RouteCommand(const FACECommand& Command, AActor* Instigator);
+
     UFUNCTION(BlueprintCallable, Category = "ACE|Router")
     void RegisterAction(const FString& IntentName, const FACEActionHandler& Handler);
 
@@ -51,8 +56,8 @@ private:
     UPROPERTY() TWeakObjectPtr<AActor> PendingInstigator;
 
     FString BuildToolChooserUserJSON(const FString& UserText,
-        const TArray<FConsoleCandidate>& ConsoleCands,
-        const TArray<FWorldActionCandidate>& WorldCands) const;
+        const FConsoleHits& ConsoleHits,
+        const FWorldActionHits& WorldHits) const;
 
     UFUNCTION()
     void HandleGPTResponse(FString Out);
@@ -1,6 +1,7 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "WorldCognition.h"
+#include "ACETagIndex.h"
 #include "WorldSnapshot.generated.h"
 
 UCLASS()
@@ -9,4 +10,8 @@ class ACEDIRECTORRUNTIME_API UWorldSnapshot : public UGameInstanceSubsystem {
 public:
 	UFUNCTION(BlueprintCallable)
 	FWorldCognition BuildSnapshot(AActor* Instigator, float Radius = 3000.f) const;
+
+	// Retrieval context from a snapshot: the tags and classes of the nearby entities, so actions
+	// tagged "requires:<Tag>" are only offered when something carrying <Tag> is around.
+	static FACERetrievalFilter MakeRetrievalFilter(const FWorldCognition& Snapshot);
 };
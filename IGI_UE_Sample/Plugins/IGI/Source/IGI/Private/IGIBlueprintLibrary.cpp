@@ -47,6 +47,37 @@ UIGIGPTEvaluateAsync* UIGIGPTEvaluateAsync::GPTEvaluateStructuredWithGrammarAsyn
     return Node;
 }
 
+UIGIGPTEvaluateAsync* UIGIGPTEvaluateAsync::GPTEvaluateStructuredWithGrammarTextAsync(const FString& UserJSON, const FString& GrammarId, const FString& GrammarText)
+{
+    if (IsRunning)
+    {
+        UE_LOG(LogIGISDK, Log, TEXT("%s: GPT is already running! Request was ignored."), ANSI_TO_TCHAR(__FUNCTION__));
+        return nullptr;
+    }
+
+    UIGIGPTEvaluateAsync* Node = NewObject<UIGIGPTEvaluateAsync>();
+    Node->UserPayload = UserJSON;
+    Node->GrammarId = GrammarId;
+    Node->GrammarText = GrammarText;
+    Node->AddToRoot();
+    return Node;
+}
+
+UIGIGPTEvaluateAsync* UIGIGPTEvaluateAsync::GPTEvaluateStructuredWithJsonSchemaAsync(const FString& UserJSON, const FString& SchemaJson)
+{
+    if (IsRunning)
+    {
+        UE_LOG(LogIGISDK, Log, TEXT("%s: GPT is already running! Request was ignored."), ANSI_TO_TCHAR(__FUNCTION__));
+        return nullptr;
+    }
+
+    UIGIGPTEvaluateAsync* Node = NewObject<UIGIGPTEvaluateAsync>();
+    Node->UserPayload = UserJSON;
+    Node->SchemaJSON = SchemaJson;
+    Node->AddToRoot();
+    return Node;
+}
+
 void UIGIGPTEvaluateAsync::Activate()
 {
     const FString TrimmedSystemPrompt = SystemPrompt.TrimStartAndEnd();
@@ -57,9 +88,9 @@ void UIGIGPTEvaluateAsync::Activate()
     {
         UE_LOG(LogIGISDK, Log, TEXT("%s: GPT called with empty user prompt!"), ANSI_TO_TCHAR(__FUNCTION__));
     }
-    if (GrammarFile.IsEmpty())
+    if (GrammarFile.IsEmpty() && GrammarText.IsEmpty() && SchemaJSON.IsEmpty())
     {
-        UE_LOG(LogIGISDK, Log, TEXT("%s: GPT called with empty grammar file!"), ANSI_TO_TCHAR(__FUNCTION__));
+        UE_LOG(LogIGISDK, Log, TEXT("%s: GPT called with empty grammar!"), ANSI_TO_TCHAR(__FUNCTION__));
     }
     else
     {
@@ -87,7 +118,16 @@ void UIGIGPTEvaluateAsync::Activate()
             }
 
             //result = GPT->Evaluate(TrimmedUserPrompt);
-            result = GPT->EvaluateStructuredWithGrammar(UserPayload, GrammarFile);
+            if (!SchemaJSON.IsEmpty())
+            {
+                result = GPT->EvaluateStructuredWithJsonSchema(UserPayload, SchemaJSON);
+            }
+            else
+            {
+                result = GrammarText.IsEmpty()
+                    ? GPT->EvaluateStructuredWithGrammar(UserPayload, GrammarFile)
+                    : GPT->EvaluateStructuredWithGrammarText(UserPayload, GrammarId, GrammarText);
+            }
 
             AsyncTask(ENamedThreads::GameThread, [this, result]()
                 {
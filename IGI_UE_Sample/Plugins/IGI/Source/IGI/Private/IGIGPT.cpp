@@ -222,7 +222,10 @@ public:
         }
     }
 
-    FString RequestSingleShotJSON(const FString& UserJsonOneLine, const FString& GrammarPath, double TimeoutSec = 30.0)
+    // JsonSchemaPath, when set, runs this request in json mode against that schema whatever
+    // IGI_NIM_MODE says.
+    FString RequestSingleShotJSON(const FString& UserJsonOneLine, const FString& GrammarPath, double TimeoutSec = 30.0,
+        const FString& JsonSchemaPath = FString())
     {
         TArray<FString> Args;
         Args.Add(TEXT("-u"));
@@ -233,7 +236,7 @@ public:
             Args.Add(TEXT("--api-key")); Args.Add(Quote(ApiKey));
         }
         Args.Add(TEXT("--model")); Args.Add(Quote(Model));
-        Args.Add(TEXT("--mode"));  Args.Add(Quote(Mode));
+        Args.Add(TEXT("--mode"));  Args.Add(Quote(JsonSchemaPath.IsEmpty() ? Mode : FString(TEXT("json"))));
         if (!SystemPromptPath.IsEmpty())
         {
             Args.Add(TEXT("--system")); Args.Add(Quote(SystemPromptPath));
@@ -242,7 +245,11 @@ public:
         {
             Args.Add(TEXT("--assistant")); Args.Add(Quote(AssistantPromptPath));
         }
-        if (Mode.Equals(TEXT("grammar"), ESearchCase::IgnoreCase))
+        if (!JsonSchemaPath.IsEmpty())
+        {
+            Args.Add(TEXT("--json-schema")); Args.Add(Quote(JsonSchemaPath));
+        }
+        else if (Mode.Equals(TEXT("grammar"), ESearchCase::IgnoreCase))
         {
             if (!GrammarPath.IsEmpty())
             {
@@ -384,6 +391,7 @@ public:
         }
 
         bSawPong.store(false, std::memory_order_relaxed);
+        SentGrammarIds.Empty();
         OutputBuffer.Empty();
         {
             FString Dummy;
@@ -516,6 +524,7 @@ public:
             Interactive->Cancel(/*KillTree*/ true);
             Interactive.Reset();
         }
+        SentGrammarIds.Empty();
 
         OutputBuffer.Empty();
         FString Dummy;
@@ -553,6 +562,67 @@ public:
         return TEXT("{\"error\":\"timeout\"}");
     }
 
+    // Sends Request with grammar GrammarId. The text goes along only the first time this process
+    // sees the id; after that the script serves it from its own cache. If the script has evicted it
+    // meanwhile it answers unknown_grammar_id, and the request is repeated with the text.
+    FString RequestJSONWithGrammar(const TSharedRef<FJsonObject>& Request, const FString& GrammarId, const FString& GrammarText, double TimeoutSec)
+    {
+        FScopeLock Lock(&Mutex);
+
+        Request->SetStringField(TEXT("grammar_id"), GrammarId);
+        bool bSendText = !SentGrammarIds.Contains(GrammarId);
+        for (int32 Attempt = 0; Attempt < 2; ++Attempt)
+        {
+            if (bSendText)
+            {
+                Request->SetStringField(TEXT("grammar"), GrammarText);
+            }
+            else
+            {
+                Request->RemoveField(TEXT("grammar"));
+            }
+
+            const FString Resp = RequestJSON(ToOneLine(Request), TimeoutSec);
+            if (!bSendText && Resp.Contains(TEXT("\"unknown_grammar_id\"")))
+            {
+                UE_LOG(LogIGISDK, Verbose, TEXT("[persist] grammar %s evicted by script; resending"), *GrammarId);
+                SentGrammarIds.Remove(GrammarId);
+                bSendText = true;
+                continue;
+            }
+
+            if (bSendText && !Resp.StartsWith(TEXT("{\"error\"")))
+            {
+                // Bounded by the script's cache; past that it will ask again anyway.
+                if (SentGrammarIds.Num() >= MaxSentGrammarIds)
+                {
+                    SentGrammarIds.Empty();
+                }
+                SentGrammarIds.Add(GrammarId);
+            }
+            return Resp;
+        }
+        return TEXT("{\"error\":\"unknown_grammar_id\"}");
+    }
+
+    // Sends Request with Schema inline as its json_schema. The schema is written out with the
+    // request, so it stays on the request's one line however the caller formatted it.
+    FString RequestJSONWithSchema(const TSharedRef<FJsonObject>& Request, const TSharedRef<FJsonObject>& Schema, double TimeoutSec)
+    {
+        Request->SetObjectField(TEXT("json_schema"), Schema);
+        return RequestJSON(ToOneLine(Request), TimeoutSec);
+    }
+
+    static FString ToOneLine(const TSharedRef<FJsonObject>& Obj)
+    {
+        FString OneLine;
+        const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OneLine);
+        FJsonSerializer::Serialize(Obj, Writer);
+        OneLine.ReplaceInline(TEXT("\r"), TEXT(""));
+        OneLine.ReplaceInline(TEXT("\n"), TEXT(""));
+        return OneLine;
+    }
+
 private:
     void SendLine(const FString& Line)
     {
@@ -598,6 +668,10 @@ private:
     std::atomic<bool> bSawPong{ false };
     mutable FCriticalSection Mutex;
 
+    // Grammar ids whose text the running script has been sent. Cleared whenever it is (re)started.
+    static constexpr int32 MaxSentGrammarIds = 1024;
+    TSet<FString> SentGrammarIds;
+
     FString BaseUrl, ApiKey, Model, Mode;
     FString ScriptPath, SystemPromptPath, GrammarPath, JsonSchemaPath, PythonExe;
 
@@ -844,6 +918,93 @@ public:
         return PythonClient->RequestSingleShotJSON(OneLine, GrammarPath, /*TimeoutSec=*/60.0);
     }
 
+    FString EvaluateStructuredWithGrammarText(const FString& UserPrompt, const FString& GrammarId, const FString& GrammarText)
+    {
+        TSharedPtr<FJsonObject> Obj;
+        const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(UserPrompt);
+        if (!FJsonSerializer::Deserialize(Reader, Obj) || !Obj.IsValid())
+        {
+            return TEXT("{\"error\":\"bad_user_json\"}");
+        }
+
+        if (PythonPersistent.IsValid() && PythonPersistent->IsRunning())
+        {
+            FString Resp = PythonPersistent->RequestJSONWithGrammar(Obj.ToSharedRef(), GrammarId, GrammarText, 60.0);
+            if (!Resp.IsEmpty() && !Resp.StartsWith(TEXT("{\"error\"")))
+            {
+                return Resp;
+            }
+            UE_LOG(LogIGISDK, Warning, TEXT("[gpt] persistent failed, falling back: %s"), *Resp);
+        }
+
+        // The single-shot script only takes a grammar file. This is the slow path already (a process
+        // launch per request), so the temporary file costs nothing that matters.
+        const FString GrammarPath = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("igi_grammar_"), TEXT(".ebnf"));
+        if (!FFileHelper::SaveStringToFile(GrammarText, *GrammarPath))
+        {
+            return TEXT("{\"error\":\"grammar_write_failed\"}");
+        }
+
+        if (!PythonClient.IsValid())
+        {
+            PythonClient = MakeUnique<FPythonMonitoredSingleShot>();
+            PythonClient->ConfigureFromEnv();
+        }
+
+        Obj->RemoveField(TEXT("grammar_id"));
+        Obj->RemoveField(TEXT("grammar"));
+        const FString Resp = PythonClient->RequestSingleShotJSON(FPythonPersistentClient::ToOneLine(Obj.ToSharedRef()), GrammarPath, /*TimeoutSec=*/60.0);
+        IFileManager::Get().Delete(*GrammarPath, false, false, true);
+        return Resp;
+    }
+
+    FString EvaluateStructuredWithJsonSchema(const FString& UserPrompt, const FString& SchemaJson)
+    {
+        TSharedPtr<FJsonObject> Obj;
+        const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(UserPrompt);
+        if (!FJsonSerializer::Deserialize(Reader, Obj) || !Obj.IsValid())
+        {
+            return TEXT("{\"error\":\"bad_user_json\"}");
+        }
+
+        // Requests to the persistent client are newline-delimited; a schema is never passed through
+        // as the caller's text, which may span lines or not be JSON at all.
+        TSharedPtr<FJsonObject> Schema;
+        const TSharedRef<TJsonReader<>> SchemaReader = TJsonReaderFactory<>::Create(SchemaJson);
+        if (!FJsonSerializer::Deserialize(SchemaReader, Schema) || !Schema.IsValid())
+        {
+            return TEXT("{\"error\":\"bad_json_schema\"}");
+        }
+
+        if (PythonPersistent.IsValid() && PythonPersistent->IsRunning())
+        {
+            FString Resp = PythonPersistent->RequestJSONWithSchema(Obj.ToSharedRef(), Schema.ToSharedRef(), 60.0);
+            if (!Resp.IsEmpty() && !Resp.StartsWith(TEXT("{\"error\"")))
+            {
+                return Resp;
+            }
+            UE_LOG(LogIGISDK, Warning, TEXT("[gpt] persistent failed, falling back: %s"), *Resp);
+        }
+
+        // As with grammar text, the single-shot script only takes a schema file.
+        Obj->RemoveField(TEXT("json_schema"));
+        const FString SchemaPath = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("igi_schema_"), TEXT(".json"));
+        if (!FFileHelper::SaveStringToFile(FPythonPersistentClient::ToOneLine(Schema.ToSharedRef()), *SchemaPath))
+        {
+            return TEXT("{\"error\":\"schema_write_failed\"}");
+        }
+
+        if (!PythonClient.IsValid())
+        {
+            PythonClient = MakeUnique<FPythonMonitoredSingleShot>();
+            PythonClient->ConfigureFromEnv();
+        }
+
+        const FString Resp = PythonClient->RequestSingleShotJSON(FPythonPersistentClient::ToOneLine(Obj.ToSharedRef()), FString(), /*TimeoutSec=*/60.0, SchemaPath);
+        IFileManager::Get().Delete(*SchemaPath, false, false, true);
+        return Resp;
+    }
+
 private:
     // Non-owning ptr
     FIGIModule* IGIModulePtr;
@@ -873,4 +1034,14 @@ FString FIGIGPT::Evaluate(const FString& UserPrompt)
 FString FIGIGPT::EvaluateStructuredWithGrammar(const FString& UserPrompt, const FString& GrammarPath)
 {
     return Pimpl->EvaluateStructuredWithGrammar(UserPrompt, GrammarPath);
+}
+
+FString FIGIGPT::EvaluateStructuredWithGrammarText(const FString& UserPrompt, const FString& GrammarId, const FString& GrammarText)
+{
+    return Pimpl->EvaluateStructuredWithGrammarText(UserPrompt, GrammarId, GrammarText);
+}
+
+FString FIGIGPT::EvaluateStructuredWithJsonSchema(const FString& UserPrompt, const FString& SchemaJson)
+{
+    return Pimpl->EvaluateStructuredWithJsonSchema(UserPrompt, SchemaJson);
 }
\ No newline at end of file
@@ -26,6 +26,14 @@ public:
     UFUNCTION(BlueprintCallable, Category = "IGI|GPT", meta = (DisplayName = "Send text to GPT (Structured + Grammar)", BlueprintInternalUseOnly = "true"))
     static UIGIGPTEvaluateAsync* GPTEvaluateStructuredWithGrammarAsync(const FString& UserJSON, const FString& GrammarPath);
 
+    // Grammar passed in memory rather than as a file; see FIGIGPT::EvaluateStructuredWithGrammarText.
+    UFUNCTION(BlueprintCallable, Category = "IGI|GPT", meta = (DisplayName = "Send text to GPT (Structured + Grammar Text)", BlueprintInternalUseOnly = "true"))
+    static UIGIGPTEvaluateAsync* GPTEvaluateStructuredWithGrammarTextAsync(const FString& UserJSON, const FString& GrammarId, const FString& GrammarText);
+
+    // Constrained by a JSON Schema sent inline; see FIGIGPT::EvaluateStructuredWithJsonSchema.
+    UFUNCTION(BlueprintCallable, Category = "IGI|GPT", meta = (DisplayName = "Send text to GPT (Structured + JSON Schema)", BlueprintInternalUseOnly = "true"))
+    static UIGIGPTEvaluateAsync* GPTEvaluateStructuredWithJsonSchemaAsync(const FString& UserJSON, const FString& SchemaJson);
+
     void Start() { Activate(); }
 
     UPROPERTY(BlueprintAssignable)
@@ -45,6 +53,8 @@ public:
 
     UPROPERTY() FString UserPayload;
     UPROPERTY() FString GrammarFile;
+    UPROPERTY() FString GrammarId;
+    UPROPERTY() FString GrammarText;
 
 protected:
     virtual void Activate() override;
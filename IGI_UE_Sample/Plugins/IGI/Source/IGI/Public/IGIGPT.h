@@ -22,6 +22,16 @@ public:
 
     FString EvaluateStructuredWithGrammar(const FString& UserPrompt, const FString& GrammarPath);
 
+    // Same, with the grammar passed in memory. GrammarId names GrammarText (one id, one text): the
+    // persistent Python process is sent the text with the first request for an id and caches it,
+    // later requests carry only the id. No files are written unless the single-shot fallback runs.
+    FString EvaluateStructuredWithGrammarText(const FString& UserPrompt, const FString& GrammarId, const FString& GrammarText);
+
+    // Constrained by a JSON Schema (guided_json) instead of a grammar, sent inline with every request
+    // whatever IGI_NIM_MODE the Python process was started with. SchemaJson may be formatted any
+    // way but must be a JSON object; otherwise the result is {"error":"bad_json_schema"}.
+    FString EvaluateStructuredWithJsonSchema(const FString& UserPrompt, const FString& SchemaJson);
+
 private:
     class Impl;
     TPimplPtr<class Impl> Pimpl;